@@ -1,8 +1,12 @@
 #include "core/atlas_core.h"
 #include "io/json_parser.h"
 
-#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <utility>
 
@@ -19,9 +23,54 @@ RegionAtlas build_builtin() {
     }
 }
 
-RegionAtlas& current_atlas_storage() {
-    static RegionAtlas atlas = build_builtin();
-    return atlas;
+class AtlasPublisher {
+public:
+    AtlasPublisher() { publish(RegionAtlas::builtin()); }
+
+    // Only called when a reader's pinned snapshot is stale, i.e. at most once
+    // per thread per publish. Readers never take mutex_; it only serializes
+    // publishers.
+    std::shared_ptr<const AtlasSnapshot> current() const { return std::atomic_load(&current_); }
+
+    // Version of the current snapshot; lets readers skip current() while
+    // their pinned snapshot is still current.
+    std::uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
+    void publish(RegionAtlas atlas) {
+        auto snapshot = std::make_shared<AtlasSnapshot>(AtlasSnapshot{std::move(atlas), 0});
+        std::shared_ptr<const AtlasSnapshot> replaced;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const std::uint64_t version = next_version_++;
+            snapshot->version = version;
+            // The snapshot is stored before its version, so a reader that sees
+            // the new version also loads the new snapshot.
+            replaced = std::atomic_exchange(&current_, std::shared_ptr<const AtlasSnapshot>(std::move(snapshot)));
+            version_.store(version, std::memory_order_release);
+        }
+        // `replaced` is released here, outside the lock.
+    }
+
+private:
+    std::mutex mutex_;
+    std::shared_ptr<const AtlasSnapshot> current_;  // accessed only through std::atomic_* functions
+    std::atomic<std::uint64_t> version_{0};
+    std::uint64_t next_version_ = 1;
+};
+
+AtlasPublisher& publisher() {
+    static AtlasPublisher instance;
+    return instance;
+}
+
+// The snapshot this thread last read, refreshed once a newer one is published.
+// Refreshing drops this thread's reference to the old snapshot, which is why
+// references from current_atlas() must not be held across further atlas reads.
+const std::shared_ptr<const AtlasSnapshot>& pinned_snapshot() {
+    thread_local std::shared_ptr<const AtlasSnapshot> pin;
+    const AtlasPublisher& p = publisher();
+    if (!pin || pin->version != p.version()) pin = p.current();
+    return pin;
 }
 
 }
@@ -31,64 +80,117 @@ const RegionAtlas& RegionAtlas::builtin() {
     return atlas;
 }
 
+template <typename Def>
+std::size_t AtlasIdIndex::find(const std::vector<Def>& defs, std::string_view id) const {
+    if (slots_.empty()) return npos;
+    const std::size_t mask = slots_.size() - 1;
+    for (std::size_t h = std::hash<std::string_view>{}(id) & mask;; h = (h + 1) & mask) {
+        std::uint32_t slot = slots_[h];
+        if (slot == 0) return npos;
+        if (defs[slot - 1].id == id) return slot - 1;
+    }
+}
+
+template <typename Def>
+void AtlasIdIndex::insert(const std::vector<Def>& defs, std::size_t pos) {
+    // Keep the load factor at or below 1/2 so probe chains stay short.
+    if ((count_ + 1) * 2 > slots_.size()) {
+        rebuild(defs);
+        return;
+    }
+    const std::size_t mask = slots_.size() - 1;
+    std::size_t h = std::hash<std::string_view>{}(defs[pos].id) & mask;
+    while (slots_[h] != 0) h = (h + 1) & mask;
+    slots_[h] = static_cast<std::uint32_t>(pos + 1);
+    ++count_;
+}
+
+template <typename Def>
+void AtlasIdIndex::rebuild(const std::vector<Def>& defs) {
+    std::size_t capacity = 8;
+    while (capacity < defs.size() * 2) capacity *= 2;
+    slots_.assign(capacity, 0);
+    count_ = 0;
+    const std::size_t mask = capacity - 1;
+    for (std::size_t pos = 0; pos < defs.size(); ++pos) {
+        std::size_t h = std::hash<std::string_view>{}(defs[pos].id) & mask;
+        while (slots_[h] != 0) h = (h + 1) & mask;
+        slots_[h] = static_cast<std::uint32_t>(pos + 1);
+        ++count_;
+    }
+}
+
+namespace {
+
+// Shared add/replace/remove logic for the three definition vectors.
+template <typename Def>
+const Def* find_in(const std::vector<Def>& defs, const AtlasIdIndex& index, std::string_view id) {
+    std::size_t pos = index.find(defs, id);
+    return pos == AtlasIdIndex::npos ? nullptr : &defs[pos];
+}
+
+template <typename Def>
+void add_or_replace_in(std::vector<Def>& defs, AtlasIdIndex& index, Def def) {
+    std::size_t pos = index.find(defs, def.id);
+    if (pos != AtlasIdIndex::npos) {
+        defs[pos] = std::move(def);
+        return;
+    }
+    defs.push_back(std::move(def));
+    index.insert(defs, defs.size() - 1);
+}
+
+template <typename Def>
+bool remove_from(std::vector<Def>& defs, AtlasIdIndex& index, std::string_view id) {
+    std::size_t pos = index.find(defs, id);
+    if (pos == AtlasIdIndex::npos) return false;
+    // Erasing shifts every later position; removal is rare, so just reindex.
+    defs.erase(defs.begin() + static_cast<std::ptrdiff_t>(pos));
+    index.rebuild(defs);
+    return true;
+}
+
+}
+
 const RegionDefinition* RegionAtlas::find(std::string_view id) const {
-    for (const auto& r : regions_) if (r.id == id) return &r;
-    return nullptr;
+    return find_in(regions_, region_index_, id);
+}
+
+RegionId RegionAtlas::id_of(std::string_view id) const {
+    std::size_t pos = region_index_.find(regions_, id);
+    return pos == AtlasIdIndex::npos ? kNoRegion : static_cast<RegionId>(pos);
 }
 
 void RegionAtlas::add_or_replace(RegionDefinition def) {
-    for (auto& r : regions_) {
-        if (r.id == def.id) { r = std::move(def); return; }
-    }
-    regions_.push_back(std::move(def));
+    add_or_replace_in(regions_, region_index_, std::move(def));
 }
 
 bool RegionAtlas::remove(std::string_view id) {
-    auto it = std::find_if(regions_.begin(), regions_.end(),
-                           [&](const RegionDefinition& r){ return r.id == id; });
-    if (it == regions_.end()) return false;
-    regions_.erase(it);
-    return true;
+    return remove_from(regions_, region_index_, id);
 }
 
 const PathwayDefinition* RegionAtlas::find_pathway(std::string_view id) const {
-    for (const auto& p : pathways_) if (p.id == id) return &p;
-    return nullptr;
+    return find_in(pathways_, pathway_index_, id);
 }
 
 void RegionAtlas::add_or_replace_pathway(PathwayDefinition def) {
-    for (auto& p : pathways_) {
-        if (p.id == def.id) { p = std::move(def); return; }
-    }
-    pathways_.push_back(std::move(def));
+    add_or_replace_in(pathways_, pathway_index_, std::move(def));
 }
 
 bool RegionAtlas::remove_pathway(std::string_view id) {
-    auto it = std::find_if(pathways_.begin(), pathways_.end(),
-                           [&](const PathwayDefinition& p){ return p.id == id; });
-    if (it == pathways_.end()) return false;
-    pathways_.erase(it);
-    return true;
+    return remove_from(pathways_, pathway_index_, id);
 }
 
 const TemplateDefinition* RegionAtlas::find_template(std::string_view id) const {
-    for (const auto& t : templates_) if (t.id == id) return &t;
-    return nullptr;
+    return find_in(templates_, template_index_, id);
 }
 
 void RegionAtlas::add_or_replace_template(TemplateDefinition def) {
-    for (auto& t : templates_) {
-        if (t.id == def.id) { t = std::move(def); return; }
-    }
-    templates_.push_back(std::move(def));
+    add_or_replace_in(templates_, template_index_, std::move(def));
 }
 
 bool RegionAtlas::remove_template(std::string_view id) {
-    auto it = std::find_if(templates_.begin(), templates_.end(),
-                           [&](const TemplateDefinition& t){ return t.id == id; });
-    if (it == templates_.end()) return false;
-    templates_.erase(it);
-    return true;
+    return remove_from(templates_, template_index_, id);
 }
 
 RegionAtlas RegionAtlas::from_json(std::string_view text) {
@@ -99,16 +201,20 @@ RegionAtlas RegionAtlas::from_file(const std::string& path) {
     return load_json_atlas_file(path);
 }
 
-const RegionAtlas& current_atlas() {
-    return current_atlas_storage();
+const AtlasSnapshot& current_atlas_snapshot() {
+    return *pinned_snapshot();
+}
+
+std::shared_ptr<const AtlasSnapshot> acquire_atlas_snapshot() {
+    return pinned_snapshot();
 }
 
 void set_current_atlas(RegionAtlas atlas) {
-    current_atlas_storage() = std::move(atlas);
+    publisher().publish(std::move(atlas));
 }
 
 void reset_current_atlas_to_builtin() {
-    current_atlas_storage() = RegionAtlas::builtin();
+    publisher().publish(RegionAtlas::builtin());
 }
 
 }
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstdint>
 #include <iosfwd>
 #include <map>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -9,6 +11,11 @@
 
 namespace cerebra {
 
+// Compact handle for a region: its index in the RegionAtlas that resolved it.
+// Regions the atlas does not know carry kNoRegion and are matched by key.
+using RegionId = std::uint32_t;
+inline constexpr RegionId kNoRegion = static_cast<RegionId>(-1);
+
 // A baseline (intensity=1.0) neurotransmitter rate associated with a region.
 struct AtlasFlow {
     std::string transmitter;
@@ -67,7 +74,29 @@ public:
     using std::runtime_error::runtime_error;
 };
 
-// A pluggable collection of region definitions.
+// Open-addressed id -> position table over one of the atlas' definition
+// vectors. Slots store position + 1 (0 marks an empty slot), so a lookup
+// hashes the probe id and compares it against the stored definition without
+// allocating, and copying the atlas copies the index as-is.
+class AtlasIdIndex {
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    template <typename Def>
+    std::size_t find(const std::vector<Def>& defs, std::string_view id) const;
+    // Index defs[pos], which must be a newly appended definition.
+    template <typename Def>
+    void insert(const std::vector<Def>& defs, std::size_t pos);
+    template <typename Def>
+    void rebuild(const std::vector<Def>& defs);
+
+private:
+    std::vector<std::uint32_t> slots_;
+    std::size_t count_ = 0;
+};
+
+// A pluggable collection of region definitions. Regions, pathways and
+// templates are each hash-indexed by id.
 class RegionAtlas {
 public:
     static const RegionAtlas& builtin();
@@ -77,6 +106,10 @@ public:
 
     const std::vector<RegionDefinition>& regions() const { return regions_; }
     const RegionDefinition* find(std::string_view id) const;
+    RegionId id_of(std::string_view id) const;
+    const RegionDefinition* at(RegionId id) const {
+        return id < regions_.size() ? &regions_[id] : nullptr;
+    }
 
     void add_or_replace(RegionDefinition def);
     bool remove(std::string_view id);
@@ -98,9 +131,35 @@ private:
     std::vector<RegionDefinition> regions_;
     std::vector<PathwayDefinition> pathways_;
     std::vector<TemplateDefinition> templates_;
+    AtlasIdIndex region_index_;
+    AtlasIdIndex pathway_index_;
+    AtlasIdIndex template_index_;
+};
+
+// The process-wide atlas is published RCU-style: each set_current_atlas()
+// freezes its argument into a new immutable, reference-counted snapshot and
+// swaps it in atomically. A snapshot is freed once it is neither current nor
+// held by anyone.
+//
+// Each thread caches the snapshot it last read and only reloads the shared
+// pointer after a newer one was published, so the common read is one atomic
+// load. Readers never lock; a mutex only serializes publishers. The cache is the only thing keeping a snapshot
+// alive for current_atlas(): the reference it returns is good until the same
+// thread reads the atlas again, including from inside any function it calls.
+// Anything that reads atlas data across other calls (renderers walking the
+// region list, stores resolving ids, samples, flow views) holds
+// acquire_atlas_snapshot() for the whole operation instead.
+struct AtlasSnapshot {
+    RegionAtlas atlas;
+    // Increases with every publish; caches keyed on atlas contents compare it
+    // to tell whether they are stale.
+    std::uint64_t version = 0;
 };
 
-const RegionAtlas& current_atlas();
+const AtlasSnapshot& current_atlas_snapshot();
+std::shared_ptr<const AtlasSnapshot> acquire_atlas_snapshot();
+inline const RegionAtlas& current_atlas() { return current_atlas_snapshot().atlas; }
+inline std::uint64_t current_atlas_version() { return current_atlas_snapshot().version; }
 void set_current_atlas(RegionAtlas atlas);
 void reset_current_atlas_to_builtin();
 
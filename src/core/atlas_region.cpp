@@ -2,6 +2,7 @@
 
 #include "core/atlas_core.h"
 #include <algorithm>
+#include <cmath>
 
 namespace cerebra {
 
@@ -13,22 +14,83 @@ const cerebra::RegionDefinition* find_region(std::string_view id) {
     return current_atlas().find(id);
 }
 
-std::vector<NeurotransmitterFlow> default_flows_for(std::string_view region,
-                                                    double intensity) {
+RegionId region_id_for(std::string_view id) {
+    return current_atlas().id_of(id);
+}
+
+const RegionDetail& RegionState::detail() const {
+    static const RegionDetail empty;
+    return extra ? *extra.get() : empty;
+}
+
+namespace {
+
+// Unknown region: a single low-level glutamatergic fallback so display code
+// never has to special-case an empty flow list.
+const std::vector<AtlasFlow>& fallback_flows() {
+    static const std::vector<AtlasFlow> flows = {{"glutamate", 0.5}};
+    return flows;
+}
+
+}
+
+std::vector<NeurotransmitterFlow> FlowView::to_vector() const {
     std::vector<NeurotransmitterFlow> out;
-    if (const cerebra::RegionDefinition* def = current_atlas().find(region)) {
-        out.reserve(def->flows.size());
-        for (const auto& f : def->flows) {
-            out.push_back({f.transmitter, f.base_rate * intensity});
-        }
-        return out;
-    }
-    // Unknown region: a single low-level glutamatergic fallback so display code
-    // never has to special-case an empty flow list.
-    out.push_back({"glutamate", 0.5 * intensity});
+    out.reserve(size_);
+    for (Flow f : *this) out.push_back({std::string(f.type), f.rate});
     return out;
 }
 
+FlowView default_flow_view(const RegionDefinition* def, double intensity,
+                           std::shared_ptr<const AtlasSnapshot> owner) {
+    if (!def) return FlowView(fallback_flows(), intensity);
+    return FlowView(def->flows, intensity, std::move(owner));
+}
+
+std::vector<NeurotransmitterFlow> default_flows_for(std::string_view region,
+                                                    double intensity) {
+    return default_flow_view(current_atlas().find(region), intensity).to_vector();
+}
+
+std::vector<NeurotransmitterFlow> default_flows_for(RegionId id, double intensity) {
+    return default_flow_view(current_atlas().at(id), intensity).to_vector();
+}
+
+namespace {
+
+FlowView atlas_flow_view(const RegionState& rs, const AtlasSnapshot& atlas,
+                         std::shared_ptr<const AtlasSnapshot> owner) {
+    const RegionDefinition* def = atlas.atlas.at(rs.region_id);
+    if (!def || def->id != rs.region) def = atlas.atlas.find(rs.region);
+    const double scale = std::isnan(rs.flow_intensity) ? rs.intensity : rs.flow_intensity;
+    return default_flow_view(def, scale, std::move(owner));
+}
+
+}
+
+FlowView RegionState::effective_flows() const {
+    if (!flows.empty()) return FlowView(flows);
+    if (!atlas_flows) return FlowView();
+    std::shared_ptr<const AtlasSnapshot> snapshot = acquire_atlas_snapshot();
+    const AtlasSnapshot& atlas = *snapshot;
+    return atlas_flow_view(*this, atlas, std::move(snapshot));
+}
+
+FlowView RegionState::effective_flows(const AtlasSnapshot& atlas) const {
+    if (!flows.empty()) return FlowView(flows);
+    if (!atlas_flows) return FlowView();
+    return atlas_flow_view(*this, atlas, nullptr);
+}
+
+RegionState make_region_state(std::string region, double intensity) {
+    RegionState rs;
+    rs.region_id = current_atlas().id_of(region);
+    rs.region = std::move(region);
+    rs.intensity = intensity;
+    rs.use_atlas_flows();
+    return rs;
+}
+
 const std::vector<RegionInfo>& RegionCatalog::all() {
     return current_atlas().regions();
 }
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "core/atlas_core.h"
+#include "core/region_tree.h"
 
+#include <limits>
 #include <map>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -18,6 +21,56 @@ struct NeurotransmitterFlow {
     double rate = 0.0;
 };
 
+// A read-only sequence of flows that never allocates: either flows stored on
+// a RegionState, or an atlas AtlasFlow table scaled by the region's intensity
+// as each element is read. A view over an atlas table holds the snapshot the
+// table belongs to.
+class FlowView {
+public:
+    struct Flow {
+        std::string_view type;
+        double rate = 0.0;
+    };
+
+    class iterator {
+    public:
+        iterator(const FlowView* view, std::size_t i) : view_(view), i_(i) {}
+        Flow operator*() const { return (*view_)[i_]; }
+        iterator& operator++() { ++i_; return *this; }
+        bool operator!=(const iterator& other) const { return i_ != other.i_; }
+        bool operator==(const iterator& other) const { return i_ == other.i_; }
+
+    private:
+        const FlowView* view_;
+        std::size_t i_;
+    };
+
+    FlowView() = default;
+    explicit FlowView(const std::vector<NeurotransmitterFlow>& stored)
+        : stored_(stored.data()), size_(stored.size()) {}
+    FlowView(const std::vector<AtlasFlow>& table, double intensity,
+             std::shared_ptr<const AtlasSnapshot> owner = nullptr)
+        : owner_(std::move(owner)), table_(table.data()), size_(table.size()), scale_(intensity) {}
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    Flow operator[](std::size_t i) const {
+        if (stored_) return {stored_[i].type, stored_[i].rate};
+        return {table_[i].transmitter, table_[i].base_rate * scale_};
+    }
+    iterator begin() const { return {this, 0}; }
+    iterator end() const { return {this, size_}; }
+
+    std::vector<NeurotransmitterFlow> to_vector() const;
+
+private:
+    std::shared_ptr<const AtlasSnapshot> owner_;
+    const NeurotransmitterFlow* stored_ = nullptr;
+    const AtlasFlow* table_ = nullptr;
+    std::size_t size_ = 0;
+    double scale_ = 0.0;
+};
+
 // Backwards-compatible alias for code that referred to the old RegionInfo
 // struct (with slice_*/display_name/id). The atlas-driven RegionDefinition
 // is a strict superset.
@@ -25,10 +78,17 @@ using RegionInfo = RegionDefinition;
 
 // Convenience accessors that delegate to the *current* atlas. They keep the
 // pre-atlas call sites working while still routing through one source of
-// truth for region geometry and flows.
+// truth for region geometry and flows. References they return follow the
+// current_atlas() rules: hold acquire_atlas_snapshot() to keep them longer.
 const std::vector<RegionDefinition>& known_regions();
 const RegionDefinition* find_region(std::string_view id);
+RegionId region_id_for(std::string_view id);
 std::vector<NeurotransmitterFlow> default_flows_for(std::string_view region, double intensity);
+std::vector<NeurotransmitterFlow> default_flows_for(RegionId id, double intensity);
+// The atlas-derived flows for a region at `intensity`, without copying them.
+// `owner` is the snapshot `def` belongs to, kept alive by the view.
+FlowView default_flow_view(const RegionDefinition* def, double intensity,
+                           std::shared_ptr<const AtlasSnapshot> owner = nullptr);
 
 class RegionCatalog {
 public:
@@ -39,11 +99,10 @@ public:
     static void load_from_file(const std::string& path);
 };
 
-// Per-frame snapshot of a single region.
-struct RegionState {
-    std::string region;
-    double intensity = 0.0;
-    std::vector<NeurotransmitterFlow> flows;
+// Per-region data that only some sources and stages fill in. It lives out of
+// line (see RegionState::detail) so frames that carry nothing but intensities
+// pay one pointer per region for it.
+struct RegionDetail {
     // Arbitrary named statistics carried alongside intensity. Atlases and
     // upstream data sources can populate this freely; the display surface
     // renders whatever is present.
@@ -51,8 +110,8 @@ struct RegionState {
 
     // Advanced Modeling
     std::map<std::string, double> neurotransmitters;
-    double plasticity_factor = 1.0;
-    std::vector<RegionState> subregions;
+    // Nested parcellation below this region, flattened in pre-order.
+    RegionTree subregions;
 
     std::vector<double> intensity_history;
     std::vector<double> synaptic_buffer;
@@ -63,4 +122,74 @@ struct RegionState {
     double z = 0.0;
 };
 
+// Owning pointer with value semantics: copying deep-copies the pointee.
+template <typename T>
+class ClonePtr {
+public:
+    ClonePtr() = default;
+    ClonePtr(const ClonePtr& other) : p_(other.p_ ? std::make_unique<T>(*other.p_) : nullptr) {}
+    ClonePtr(ClonePtr&&) noexcept = default;
+    ClonePtr& operator=(const ClonePtr& other) {
+        if (this != &other) p_ = other.p_ ? std::make_unique<T>(*other.p_) : nullptr;
+        return *this;
+    }
+    ClonePtr& operator=(ClonePtr&&) noexcept = default;
+
+    T* get() const { return p_.get(); }
+    explicit operator bool() const { return p_ != nullptr; }
+    T& emplace() {
+        if (!p_) p_ = std::make_unique<T>();
+        return *p_;
+    }
+    void reset() { p_.reset(); }
+
+private:
+    std::unique_ptr<T> p_;
+};
+
+// Per-frame snapshot of a single region. Only the fields every stage touches
+// are stored inline; the rest sit in a RegionDetail allocated on first write.
+struct RegionState {
+    std::string region;
+    double intensity = 0.0;
+    // Index of `region` in the atlas it was resolved against; kNoRegion when
+    // the region is not part of the atlas (lookups then fall back to `region`).
+    RegionId region_id = kNoRegion;
+    // Whether the region carries the atlas default flows. Sources that read
+    // activity set it and leave `flows` empty; the defaults are then derived
+    // on demand by effective_flows(). A region built without it has no flows.
+    bool atlas_flows = false;
+    // The intensity the atlas default flows are scaled by: the reading as the
+    // source reported it, so stages that later rewrite `intensity` do not
+    // change the flows (as when sources stored them outright). NaN means "use
+    // `intensity`", for states built by hand.
+    double flow_intensity = std::numeric_limits<double>::quiet_NaN();
+    // Flows set explicitly by a source or stage; these win over the defaults.
+    std::vector<NeurotransmitterFlow> flows;
+    double plasticity_factor = 1.0;
+    ClonePtr<RegionDetail> extra;
+
+    bool has_detail() const { return static_cast<bool>(extra); }
+    // Read access never allocates; a region without detail reads as empty.
+    const RegionDetail& detail() const;
+    RegionDetail& mutable_detail() { return extra.emplace(); }
+
+    // `flows` when set, otherwise the atlas defaults scaled by
+    // `flow_intensity` if `atlas_flows`, otherwise nothing.
+    FlowView effective_flows() const;
+    // The same against a snapshot the caller holds for as long as it uses the
+    // view; saves taking a reference per region in per-frame loops.
+    FlowView effective_flows(const AtlasSnapshot& atlas) const;
+    // Mark the state as carrying the atlas default flows at its current
+    // intensity; sources call this as they read a region.
+    void use_atlas_flows() {
+        atlas_flows = true;
+        flow_intensity = intensity;
+    }
+};
+
+// A RegionState bound to the current atlas: its RegionId is resolved once here.
+// It carries the atlas default flows at `intensity`, left to effective_flows().
+RegionState make_region_state(std::string region, double intensity);
+
 }
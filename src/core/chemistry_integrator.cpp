@@ -0,0 +1,185 @@
+#include "core/chemistry_integrator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cerebra {
+
+namespace {
+
+// A per-step fraction of 1 would be an infinite rate.
+constexpr double kMaxFraction = 1.0 - 1e-9;
+
+// A mode settles to 1e-12 in ln(1e12) ~ 27.6 time constants; a level may
+// have to settle on both sides of its release target in one interval.
+constexpr double kSettleTimeConstants = 56.0;
+
+// Largest h * k per sub-step: RK4 at 0.25 keeps the local error below 1e-6
+// of the gap; Dormand-Prince's real stability bound is about 3.3.
+constexpr double kRk4StepScale = 0.25;
+constexpr double kRk45StepScale = 3.0;
+
+double rate_for(double fraction, double reference_ms) {
+    return -std::log1p(-std::min(fraction, kMaxFraction)) / reference_ms;
+}
+
+// The vector field for one interval, as coefficient columns, plus scratch
+// for the stages. One per thread so integrate() can stay const.
+struct Workspace {
+    std::vector<double> k_release, k_reuptake, baseline, target;
+    std::vector<double> k1, k2, k3, k4, k5, k6, k7, tmp, next;
+
+    void resize(std::size_t n) {
+        for (auto* v : {&k_release, &k_reuptake, &baseline, &target, &k1, &k2, &k3, &k4, &k5, &k6, &k7,
+                        &tmp, &next}) {
+            v->resize(n);
+        }
+    }
+
+    void derivative(const std::vector<double>& y, std::vector<double>& dy) const {
+        for (std::size_t i = 0; i < y.size(); ++i) {
+            dy[i] = k_release[i] * std::max(0.0, target[i] - y[i]) + k_reuptake[i] * (baseline[i] - y[i]);
+        }
+    }
+
+    // tmp = y + h * sum(a_j * k_j)
+    template <std::size_t N>
+    void stage(const std::vector<double>& y, double h, const double (&a)[N],
+               const std::vector<double>* const (&k)[N]) {
+        for (std::size_t i = 0; i < y.size(); ++i) {
+            double s = 0.0;
+            for (std::size_t j = 0; j < N; ++j) s += a[j] * (*k[j])[i];
+            tmp[i] = y[i] + h * s;
+        }
+    }
+};
+
+Workspace& workspace() {
+    thread_local Workspace w;
+    return w;
+}
+
+void rk4_step(Workspace& w, std::vector<double>& y, double h) {
+    w.derivative(y, w.k1);
+    for (std::size_t i = 0; i < y.size(); ++i) w.tmp[i] = y[i] + 0.5 * h * w.k1[i];
+    w.derivative(w.tmp, w.k2);
+    for (std::size_t i = 0; i < y.size(); ++i) w.tmp[i] = y[i] + 0.5 * h * w.k2[i];
+    w.derivative(w.tmp, w.k3);
+    for (std::size_t i = 0; i < y.size(); ++i) w.tmp[i] = y[i] + h * w.k3[i];
+    w.derivative(w.tmp, w.k4);
+    for (std::size_t i = 0; i < y.size(); ++i) {
+        y[i] += h / 6.0 * (w.k1[i] + 2.0 * w.k2[i] + 2.0 * w.k3[i] + w.k4[i]);
+    }
+}
+
+// One Dormand-Prince attempt from y with k1 = f(y) already in place. Leaves
+// the fifth-order solution in w.next and f(w.next) in w.k7, and returns the
+// error estimate scaled so that 1 is just acceptable.
+double dopri_step(Workspace& w, const std::vector<double>& y, double h, double tolerance) {
+    w.stage(y, h, {1.0 / 5}, {&w.k1});
+    w.derivative(w.tmp, w.k2);
+    w.stage(y, h, {3.0 / 40, 9.0 / 40}, {&w.k1, &w.k2});
+    w.derivative(w.tmp, w.k3);
+    w.stage(y, h, {44.0 / 45, -56.0 / 15, 32.0 / 9}, {&w.k1, &w.k2, &w.k3});
+    w.derivative(w.tmp, w.k4);
+    w.stage(y, h, {19372.0 / 6561, -25360.0 / 2187, 64448.0 / 6561, -212.0 / 729},
+            {&w.k1, &w.k2, &w.k3, &w.k4});
+    w.derivative(w.tmp, w.k5);
+    w.stage(y, h, {9017.0 / 3168, -355.0 / 33, 46732.0 / 5247, 49.0 / 176, -5103.0 / 18656},
+            {&w.k1, &w.k2, &w.k3, &w.k4, &w.k5});
+    w.derivative(w.tmp, w.k6);
+    w.stage(y, h, {35.0 / 384, 0.0, 500.0 / 1113, 125.0 / 192, -2187.0 / 6784, 11.0 / 84},
+            {&w.k1, &w.k2, &w.k3, &w.k4, &w.k5, &w.k6});
+    w.next = w.tmp;
+    w.derivative(w.next, w.k7);
+
+    double err = 0.0;
+    for (std::size_t i = 0; i < y.size(); ++i) {
+        const double e = h * (71.0 / 57600 * w.k1[i] - 71.0 / 16695 * w.k3[i] + 71.0 / 1920 * w.k4[i] -
+                              17253.0 / 339200 * w.k5[i] + 22.0 / 525 * w.k6[i] - 1.0 / 40 * w.k7[i]);
+        const double scale = tolerance * (1.0 + std::max(std::abs(y[i]), std::abs(w.next[i])));
+        err = std::max(err, std::abs(e) / scale);
+    }
+    return err;
+}
+
+}
+
+ChemistryIntegrator::ChemistryIntegrator(Method method, double reference_step_ms, double tolerance)
+    : method_(method), reference_ms_(std::max(reference_step_ms, 1e-6)), tolerance_(std::max(tolerance, 1e-14)) {}
+
+std::size_t ChemistryIntegrator::integrate(const std::vector<NeurotransmitterInfo>& catalog,
+                                           std::vector<double>& levels, const std::vector<double>& release,
+                                           double dt_ms) const {
+    const std::size_t n = std::min(catalog.size(), levels.size());
+    if (!(dt_ms > 0.0) || n == 0) return 0;
+
+    Workspace& w = workspace();
+    w.resize(n);
+    levels.resize(n);
+    double fastest = 0.0;
+    double slowest = INFINITY;
+    const double k_release = rate_for(0.5, reference_ms_);
+    for (std::size_t i = 0; i < n; ++i) {
+        const NeurotransmitterInfo& nt = catalog[i];
+        const double pressure = i < release.size() ? release[i] : 0.0;
+        w.k_release[i] = k_release;
+        w.k_reuptake[i] = rate_for(nt.reuptake_rate, reference_ms_);
+        w.baseline[i] = nt.baseline;
+        w.target[i] = nt.baseline + nt.release_gain * pressure * (1.0 - nt.baseline);
+        fastest = std::max(fastest, w.k_release[i] + w.k_reuptake[i]);
+        // Without reuptake a level above its target never moves, and one
+        // below it settles at the release rate.
+        slowest = std::min(slowest, w.k_reuptake[i] > 0.0 ? w.k_reuptake[i] : w.k_release[i]);
+    }
+    const double span = std::min(dt_ms, kSettleTimeConstants / slowest);
+
+    std::size_t steps = 0;
+    if (method_ == Method::RK4) {
+        steps = static_cast<std::size_t>(std::ceil(span * fastest / kRk4StepScale));
+        steps = std::max<std::size_t>(steps, 1);
+        const double h = span / static_cast<double>(steps);
+        for (std::size_t s = 0; s < steps; ++s) rk4_step(w, levels, h);
+    } else {
+        const double h_max = kRk45StepScale / fastest;
+        double h = std::min(span, h_max);
+        double t = 0.0;
+        w.derivative(levels, w.k1);
+        while (t < span) {
+            h = std::min(h, span - t);
+            const double err = dopri_step(w, levels, h, tolerance_);
+            if (err <= 1.0) {
+                t = h >= span - t ? span : t + h;
+                levels.swap(w.next);
+                w.k1.swap(w.k7);
+                ++steps;
+            }
+            const double grow = err > 0.0 ? 0.9 * std::pow(err, -0.2) : 5.0;
+            h = std::min(h_max, h * std::min(5.0, std::max(0.2, grow)));
+        }
+    }
+    for (auto& v : levels) v = std::max(0.0, std::min(1.0, v));
+    return steps;
+}
+
+ChemistryTimeline::ChemistryTimeline(ChemistryIntegrator integrator) : integrator_(integrator) { reset(); }
+
+void ChemistryTimeline::reset() {
+    state_ = Neurochemistry::baseline_state();
+    last_ms_ = 0;
+    started_ = false;
+}
+
+std::size_t ChemistryTimeline::update(std::int64_t timestamp_ms, const std::vector<double>& intensity_by_region) {
+    if (!started_) {
+        started_ = true;
+        last_ms_ = timestamp_ms;
+        return 0;
+    }
+    if (timestamp_ms <= last_ms_) return 0;
+    const double dt = static_cast<double>(timestamp_ms - last_ms_);
+    last_ms_ = timestamp_ms;
+    return Neurochemistry::integrate(state_, intensity_by_region, dt, integrator_);
+}
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "core/neurochemistry.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cerebra {
+
+// Continuous-time form of the release/reuptake model. Each transmitter's
+// level L obeys
+//
+//   dL/dt = k_release * max(0, T - L) + k_reuptake * (baseline - L)
+//   T     = baseline + release_gain * pressure * (1 - baseline)
+//
+// where the rates are chosen so that one `reference_step_ms` interval closes
+// the same fraction of each gap as one discrete Neurochemistry::step: half of
+// the release gap and `reuptake_rate` of the gap to baseline. Integrating
+// over the real time between frames makes the result independent of the
+// frame rate.
+//
+// All transmitters advance together as one vector. Steps are capped by the
+// fastest rate in the catalog so the explicit schemes stay stable however
+// large dt is, and an interval longer than the time the slowest mode needs to
+// settle to round-off is cut short, so sub-step counts stay bounded.
+class ChemistryIntegrator {
+public:
+    enum class Method {
+        RK4,   // classic fourth order, equal sub-steps
+        RK45,  // Dormand-Prince 5(4) with error control
+    };
+
+    explicit ChemistryIntegrator(Method method = Method::RK4, double reference_step_ms = 100.0,
+                                 double tolerance = 1e-8);
+
+    Method method() const { return method_; }
+    double reference_step_ms() const { return reference_ms_; }
+
+    // Advance `levels` (indexed like `catalog`) by `dt_ms` with the release
+    // pressure per transmitter held at `release`. Returns the number of
+    // accepted sub-steps.
+    std::size_t integrate(const std::vector<NeurotransmitterInfo>& catalog, std::vector<double>& levels,
+                          const std::vector<double>& release, double dt_ms) const;
+
+private:
+    Method method_;
+    double reference_ms_;
+    double tolerance_;
+};
+
+// Chemistry driven by timestamped frames. Each frame's intensities are held
+// over the gap since the previous frame, so a recording gives the same
+// chemistry whether it is fed at the device rate or decimated.
+class ChemistryTimeline {
+public:
+    explicit ChemistryTimeline(ChemistryIntegrator integrator = ChemistryIntegrator());
+
+    const ChemicalState& state() const { return state_; }
+    const ChemistryIntegrator& integrator() const { return integrator_; }
+
+    // Back to the baseline state with no time elapsed.
+    void reset();
+
+    // Integrate up to `timestamp_ms` (intensities indexed by RegionId). The
+    // first frame only starts the clock; a frame that does not move time
+    // forward changes nothing. Returns the sub-steps taken.
+    std::size_t update(std::int64_t timestamp_ms, const std::vector<double>& intensity_by_region);
+
+private:
+    ChemistryIntegrator integrator_;
+    ChemicalState state_;
+    std::int64_t last_ms_ = 0;
+    bool started_ = false;
+};
+
+}
@@ -1,4 +1,5 @@
 #include "core/data_parsing_hub.h"
+#include "io/json_document.h"
 #include "io/json_parser.h"
 #include "io/yaml_parser.h"
 #include "io/xml_parser.h"
@@ -74,11 +75,7 @@ std::vector<cerebra::BrainFrame> load_simulation_state(const std::string& filena
             ifs.read(&name[0], n_len);
             double intens;
             ifs.read((char*)&intens, sizeof(double));
-            cerebra::RegionState r;
-            r.region = internString(name);
-            r.intensity = intens;
-            r.flows = default_flows_for(r.region, r.intensity);
-            f.regions.push_back(std::move(r));
+            f.regions.push_back(make_region_state(internString(name), intens));
         }
         frames.push_back(std::move(f));
     }
@@ -93,7 +90,8 @@ std::string encrypt_data(const std::string& data, const std::string& key) {
 
 bool validate_brain_activity_json(const std::string& json) {
     try {
-        auto val = JsonValue::parse(json);
+        const JsonDocument doc = JsonDocument::parse(json);
+        const JsonElement& val = doc.root();
         // Basic schema check: should be an array of frames or an object with a 'frames' key
         return val.is_array() || (val.is_object() && val.contains("frames"));
     } catch (...) {
@@ -142,7 +140,8 @@ void validate_atlas_schema(const std::string& path) {
     if (!in) throw std::runtime_error("Cannot open atlas for validation: " + path);
     std::stringstream ss;
     ss << in.rdbuf();
-    auto val = JsonValue::parse(ss.str());
+    const JsonDocument doc = JsonDocument::parse(ss.str());
+    const JsonElement& val = doc.root();
     if (!val.is_object() || !val.contains("regions")) {
         throw std::runtime_error("Invalid atlas schema: missing 'regions' key");
     }
@@ -0,0 +1,337 @@
+#include "core/frame_store.h"
+
+#include "core/atlas_core.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace cerebra {
+
+namespace {
+
+// True when the (non-empty) `rs.flows` spell out exactly the atlas defaults
+// for the region at its intensity, so the store can derive them again.
+bool flows_match_atlas(const RegionState& rs, const RegionAtlas& atlas) {
+    const RegionDefinition* def = atlas.at(rs.region_id);
+    if (!def || def->id != rs.region) def = atlas.find(rs.region);
+    if (!def) {
+        return rs.flows.size() == 1 && rs.flows[0].type == "glutamate" &&
+               rs.flows[0].rate == 0.5 * rs.intensity;
+    }
+    if (rs.flows.size() != def->flows.size()) return false;
+    for (std::size_t i = 0; i < def->flows.size(); ++i) {
+        if (rs.flows[i].type != def->flows[i].transmitter ||
+            rs.flows[i].rate != def->flows[i].base_rate * rs.intensity) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+double FrameView::intensity_of(RegionId id) const {
+    std::size_t col = store->column_of(id);
+    return col == FrameStore::npos ? 0.0 : store->intensity(index, col);
+}
+
+double FrameView::intensity_of(RegionId id, const AtlasSnapshot& atlas) const {
+    std::size_t col = store->column_of(id, atlas);
+    return col == FrameStore::npos ? 0.0 : store->intensity(index, col);
+}
+
+double FrameView::intensity_of(std::string_view region_key) const {
+    std::size_t col = store->column_of(region_key);
+    return col == FrameStore::npos ? 0.0 : store->intensity(index, col);
+}
+
+BrainFrame FrameView::to_frame() const {
+    return store->materialize(index);
+}
+
+std::size_t RegionSeries::size() const {
+    return store_->frame_count();
+}
+
+double RegionSeries::operator[](std::size_t frame) const {
+    return column_ == FrameStore::npos ? 0.0 : store_->intensity(frame, column_);
+}
+
+std::string_view FrameStore::Arena::add_key(std::string_view key) {
+    char* chars = static_cast<char*>(resource.allocate(std::max<std::size_t>(key.size(), 1), 1));
+    std::copy(key.begin(), key.end(), chars);
+    const std::string_view stored(chars, key.size());
+    by_key.emplace(stored, keys.size());
+    keys.push_back(stored);
+    return stored;
+}
+
+FrameStore::FrameStore(const FrameStore& other)
+    : timestamps_(other.timestamps_),
+      intensity_(other.intensity_),
+      stride_(other.stride_),
+      present_(other.present_),
+      atlas_flows_(other.atlas_flows_),
+      words_(other.words_),
+      column_ids_(other.column_ids_),
+      column_by_id_(other.column_by_id_),
+      atlas_version_(other.atlas_version_) {
+    if (!other.arena_) return;
+    arena_ = std::make_unique<Arena>();
+    arena_->keys.reserve(other.arena_->keys.size());
+    for (std::string_view key : other.arena_->keys) arena_->add_key(key);
+    arena_->metrics.insert(other.arena_->metrics.begin(), other.arena_->metrics.end());
+    arena_->flows.insert(other.arena_->flows.begin(), other.arena_->flows.end());
+    arena_->flow_intensity.insert(other.arena_->flow_intensity.begin(), other.arena_->flow_intensity.end());
+}
+
+FrameStore::~FrameStore() = default;
+
+void FrameStore::swap(FrameStore& other) noexcept {
+    timestamps_.swap(other.timestamps_);
+    intensity_.swap(other.intensity_);
+    std::swap(stride_, other.stride_);
+    present_.swap(other.present_);
+    atlas_flows_.swap(other.atlas_flows_);
+    std::swap(words_, other.words_);
+    column_ids_.swap(other.column_ids_);
+    column_by_id_.swap(other.column_by_id_);
+    std::swap(atlas_version_, other.atlas_version_);
+    arena_.swap(other.arena_);
+}
+
+void FrameStore::clear() {
+    timestamps_.clear();
+    intensity_.clear();
+    stride_ = 0;
+    present_.clear();
+    atlas_flows_.clear();
+    words_ = 0;
+    column_ids_.clear();
+    column_by_id_.clear();
+    atlas_version_ = 0;
+    // Drops the keys, the key index and both side tables in one release.
+    arena_.reset();
+}
+
+void FrameStore::assign(const std::vector<BrainFrame>& frames) {
+    clear();
+    // Discover every column first so the matrix is laid out exactly once.
+    const auto snapshot = acquire_atlas_snapshot();
+    for (const auto& f : frames) {
+        for (const auto& r : f.regions) column_for(r.region, *snapshot);
+    }
+    timestamps_.reserve(frames.size());
+    intensity_.reserve(frames.size() * stride_);
+    present_.reserve(frames.size() * words_);
+    atlas_flows_.reserve(frames.size() * words_);
+    for (const auto& f : frames) append(f);
+}
+
+void FrameStore::append(const BrainFrame& frame) {
+    const auto snapshot = acquire_atlas_snapshot();
+    rebind(*snapshot);
+    std::size_t row = add_frame(frame.timestamp_ms);
+    for (const auto& rs : frame.regions) {
+        // Trust the state's binding when it still matches the atlas; this skips
+        // a key lookup for everything the parsers produced.
+        const RegionDefinition* def = snapshot->atlas.at(rs.region_id);
+        std::size_t col = def && def->id == rs.region ? column_of(rs.region_id, *snapshot) : npos;
+        if (col == npos) col = column_for(rs.region, *snapshot);
+        if (present(row, col)) continue;
+        set(row, col, rs.intensity);
+        store_extras(row, col, rs, snapshot->atlas);
+    }
+}
+
+std::size_t FrameStore::add_frame(std::int64_t timestamp_ms) {
+    timestamps_.push_back(timestamp_ms);
+    intensity_.resize(timestamps_.size() * stride_, 0.0);
+    present_.resize(timestamps_.size() * words_, 0);
+    atlas_flows_.resize(timestamps_.size() * words_, 0);
+    return timestamps_.size() - 1;
+}
+
+std::size_t FrameStore::column_of(RegionId id) const {
+    return column_of(id, *acquire_atlas_snapshot());
+}
+
+std::size_t FrameStore::column_of(RegionId id, const AtlasSnapshot& atlas) const {
+    if (atlas.version == atlas_version_) return id < column_by_id_.size() ? column_by_id_[id] : npos;
+    // Bound to another atlas: go through the key the id names in `atlas`.
+    const RegionDefinition* def = atlas.atlas.at(id);
+    return def ? column_of(def->id) : npos;
+}
+
+std::size_t FrameStore::column_of(std::string_view region_key) const {
+    if (!arena_) return npos;
+    auto it = arena_->by_key.find(region_key);
+    return it == arena_->by_key.end() ? npos : it->second;
+}
+
+RegionId FrameStore::column_region(std::size_t column) const {
+    return column_region(column, *acquire_atlas_snapshot());
+}
+
+RegionId FrameStore::column_region(std::size_t column, const AtlasSnapshot& atlas) const {
+    return atlas.version == atlas_version_ ? column_ids_[column] : atlas.atlas.id_of(column_key(column));
+}
+
+std::size_t FrameStore::column_for(std::string_view region_key) {
+    return column_for(region_key, *acquire_atlas_snapshot());
+}
+
+std::size_t FrameStore::column_for(std::string_view region_key, const AtlasSnapshot& atlas) {
+    rebind(atlas);
+    std::size_t col = column_of(region_key);
+    if (col != npos) return col;
+    RegionId id = atlas.atlas.id_of(region_key);
+    if (!arena_) arena_ = std::make_unique<Arena>();
+    col = arena_->keys.size();
+    reserve_columns(col + 1);
+    arena_->add_key(region_key);
+    column_ids_.push_back(id);
+    if (id != kNoRegion) {
+        if (id >= column_by_id_.size()) column_by_id_.resize(atlas.atlas.size(), npos);
+        column_by_id_[id] = col;
+    }
+    return col;
+}
+
+void FrameStore::rebind(const AtlasSnapshot& atlas) {
+    if (atlas.version == atlas_version_) return;
+    column_by_id_.assign(atlas.atlas.size(), npos);
+    for (std::size_t col = 0; col < column_ids_.size(); ++col) {
+        column_ids_[col] = atlas.atlas.id_of(column_key(col));
+        if (column_ids_[col] != kNoRegion) column_by_id_[column_ids_[col]] = col;
+    }
+    atlas_version_ = atlas.version;
+}
+
+std::size_t FrameStore::column_for(RegionId id) {
+    return column_for(id, *acquire_atlas_snapshot());
+}
+
+std::size_t FrameStore::column_for(RegionId id, const AtlasSnapshot& atlas) {
+    std::size_t col = column_of(id, atlas);
+    if (col != npos) return col;
+    const RegionDefinition* def = atlas.atlas.at(id);
+    return def ? column_for(def->id, atlas) : npos;
+}
+
+void FrameStore::reserve_columns(std::size_t columns) {
+    if (columns <= stride_) return;
+    std::size_t new_stride = std::max<std::size_t>({columns, stride_ * 2, 8});
+    std::vector<double> grown(timestamps_.size() * new_stride, 0.0);
+    for (std::size_t f = 0; f < timestamps_.size(); ++f) {
+        std::copy_n(intensity_.begin() + f * stride_, stride_, grown.begin() + f * new_stride);
+    }
+    intensity_.swap(grown);
+    stride_ = new_stride;
+
+    const std::size_t new_words = (new_stride + 63) / 64;
+    if (new_words == words_) return;
+    for (auto* bitmap : {&present_, &atlas_flows_}) {
+        std::vector<std::uint64_t> bits(timestamps_.size() * new_words, 0);
+        for (std::size_t f = 0; f < timestamps_.size(); ++f) {
+            std::copy_n(bitmap->begin() + f * words_, words_, bits.begin() + f * new_words);
+        }
+        bitmap->swap(bits);
+    }
+    words_ = new_words;
+}
+
+void FrameStore::set(std::size_t frame, std::size_t column, double intensity) {
+    intensity_[frame * stride_ + column] = intensity;
+    present_[frame * words_ + column / 64] |= std::uint64_t(1) << (column % 64);
+}
+
+bool FrameStore::present(std::size_t frame, std::size_t column) const {
+    return column < column_count() &&
+           (present_[frame * words_ + column / 64] >> (column % 64) & 1) != 0;
+}
+
+bool FrameStore::atlas_flows(std::size_t frame, std::size_t column) const {
+    return column < column_count() &&
+           (atlas_flows_[frame * words_ + column / 64] >> (column % 64) & 1) != 0;
+}
+
+void FrameStore::store_extras(std::size_t frame, std::size_t column, const RegionState& rs,
+                              const RegionAtlas& atlas) {
+    if (rs.has_detail() && !rs.detail().metrics.empty()) {
+        const auto& src = rs.detail().metrics;
+        Metrics& dst = arena_->metrics[cell_key(frame, column)];
+        dst.clear();
+        for (const auto& [name, value] : src) dst.emplace_hint(dst.end(), std::string_view(name), value);
+    }
+    // Flows that merely spell out the atlas defaults are dropped and derived
+    // again on the way out; anything else goes to the side table.
+    bool derived = rs.atlas_flows;
+    double scale = rs.atlas_flows && !std::isnan(rs.flow_intensity) ? rs.flow_intensity : rs.intensity;
+    if (!rs.flows.empty()) {
+        if (flows_match_atlas(rs, atlas)) {
+            derived = true;
+            scale = rs.intensity;
+        } else {
+            arena_->flows[cell_key(frame, column)].assign(rs.flows.begin(), rs.flows.end());
+        }
+    }
+    if (!derived) return;
+    atlas_flows_[frame * words_ + column / 64] |= std::uint64_t(1) << (column % 64);
+    if (scale != rs.intensity) arena_->flow_intensity[cell_key(frame, column)] = scale;
+}
+
+const FrameStore::Metrics* FrameStore::metrics(std::size_t frame, std::size_t column) const {
+    if (!arena_) return nullptr;
+    auto it = arena_->metrics.find(cell_key(frame, column));
+    return it == arena_->metrics.end() ? nullptr : &it->second;
+}
+
+const FrameStore::Flows* FrameStore::custom_flows(std::size_t frame, std::size_t column) const {
+    if (!arena_) return nullptr;
+    auto it = arena_->flows.find(cell_key(frame, column));
+    return it == arena_->flows.end() ? nullptr : &it->second;
+}
+
+BrainFrame FrameStore::materialize(std::size_t frame) const {
+    const auto snapshot = acquire_atlas_snapshot();
+    BrainFrame f;
+    f.timestamp_ms = timestamps_[frame];
+    for (std::size_t col = 0; col < column_count(); ++col) {
+        if (!present(frame, col)) continue;
+        RegionState rs;
+        rs.region = column_key(col);
+        rs.intensity = cell(frame, col);
+        rs.region_id = column_region(col, *snapshot);
+        if (const auto* flows = custom_flows(frame, col)) rs.flows.assign(flows->begin(), flows->end());
+        if (atlas_flows(frame, col)) {
+            rs.atlas_flows = true;
+            auto it = arena_->flow_intensity.find(cell_key(frame, col));
+            rs.flow_intensity = it == arena_->flow_intensity.end() ? rs.intensity : it->second;
+        }
+        if (const auto* m = metrics(frame, col)) {
+            auto& dst = rs.mutable_detail().metrics;
+            for (const auto& [name, value] : *m) dst.emplace_hint(dst.end(), std::string(name), value);
+        }
+        f.regions.push_back(std::move(rs));
+    }
+    return f;
+}
+
+std::size_t FrameStore::memory_bytes() const {
+    std::size_t bytes = timestamps_.capacity() * sizeof(std::int64_t) +
+                        intensity_.capacity() * sizeof(double) +
+                        (present_.capacity() + atlas_flows_.capacity()) * sizeof(std::uint64_t);
+    bytes += column_ids_.capacity() * sizeof(RegionId) +
+             column_by_id_.capacity() * sizeof(std::size_t);
+    if (!arena_) return bytes;
+    for (std::string_view k : arena_->keys) bytes += sizeof(k) + k.size();
+    bytes += arena_->by_key.size() * (sizeof(std::string_view) + sizeof(std::size_t) + sizeof(void*));
+    for (const auto& kv : arena_->metrics) bytes += sizeof(kv) + kv.second.size() * 64;
+    for (const auto& kv : arena_->flows) bytes += sizeof(kv) + kv.second.size() * sizeof(NeurotransmitterFlow);
+    bytes += arena_->flow_intensity.size() * (sizeof(std::uint64_t) + sizeof(double) + sizeof(void*));
+    return bytes;
+}
+
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include "core/state_manager.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace cerebra {
+
+class FrameStore;
+
+// A lightweight, non-owning view of one frame of a FrameStore. Lookups go
+// straight to the store's intensity matrix; to_frame() materialises a full
+// BrainFrame when a caller really needs RegionState objects.
+struct FrameView {
+    const FrameStore* store = nullptr;
+    std::size_t index = 0;
+    std::int64_t timestamp_ms = 0;
+
+    double intensity_of(RegionId id) const;
+    double intensity_of(RegionId id, const AtlasSnapshot& atlas) const;  // id in `atlas`
+    double intensity_of(std::string_view region_key) const;
+    BrainFrame to_frame() const;
+};
+
+// One region's intensity across every frame of a FrameStore, read straight
+// out of the matrix. Frames that did not report the region (or a region the
+// store has never seen) read as 0.0, matching FrameView::intensity_of.
+class RegionSeries {
+public:
+    class iterator {
+    public:
+        iterator(const RegionSeries* series, std::size_t i) : series_(series), i_(i) {}
+        double operator*() const { return (*series_)[i_]; }
+        iterator& operator++() { ++i_; return *this; }
+        bool operator!=(const iterator& other) const { return i_ != other.i_; }
+        bool operator==(const iterator& other) const { return i_ == other.i_; }
+
+    private:
+        const RegionSeries* series_;
+        std::size_t i_;
+    };
+
+    RegionSeries(const FrameStore* store, std::size_t column) : store_(store), column_(column) {}
+
+    std::size_t size() const;
+    bool empty() const { return size() == 0; }
+    double operator[](std::size_t frame) const;
+    iterator begin() const { return {this, 0}; }
+    iterator end() const { return {this, size()}; }
+
+private:
+    const FrameStore* store_;
+    std::size_t column_;
+};
+
+// Columnar storage for a whole timeline: one contiguous timestamp column and a
+// dense frames x regions intensity matrix. Each region seen in the input gets
+// a column; cells a frame did not report are absent (and read back as 0.0).
+// Presence is tracked in a bitmap beside the matrix, so every double,
+// including NaN, is a storable reading.
+// Per-region metrics and flows that differ from the atlas defaults live in
+// sparse side tables, so the common case costs one double per cell.
+//
+// Within a frame, the first state reported for a region wins (this matches
+// BrainFrame::intensity_of). Materialised frames list regions in column order.
+//
+// Columns are identified by key. Their RegionIds are resolved against the
+// atlas current at ingest and re-resolved when a later ingest sees a newer
+// atlas; until then, lookups by id translate through the current atlas's key
+// for that id, so an atlas swap never maps an id onto another region's column.
+// Callers resolving many ids against an atlas they hold pass its snapshot.
+//
+// Column keys, the key index and the side tables (metric names included) are
+// allocated from a per-store monotonic arena, created with the first column;
+// clear() and assign() drop all of it in one release instead of freeing node
+// by node. Moving a store hands the arena over without allocating.
+class FrameStore {
+public:
+    using Metrics = std::pmr::map<std::pmr::string, double, std::less<>>;
+    using Flows = std::pmr::vector<NeurotransmitterFlow>;
+
+    FrameStore() = default;
+    explicit FrameStore(const std::vector<BrainFrame>& frames) : FrameStore() { assign(frames); }
+    FrameStore(const FrameStore& other);
+    FrameStore(FrameStore&& other) noexcept : FrameStore() { swap(other); }
+    FrameStore& operator=(FrameStore other) {
+        swap(other);
+        return *this;
+    }
+    ~FrameStore();
+
+    void swap(FrameStore& other) noexcept;
+
+    void assign(const std::vector<BrainFrame>& frames);
+    void append(const BrainFrame& frame);
+    void clear();
+
+    // Low-level ingest: open a new (empty) frame, find or create a region's
+    // column, and fill a cell.
+    std::size_t add_frame(std::int64_t timestamp_ms);
+    std::size_t column_for(std::string_view region_key);
+    std::size_t column_for(std::string_view region_key, const AtlasSnapshot& atlas);
+    std::size_t column_for(RegionId id);  // id in the current atlas
+    std::size_t column_for(RegionId id, const AtlasSnapshot& atlas);
+    void set(std::size_t frame, std::size_t column, double intensity);
+
+    std::size_t frame_count() const { return timestamps_.size(); }
+    std::size_t column_count() const { return arena_ ? arena_->keys.size() : 0; }
+    bool empty() const { return timestamps_.empty(); }
+
+    const std::vector<std::int64_t>& timestamps() const { return timestamps_; }
+    std::int64_t timestamp(std::size_t frame) const { return timestamps_[frame]; }
+
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+    std::string_view column_key(std::size_t column) const { return arena_->keys[column]; }
+    RegionId column_region(std::size_t column) const;  // id in the current atlas
+    RegionId column_region(std::size_t column, const AtlasSnapshot& atlas) const;
+    std::size_t column_of(RegionId id) const;          // id in the current atlas
+    std::size_t column_of(RegionId id, const AtlasSnapshot& atlas) const;
+    std::size_t column_of(std::string_view region_key) const;
+
+    bool present(std::size_t frame, std::size_t column) const;
+    // The cell's RegionState::atlas_flows: whether it carries the atlas
+    // default flows (derived on demand) rather than none.
+    bool atlas_flows(std::size_t frame, std::size_t column) const;
+    double intensity(std::size_t frame, std::size_t column) const {
+        return present(frame, column) ? cell(frame, column) : 0.0;
+    }
+
+    const Metrics* metrics(std::size_t frame, std::size_t column) const;
+    const Flows* custom_flows(std::size_t frame, std::size_t column) const;
+
+    FrameView view(std::size_t frame) const { return {this, frame, timestamps_[frame]}; }
+    RegionSeries series(std::string_view region_key) const { return {this, column_of(region_key)}; }
+    RegionSeries series(RegionId id) const { return {this, column_of(id)}; }
+    BrainFrame materialize(std::size_t frame) const;
+
+    // Approximate resident size of the store (matrix plus arena), for
+    // diagnostics.
+    std::size_t memory_bytes() const;
+
+private:
+    double cell(std::size_t frame, std::size_t column) const {
+        return intensity_[frame * stride_ + column];
+    }
+    static std::uint64_t cell_key(std::size_t frame, std::size_t column) {
+        return (static_cast<std::uint64_t>(frame) << 32) | static_cast<std::uint64_t>(column);
+    }
+    void reserve_columns(std::size_t columns);
+    void rebind(const AtlasSnapshot& atlas);  // re-resolve column ids if `atlas` is not the bound one
+    void store_extras(std::size_t frame, std::size_t column, const RegionState& rs,
+                      const RegionAtlas& atlas);
+
+    std::vector<std::int64_t> timestamps_;
+    std::vector<double> intensity_;        // frame-major, `stride_` cells per frame
+    std::size_t stride_ = 0;
+    std::vector<std::uint64_t> present_;   // frame-major bitmap, `words_` words per frame
+    std::vector<std::uint64_t> atlas_flows_;  // per-cell RegionState::atlas_flows, same layout
+    std::size_t words_ = 0;
+
+    std::vector<RegionId> column_ids_;     // per column, kNoRegion outside the atlas
+    std::vector<std::size_t> column_by_id_;  // RegionId -> column
+    std::uint64_t atlas_version_ = 0;      // atlas the two id tables were resolved against
+
+    // Everything allocated from the arena lives beside it, so the containers
+    // can never outlive their memory and swapping stores just swaps pointers.
+    struct Arena {
+        std::pmr::monotonic_buffer_resource resource;
+        // Per column; the characters are copied into `resource`.
+        std::pmr::vector<std::string_view> keys{&resource};
+        std::pmr::unordered_map<std::string_view, std::size_t> by_key{&resource};  // every column
+        // Sparse side tables keyed by cell_key().
+        std::pmr::unordered_map<std::uint64_t, Metrics> metrics{&resource};
+        std::pmr::unordered_map<std::uint64_t, Flows> flows{&resource};
+        // RegionState::flow_intensity, for atlas-flow cells where it is not
+        // the cell's intensity (a stage rewrote the reading).
+        std::pmr::unordered_map<std::uint64_t, double> flow_intensity{&resource};
+
+        // Append a column key; returns the arena's copy of it.
+        std::string_view add_key(std::string_view key);
+    };
+    std::unique_ptr<Arena> arena_;
+};
+
+}
@@ -0,0 +1,418 @@
+#include "core/intensity_expression.h"
+
+#include "core/atlas_region.h"
+#include "io/number_decode.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace cerebra {
+
+namespace {
+
+using Op = IntensityExpression::Op;
+using Instruction = IntensityExpression::Instruction;
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kE = 2.71828182845904523536;
+// Elements per batch: large enough to amortise dispatch, small enough that
+// every register stays in L1.
+constexpr std::size_t kBatch = 256;
+// Deepest expression tree accepted. Parsing and emission both recurse once
+// per level, so this bounds their stack use.
+constexpr int kMaxDepth = 1000;
+
+enum Var : std::uint16_t { X, T, Depth, SliceX, SliceY, ProjX, ProjY, ProjZ, Roi };
+
+const std::unordered_map<std::string_view, Var>& variables() {
+    static const std::unordered_map<std::string_view, Var> vars = {
+        {"x", X}, {"intensity", X}, {"t", T}, {"time", T},
+        {"depth", Depth}, {"slice_x", SliceX}, {"slice_y", SliceY},
+        {"proj_x", ProjX}, {"proj_y", ProjY}, {"proj_z", ProjZ}, {"roi", Roi},
+    };
+    return vars;
+}
+
+struct FunctionInfo {
+    Op op;
+    int arity;
+};
+
+const std::unordered_map<std::string_view, FunctionInfo>& functions() {
+    static const std::unordered_map<std::string_view, FunctionInfo> fns = {
+        {"sin", {Op::Sin, 1}}, {"cos", {Op::Cos, 1}}, {"tan", {Op::Tan, 1}},
+        {"exp", {Op::Exp, 1}}, {"log", {Op::Log, 1}}, {"sqrt", {Op::Sqrt, 1}},
+        {"abs", {Op::Abs, 1}}, {"floor", {Op::Floor, 1}},
+        {"min", {Op::Min, 2}}, {"max", {Op::Max, 2}}, {"pow", {Op::Pow, 2}},
+        {"clamp", {Op::Clamp, 3}},
+    };
+    return fns;
+}
+
+double apply(Op op, double a, double b, double c) {
+    switch (op) {
+        case Op::Neg: return -a;
+        case Op::Add: return a + b;
+        case Op::Sub: return a - b;
+        case Op::Mul: return a * b;
+        case Op::Div: return a / b;
+        case Op::Pow: return std::pow(a, b);
+        case Op::Sin: return std::sin(a);
+        case Op::Cos: return std::cos(a);
+        case Op::Tan: return std::tan(a);
+        case Op::Exp: return std::exp(a);
+        case Op::Log: return std::log(a);
+        case Op::Sqrt: return std::sqrt(a);
+        case Op::Abs: return std::abs(a);
+        case Op::Floor: return std::floor(a);
+        case Op::Min: return std::min(a, b);
+        case Op::Max: return std::max(a, b);
+        case Op::Clamp: return std::max(b, std::min(c, a));
+        case Op::Const:
+        case Op::Var: break;
+    }
+    return a;
+}
+
+// One batch loop per opcode, each the per-element form of apply().
+template <typename F>
+void map1(double* d, const double* a, std::size_t m, F f) {
+    for (std::size_t j = 0; j < m; ++j) d[j] = f(a[j]);
+}
+
+template <typename F>
+void map2(double* d, const double* a, const double* b, std::size_t m, F f) {
+    for (std::size_t j = 0; j < m; ++j) d[j] = f(a[j], b[j]);
+}
+
+double region_value(const RegionAtlas& atlas, RegionId id, Var var) {
+    static const RegionDefinition unknown;
+    const RegionDefinition* def = atlas.at(id);
+    if (!def) def = &unknown;
+    switch (var) {
+        case Depth: return def->depth;
+        case SliceX: return def->slice_x;
+        case SliceY: return def->slice_y;
+        case ProjX: return def->proj_x;
+        case ProjY: return def->proj_y;
+        case ProjZ: return def->proj_z;
+        case Roi: return def->region_of_interest ? 1.0 : 0.0;
+        case X:
+        case T: break;
+    }
+    return 0.0;
+}
+
+struct Node {
+    Op op;
+    double value = 0.0;  // Const
+    Var var = X;         // Var
+    int depth = 1;
+    std::vector<std::unique_ptr<Node>> args;
+};
+
+using NodePtr = std::unique_ptr<Node>;
+
+NodePtr make_const(double v) {
+    auto n = std::make_unique<Node>();
+    n->op = Op::Const;
+    n->value = v;
+    return n;
+}
+
+// Builds the node, folding it to a constant when every argument is one.
+NodePtr make_op(Op op, std::vector<NodePtr> args) {
+    bool constant = std::all_of(args.begin(), args.end(), [](const NodePtr& a) { return a->op == Op::Const; });
+    if (constant) {
+        double v[3] = {0.0, 0.0, 0.0};
+        for (std::size_t i = 0; i < args.size(); ++i) v[i] = args[i]->value;
+        return make_const(apply(op, v[0], v[1], v[2]));
+    }
+    auto n = std::make_unique<Node>();
+    n->op = op;
+    for (const auto& a : args) n->depth = std::max(n->depth, a->depth + 1);
+    n->args = std::move(args);
+    return n;
+}
+
+NodePtr make_op(Op op, NodePtr a) {
+    std::vector<NodePtr> args;
+    args.push_back(std::move(a));
+    return make_op(op, std::move(args));
+}
+
+NodePtr make_op(Op op, NodePtr a, NodePtr b) {
+    std::vector<NodePtr> args;
+    args.push_back(std::move(a));
+    args.push_back(std::move(b));
+    return make_op(op, std::move(args));
+}
+
+// expr    := term (('+' | '-') term)*
+// term    := unary (('*' | '/') unary)*
+// unary   := '-' unary | '+' unary | power
+// power   := primary ('^' unary)?
+// primary := number | name | name '(' expr (',' expr)* ')' | '(' expr ')'
+class Parser {
+public:
+    explicit Parser(const std::string& src) : src_(src) {}
+
+    NodePtr parse() {
+        NodePtr n = expr();
+        skip_space();
+        if (pos_ < src_.size()) fail("unexpected '" + std::string(1, src_[pos_]) + "'");
+        return n;
+    }
+
+    bool uses_time = false;
+    bool uses_region = false;
+
+private:
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error("intensity_transform: " + what + " at column " + std::to_string(pos_ + 1) +
+                                 " in '" + src_ + "'");
+    }
+
+    void skip_space() {
+        while (pos_ < src_.size() && std::isspace(static_cast<unsigned char>(src_[pos_]))) ++pos_;
+    }
+
+    bool accept(char c) {
+        skip_space();
+        if (pos_ < src_.size() && src_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!accept(c)) fail(std::string("expected '") + c + "'");
+    }
+
+    NodePtr bounded(NodePtr n) const {
+        if (n->depth > kMaxDepth) fail("expression nested too deeply");
+        return n;
+    }
+
+    NodePtr expr() {
+        NodePtr n = term();
+        for (;;) {
+            if (accept('+')) n = bounded(make_op(Op::Add, std::move(n), term()));
+            else if (accept('-')) n = bounded(make_op(Op::Sub, std::move(n), term()));
+            else return n;
+        }
+    }
+
+    NodePtr term() {
+        NodePtr n = unary();
+        for (;;) {
+            if (accept('*')) n = bounded(make_op(Op::Mul, std::move(n), unary()));
+            else if (accept('/')) n = bounded(make_op(Op::Div, std::move(n), unary()));
+            else return n;
+        }
+    }
+
+    // Every recursive rule passes through here, so nesting is counted once.
+    NodePtr unary() {
+        if (++nesting_ > kMaxDepth) fail("expression nested too deeply");
+        NodePtr n;
+        if (accept('-')) n = bounded(make_op(Op::Neg, unary()));
+        else if (accept('+')) n = unary();
+        else n = power();
+        --nesting_;
+        return n;
+    }
+
+    NodePtr power() {
+        NodePtr base = primary();
+        if (accept('^')) return bounded(make_op(Op::Pow, std::move(base), unary()));
+        return base;
+    }
+
+    NodePtr primary() {
+        skip_space();
+        if (pos_ >= src_.size()) fail("unexpected end of expression");
+        const char c = src_[pos_];
+        if (accept('(')) {
+            NodePtr n = expr();
+            expect(')');
+            return n;
+        }
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+            double v = 0.0;
+            std::size_t used = 0;
+            const std::errc ec = decode_number_prefix(std::string_view(src_).substr(pos_), v, used);
+            if (ec == std::errc::result_out_of_range) fail("number out of range");
+            if (ec != std::errc()) fail("malformed number");
+            pos_ += used;
+            return make_const(v);
+        }
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            const std::size_t start = pos_;
+            while (pos_ < src_.size() &&
+                   (std::isalnum(static_cast<unsigned char>(src_[pos_])) || src_[pos_] == '_')) {
+                ++pos_;
+            }
+            const std::string_view name(src_.data() + start, pos_ - start);
+            if (accept('(')) return call(name, start);
+            if (name == "pi") return make_const(kPi);
+            if (name == "e") return make_const(kE);
+            auto v = variables().find(name);
+            if (v == variables().end()) {
+                pos_ = start;
+                fail("unknown name '" + std::string(name) + "'");
+            }
+            if (v->second == T) uses_time = true;
+            if (v->second != X && v->second != T) uses_region = true;
+            auto n = std::make_unique<Node>();
+            n->op = Op::Var;
+            n->var = v->second;
+            return n;
+        }
+        fail("unexpected '" + std::string(1, c) + "'");
+    }
+
+    NodePtr call(std::string_view name, std::size_t start) {
+        auto f = functions().find(name);
+        if (f == functions().end()) {
+            pos_ = start;
+            fail("unknown function '" + std::string(name) + "'");
+        }
+        std::vector<NodePtr> args;
+        args.push_back(expr());
+        while (accept(',')) args.push_back(expr());
+        expect(')');
+        if (static_cast<int>(args.size()) != f->second.arity) {
+            pos_ = start;
+            fail(std::string(name) + " takes " + std::to_string(f->second.arity) + " argument(s)");
+        }
+        return bounded(make_op(f->second.op, std::move(args)));
+    }
+
+    const std::string& src_;
+    std::size_t pos_ = 0;
+    int nesting_ = 0;
+};
+
+// Post-order emission: one register per node, one per distinct variable.
+struct Emitter {
+    explicit Emitter(const std::string& src) : source(src) {}
+
+    const std::string& source;
+    std::vector<Instruction> code;
+    std::uint16_t next = 0;
+    std::unordered_map<int, std::uint16_t> var_register;
+
+    std::uint16_t emit(const Node& n) {
+        if (n.op == Op::Var) {
+            auto it = var_register.find(n.var);
+            if (it != var_register.end()) return it->second;
+        }
+        Instruction in;
+        in.op = n.op;
+        in.value = n.value;
+        std::uint16_t* operands[3] = {&in.a, &in.b, &in.c};
+        for (std::size_t i = 0; i < n.args.size(); ++i) *operands[i] = emit(*n.args[i]);
+        if (n.op == Op::Var) in.a = n.var;
+        if (next == std::numeric_limits<std::uint16_t>::max()) {
+            throw std::runtime_error("intensity_transform: expression needs more than " +
+                                     std::to_string(next) + " registers in '" + source + "'");
+        }
+        in.dst = next++;
+        if (n.op == Op::Var) var_register[n.var] = in.dst;
+        code.push_back(in);
+        return in.dst;
+    }
+};
+
+}
+
+IntensityExpression IntensityExpression::compile(std::string_view source) {
+    IntensityExpression e;
+    e.source_ = std::string(source);
+    Parser parser(e.source_);
+    NodePtr root = parser.parse();
+    Emitter emitter(e.source_);
+    e.result_ = emitter.emit(*root);
+    e.code_ = std::move(emitter.code);
+    e.registers_ = emitter.next;
+    e.scratch_.assign(e.registers_ * kBatch, 0.0);
+    for (const auto& in : e.code_) {
+        if (in.op == Op::Const) std::fill_n(e.scratch_.begin() + in.dst * kBatch, kBatch, in.value);
+    }
+    e.uses_time_ = parser.uses_time;
+    e.uses_region_ = parser.uses_region;
+    return e;
+}
+
+void IntensityExpression::evaluate(double* x, const double* t, const RegionId* region, std::size_t n) const {
+    evaluate(x, t, region, n, *acquire_atlas_snapshot());
+}
+
+void IntensityExpression::evaluate(double* x, const double* t, const RegionId* region, std::size_t n,
+                                   const AtlasSnapshot& snapshot) const {
+    auto reg = [&](std::uint16_t r) { return scratch_.data() + static_cast<std::size_t>(r) * kBatch; };
+    const RegionAtlas& atlas = snapshot.atlas;
+
+    for (std::size_t base = 0; base < n; base += kBatch) {
+        const std::size_t m = std::min(kBatch, n - base);
+        for (const auto& in : code_) {
+            double* d = reg(in.dst);
+            const double* a = reg(in.a);
+            const double* b = reg(in.b);
+            switch (in.op) {
+                case Op::Const: break;
+                case Op::Var:
+                    if (in.a == X) {
+                        std::copy(x + base, x + base + m, d);
+                    } else if (in.a == T) {
+                        if (t) std::copy(t + base, t + base + m, d);
+                        else std::fill(d, d + m, 0.0);
+                    } else {
+                        for (std::size_t j = 0; j < m; ++j) {
+                            d[j] = region_value(atlas, region ? region[base + j] : kNoRegion, static_cast<Var>(in.a));
+                        }
+                    }
+                    break;
+                case Op::Add: for (std::size_t j = 0; j < m; ++j) d[j] = a[j] + b[j]; break;
+                case Op::Sub: for (std::size_t j = 0; j < m; ++j) d[j] = a[j] - b[j]; break;
+                case Op::Mul: for (std::size_t j = 0; j < m; ++j) d[j] = a[j] * b[j]; break;
+                case Op::Div: for (std::size_t j = 0; j < m; ++j) d[j] = a[j] / b[j]; break;
+                case Op::Neg: for (std::size_t j = 0; j < m; ++j) d[j] = -a[j]; break;
+                case Op::Pow: map2(d, a, b, m, [](double u, double v) { return std::pow(u, v); }); break;
+                case Op::Sin: map1(d, a, m, [](double u) { return std::sin(u); }); break;
+                case Op::Cos: map1(d, a, m, [](double u) { return std::cos(u); }); break;
+                case Op::Tan: map1(d, a, m, [](double u) { return std::tan(u); }); break;
+                case Op::Exp: map1(d, a, m, [](double u) { return std::exp(u); }); break;
+                case Op::Log: map1(d, a, m, [](double u) { return std::log(u); }); break;
+                case Op::Sqrt: map1(d, a, m, [](double u) { return std::sqrt(u); }); break;
+                case Op::Abs: map1(d, a, m, [](double u) { return std::abs(u); }); break;
+                case Op::Floor: map1(d, a, m, [](double u) { return std::floor(u); }); break;
+                case Op::Min: map2(d, a, b, m, [](double u, double v) { return std::min(u, v); }); break;
+                case Op::Max: map2(d, a, b, m, [](double u, double v) { return std::max(u, v); }); break;
+                case Op::Clamp: {
+                    const double* c = reg(in.c);
+                    for (std::size_t j = 0; j < m; ++j) d[j] = std::max(b[j], std::min(c[j], a[j]));
+                    break;
+                }
+            }
+        }
+        const double* out = reg(result_);
+        std::copy(out, out + m, x + base);
+    }
+}
+
+double IntensityExpression::evaluate(double x, double t, RegionId region) const {
+    evaluate(&x, &t, &region, 1);
+    return x;
+}
+
+}
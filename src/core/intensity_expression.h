@@ -0,0 +1,75 @@
+#pragma once
+
+#include "core/atlas_core.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cerebra {
+
+// A user formula for `intensity_transform`, e.g.
+//   clamp(0.5*x^2 + 0.2*sin(t*pi), 0, 1)
+// compiled once into register bytecode (constant subexpressions folded) and
+// run over columns a batch at a time, so each instruction is dispatched once
+// per batch rather than once per element.
+//
+// The registers live in a scratch buffer owned by the expression and reused
+// by every evaluate(), so one expression must not be evaluated from two
+// threads at once; give each thread its own copy.
+//
+// Variables: x (or intensity), t (or time, in seconds), and the region's
+// atlas metadata depth, slice_x, slice_y, proj_x, proj_y, proj_z and roi
+// (1 for a region of interest). Constants: pi, e. Operators: + - * / ^
+// (right-associative) and unary minus. Functions: sin cos tan exp log sqrt
+// abs floor, min max pow (two arguments), clamp (three).
+class IntensityExpression {
+public:
+    // Throws std::runtime_error naming the offending column on a syntax
+    // error, unknown name, wrong argument count or excessive nesting, and
+    // when the expression needs more registers than an instruction can name.
+    static IntensityExpression compile(std::string_view source);
+
+    const std::string& source() const { return source_; }
+    bool uses_time() const { return uses_time_; }
+    bool uses_region() const { return uses_region_; }
+    std::size_t instruction_count() const { return code_.size(); }
+
+    // x[j] = f(x[j], t[j], region[j]) for j < n. `t` and `region` may be
+    // null when the expression does not use them (t then reads as 0). The
+    // second form reads metadata from `atlas`, which the ids must belong to;
+    // the first uses the current atlas.
+    void evaluate(double* x, const double* t, const RegionId* region, std::size_t n) const;
+    void evaluate(double* x, const double* t, const RegionId* region, std::size_t n,
+                  const AtlasSnapshot& atlas) const;
+    double evaluate(double x, double t = 0.0, RegionId region = kNoRegion) const;
+
+    enum class Op : std::uint8_t {
+        Const, Var,
+        Neg, Add, Sub, Mul, Div, Pow,
+        Sin, Cos, Tan, Exp, Log, Sqrt, Abs, Floor,
+        Min, Max, Clamp,
+    };
+
+    // One register-to-register instruction; register `dst` is written once.
+    struct Instruction {
+        Op op;
+        std::uint16_t dst = 0;
+        std::uint16_t a = 0, b = 0, c = 0;  // operand registers; `a` is the variable for Var
+        double value = 0.0;                  // for Const
+    };
+
+private:
+    std::string source_;
+    std::vector<Instruction> code_;
+    std::size_t registers_ = 0;
+    std::uint16_t result_ = 0;
+    // registers_ batches; constant registers are filled once, at compile time.
+    mutable std::vector<double> scratch_;
+    bool uses_time_ = false;
+    bool uses_region_ = false;
+};
+
+}
@@ -0,0 +1,256 @@
+#include "core/intensity_kernels.h"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define CEREBRA_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace cerebra {
+
+namespace {
+
+constexpr long double kPi = 3.141592653589793238462643383279502884L;
+
+// sin(pi r) = sum_j (-1)^j (pi r)^(2j+1) / (2j+1)!, as coefficients of r^(2j+1).
+constexpr std::array<double, 11> sin_pi_coefficients() {
+    std::array<double, 11> c{};
+    long double term = kPi;
+    for (std::size_t j = 0; j < c.size(); ++j) {
+        c[j] = static_cast<double>(term);
+        term *= -kPi * kPi / static_cast<long double>((2 * j + 2) * (2 * j + 3));
+    }
+    return c;
+}
+
+// e^r = sum_j r^j / j!.
+constexpr std::array<double, 14> exp_coefficients() {
+    std::array<double, 14> c{};
+    long double term = 1.0L;
+    for (std::size_t j = 0; j < c.size(); ++j) {
+        c[j] = static_cast<double>(term);
+        term /= static_cast<long double>(j + 1);
+    }
+    return c;
+}
+
+constexpr auto kSinPi = sin_pi_coefficients();
+constexpr auto kExp = exp_coefficients();
+
+// Adding 1.5 * 2^52 rounds to the nearest integer (ties to even) and leaves
+// that integer, as two's complement, in the low mantissa bits.
+constexpr double kRoundMagic = 6755399441055744.0;
+constexpr double kLog2e = 1.44269504088896340736;
+constexpr double kLn2Hi = 6.93147180369123816490e-01;  // low 32 bits zero: k * hi is exact
+constexpr double kLn2Lo = 1.90821492927058770002e-10;
+constexpr double kExpMin = -708.0;
+constexpr double kExpMax = 709.0;
+constexpr double kEMinus1 = 1.71828182845904523536;
+
+std::uint64_t bits_of(double v) {
+    std::uint64_t b;
+    std::memcpy(&b, &v, sizeof b);
+    return b;
+}
+
+double from_bits(std::uint64_t b) {
+    double v;
+    std::memcpy(&v, &b, sizeof v);
+    return v;
+}
+
+// The scalar kernel. The SIMD kernels below perform the same operations in
+// the same order (and without FMA), so every path rounds identically.
+double transform_one(IntensityTransform t, double v) {
+    switch (t) {
+        case IntensityTransform::Square: return v * v;
+        case IntensityTransform::Sqrt: return std::sqrt(v);
+        case IntensityTransform::Sin: return (fast_sin_pi(v) + 1.0) * 0.5;
+        case IntensityTransform::Exp: return (fast_exp(v) - 1.0) / kEMinus1;
+        case IntensityTransform::Identity: break;
+    }
+    return v;
+}
+
+void scalar_kernel(IntensityTransform t, double* v, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) v[i] = transform_one(t, v[i]);
+}
+
+#ifdef CEREBRA_X86_KERNELS
+
+// --- SSE2: two lanes, available on every x86-64 -------------------------
+
+__m128d sin_pi_sse2(__m128d x) {
+    const __m128d magic = _mm_set1_pd(kRoundMagic);
+    __m128d t = _mm_add_pd(x, magic);
+    __m128d r = _mm_sub_pd(x, _mm_sub_pd(t, magic));
+    __m128d r2 = _mm_mul_pd(r, r);
+    __m128d p = _mm_set1_pd(kSinPi[kSinPi.size() - 1]);
+    for (std::size_t j = kSinPi.size() - 1; j-- > 0;) p = _mm_add_pd(_mm_mul_pd(p, r2), _mm_set1_pd(kSinPi[j]));
+    __m128d s = _mm_mul_pd(r, p);
+    // Odd integer part: sin(pi (n + r)) = -sin(pi r).
+    __m128i sign = _mm_slli_epi64(_mm_castpd_si128(t), 63);
+    return _mm_xor_pd(s, _mm_castsi128_pd(sign));
+}
+
+__m128d exp_sse2(__m128d in) {
+    const __m128d magic = _mm_set1_pd(kRoundMagic);
+    const __m128d x = _mm_max_pd(_mm_min_pd(in, _mm_set1_pd(kExpMax)), _mm_set1_pd(kExpMin));
+    __m128d t = _mm_add_pd(_mm_mul_pd(x, _mm_set1_pd(kLog2e)), magic);
+    __m128d k = _mm_sub_pd(t, magic);
+    __m128d r = _mm_sub_pd(_mm_sub_pd(x, _mm_mul_pd(k, _mm_set1_pd(kLn2Hi))), _mm_mul_pd(k, _mm_set1_pd(kLn2Lo)));
+    __m128d p = _mm_set1_pd(kExp[kExp.size() - 1]);
+    for (std::size_t j = kExp.size() - 1; j-- > 0;) p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(kExp[j]));
+    __m128i ki = _mm_sub_epi64(_mm_castpd_si128(t), _mm_castpd_si128(magic));
+    const __m128d e = _mm_castsi128_pd(_mm_add_epi64(_mm_castpd_si128(p), _mm_slli_epi64(ki, 52)));
+    // The clamp turns NaN into a bound; hand NaN lanes back unchanged.
+    const __m128d nan = _mm_cmpunord_pd(in, in);
+    return _mm_or_pd(_mm_and_pd(nan, in), _mm_andnot_pd(nan, e));
+}
+
+void sse2_kernel(IntensityTransform t, double* v, std::size_t n) {
+    const __m128d one = _mm_set1_pd(1.0);
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d x = _mm_loadu_pd(v + i);
+        switch (t) {
+            case IntensityTransform::Square: x = _mm_mul_pd(x, x); break;
+            case IntensityTransform::Sqrt: x = _mm_sqrt_pd(x); break;
+            case IntensityTransform::Sin: x = _mm_mul_pd(_mm_add_pd(sin_pi_sse2(x), one), _mm_set1_pd(0.5)); break;
+            case IntensityTransform::Exp: x = _mm_div_pd(_mm_sub_pd(exp_sse2(x), one), _mm_set1_pd(kEMinus1)); break;
+            case IntensityTransform::Identity: return;
+        }
+        _mm_storeu_pd(v + i, x);
+    }
+    scalar_kernel(t, v + i, n - i);
+}
+
+// --- AVX2: four lanes, compiled in regardless of -march and only called
+// once the CPU has been checked for it ------------------------------------
+
+#define CEREBRA_AVX2 __attribute__((target("avx2")))
+
+CEREBRA_AVX2 __m256d sin_pi_avx2(__m256d x) {
+    const __m256d magic = _mm256_set1_pd(kRoundMagic);
+    __m256d t = _mm256_add_pd(x, magic);
+    __m256d r = _mm256_sub_pd(x, _mm256_sub_pd(t, magic));
+    __m256d r2 = _mm256_mul_pd(r, r);
+    __m256d p = _mm256_set1_pd(kSinPi[kSinPi.size() - 1]);
+    for (std::size_t j = kSinPi.size() - 1; j-- > 0;) {
+        p = _mm256_add_pd(_mm256_mul_pd(p, r2), _mm256_set1_pd(kSinPi[j]));
+    }
+    __m256d s = _mm256_mul_pd(r, p);
+    __m256i sign = _mm256_slli_epi64(_mm256_castpd_si256(t), 63);
+    return _mm256_xor_pd(s, _mm256_castsi256_pd(sign));
+}
+
+CEREBRA_AVX2 __m256d exp_avx2(__m256d in) {
+    const __m256d magic = _mm256_set1_pd(kRoundMagic);
+    const __m256d x = _mm256_max_pd(_mm256_min_pd(in, _mm256_set1_pd(kExpMax)), _mm256_set1_pd(kExpMin));
+    __m256d t = _mm256_add_pd(_mm256_mul_pd(x, _mm256_set1_pd(kLog2e)), magic);
+    __m256d k = _mm256_sub_pd(t, magic);
+    __m256d r = _mm256_sub_pd(_mm256_sub_pd(x, _mm256_mul_pd(k, _mm256_set1_pd(kLn2Hi))),
+                              _mm256_mul_pd(k, _mm256_set1_pd(kLn2Lo)));
+    __m256d p = _mm256_set1_pd(kExp[kExp.size() - 1]);
+    for (std::size_t j = kExp.size() - 1; j-- > 0;) {
+        p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(kExp[j]));
+    }
+    __m256i ki = _mm256_sub_epi64(_mm256_castpd_si256(t), _mm256_castpd_si256(magic));
+    const __m256d e = _mm256_castsi256_pd(_mm256_add_epi64(_mm256_castpd_si256(p), _mm256_slli_epi64(ki, 52)));
+    return _mm256_blendv_pd(e, in, _mm256_cmp_pd(in, in, _CMP_UNORD_Q));
+}
+
+CEREBRA_AVX2 void avx2_kernel(IntensityTransform t, double* v, std::size_t n) {
+    const __m256d one = _mm256_set1_pd(1.0);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(v + i);
+        switch (t) {
+            case IntensityTransform::Square: x = _mm256_mul_pd(x, x); break;
+            case IntensityTransform::Sqrt: x = _mm256_sqrt_pd(x); break;
+            case IntensityTransform::Sin:
+                x = _mm256_mul_pd(_mm256_add_pd(sin_pi_avx2(x), one), _mm256_set1_pd(0.5));
+                break;
+            case IntensityTransform::Exp:
+                x = _mm256_div_pd(_mm256_sub_pd(exp_avx2(x), one), _mm256_set1_pd(kEMinus1));
+                break;
+            case IntensityTransform::Identity: return;
+        }
+        _mm256_storeu_pd(v + i, x);
+    }
+    scalar_kernel(t, v + i, n - i);
+}
+
+#undef CEREBRA_AVX2
+
+#endif
+
+using Kernel = void (*)(IntensityTransform, double*, std::size_t);
+
+struct KernelChoice {
+    Kernel kernel;
+    const char* isa;
+};
+
+const KernelChoice& kernel_choice() {
+    static const KernelChoice choice = [] {
+#ifdef CEREBRA_X86_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return KernelChoice{avx2_kernel, "avx2"};
+        return KernelChoice{sse2_kernel, "sse2"};
+#else
+        return KernelChoice{scalar_kernel, "scalar"};
+#endif
+    }();
+    return choice;
+}
+
+}
+
+IntensityTransform parse_intensity_transform(std::string_view name) {
+    if (name == "square") return IntensityTransform::Square;
+    if (name == "sqrt") return IntensityTransform::Sqrt;
+    if (name == "sin") return IntensityTransform::Sin;
+    if (name == "exp") return IntensityTransform::Exp;
+    return IntensityTransform::Identity;
+}
+
+double fast_sin_pi(double x) {
+    const double t = x + kRoundMagic;
+    const double r = x - (t - kRoundMagic);
+    const double r2 = r * r;
+    double p = kSinPi[kSinPi.size() - 1];
+    for (std::size_t j = kSinPi.size() - 1; j-- > 0;) p = p * r2 + kSinPi[j];
+    return from_bits(bits_of(r * p) ^ (bits_of(t) << 63));
+}
+
+double fast_exp(double x) {
+    if (std::isnan(x)) return x;
+    x = x < kExpMax ? x : kExpMax;
+    x = x > kExpMin ? x : kExpMin;
+    const double t = x * kLog2e + kRoundMagic;
+    const double k = t - kRoundMagic;
+    const double r = (x - k * kLn2Hi) - k * kLn2Lo;
+    double p = kExp[kExp.size() - 1];
+    for (std::size_t j = kExp.size() - 1; j-- > 0;) p = p * r + kExp[j];
+    const std::uint64_t ki = bits_of(t) - bits_of(kRoundMagic);
+    return from_bits(bits_of(p) + (ki << 52));
+}
+
+void apply_intensity_transform(IntensityTransform t, double* v, std::size_t n) {
+    if (t == IntensityTransform::Identity) return;
+    kernel_choice().kernel(t, v, n);
+}
+
+void apply_intensity_transform_scalar(IntensityTransform t, double* v, std::size_t n) {
+    if (t == IntensityTransform::Identity) return;
+    scalar_kernel(t, v, n);
+}
+
+const char* intensity_kernel_isa() { return kernel_choice().isa; }
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace cerebra {
+
+// The `intensity_transform` options, resolved once from their config name.
+enum class IntensityTransform { Identity, Square, Sqrt, Sin, Exp };
+
+// Unknown names (including "linear") resolve to Identity.
+IntensityTransform parse_intensity_transform(std::string_view name);
+
+// Polynomial stand-ins for the libm calls the transforms need, shared by
+// every kernel so all instruction sets give bit-identical results.
+//
+// fast_sin_pi(x) ~ sin(pi * x): x is reduced to r in [-1/2, 1/2] around the
+// nearest integer and sin(pi * r) summed as a degree-21 odd Taylor
+// polynomial (truncation < 2e-18). Absolute error is within 4e-16 for
+// |x| < 2^51; larger arguments are outside the domain.
+double fast_sin_pi(double x);
+
+// fast_exp(x) ~ e^x: x = k ln 2 + r with |r| <= ln(2)/2 (Cody-Waite split),
+// e^r as a degree-13 Taylor polynomial (truncation < 5e-18), then scaled by
+// 2^k through the exponent bits. Relative error is within 3e-16; x is
+// clamped to [-708, 709], so no subnormal or infinite results.
+double fast_exp(double x);
+
+// Apply `t` to v[0, n) in place with the widest kernel this CPU supports.
+void apply_intensity_transform(IntensityTransform t, double* v, std::size_t n);
+
+// The same, forcing the portable kernel (for comparison and testing).
+void apply_intensity_transform_scalar(IntensityTransform t, double* v, std::size_t n);
+
+// "avx2", "sse2" or "scalar": the kernel apply_intensity_transform picked.
+const char* intensity_kernel_isa();
+
+}
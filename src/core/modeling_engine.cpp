@@ -1,121 +1,44 @@
 #include "modeling_engine.h"
-#include <cmath>
-#include <algorithm>
-#include <numeric>
-#include <ctime>
-#include <cstdlib>
+#include "core/modeling_pipeline.h"
+#include <utility>
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
-
-#ifndef M_E
-#define M_E 2.71828182845904523536
-#endif
+// Each apply* below is a one-stage ModelingPipeline; ModelingPipeline::from_config
+// fuses the enabled ones into a single pass.
+static void runStage(std::vector<cerebra::BrainFrame>& frames,
+                     std::unique_ptr<cerebra::ModelingStage> stage) {
+    cerebra::ModelingPipeline().add(std::move(stage)).run(frames);
+}
 
 void applyTemporalSmoothing(std::vector<cerebra::BrainFrame>& frames, int window_size) {
-    if (frames.size() < 2 || window_size < 2) return;
-    for (size_t i = 0; i < frames.size(); ++i) {
-        for (size_t r = 0; r < frames[i].regions.size(); ++r) {
-            double sum = 0;
-            int count = 0;
-            for (int j = -(window_size / 2); j <= (window_size / 2); ++j) {
-                int idx = (int)i + j;
-                if (idx >= 0 && idx < (int)frames.size()) {
-                    sum += frames[idx].regions[r].intensity;
-                    count++;
-                }
-            }
-            frames[i].regions[r].intensity = sum / count;
-        }
-    }
+    runStage(frames, cerebra::make_temporal_smoothing_stage(window_size));
 }
 
 void applyActivityDecayModel(std::vector<cerebra::BrainFrame>& frames, double decay_rate) {
-    for (size_t i = 1; i < frames.size(); ++i) {
-        double dt = (frames[i].timestamp_ms - frames[i - 1].timestamp_ms) / 1000.0;
-        for (size_t r = 0; r < frames[i].regions.size(); ++r) {
-            frames[i].regions[r].intensity *= std::exp(-decay_rate * dt);
-        }
-    }
+    runStage(frames, cerebra::make_activity_decay_stage(decay_rate));
 }
 
 void applySynapticDelaySimulation(std::vector<cerebra::BrainFrame>& frames, int delay_frames) {
-    if (delay_frames <= 0) return;
-    for (int i = (int)frames.size() - 1; i >= delay_frames; --i) {
-        for (size_t r = 0; r < frames[i].regions.size(); ++r) {
-            frames[i].regions[r].intensity = frames[i - delay_frames].regions[r].intensity;
-        }
-    }
-    for (int i = 0; i < std::min((int)frames.size(), delay_frames); ++i) {
-        for (auto& reg : frames[i].regions) reg.intensity = 0;
-    }
+    runStage(frames, cerebra::make_synaptic_delay_stage(delay_frames));
 }
 
 void applyRefractoryPeriodLogic(std::vector<cerebra::BrainFrame>& frames, int period_ms) {
-    std::map<size_t, int> last_fire;
-    for (size_t i = 0; i < frames.size(); ++i) {
-        for (size_t r = 0; r < frames[i].regions.size(); ++r) {
-            if (frames[i].regions[r].intensity > 0.8) {
-                if (last_fire.count(r) && (frames[i].timestamp_ms - last_fire[r]) < period_ms) {
-                    frames[i].regions[r].intensity *= 0.1;
-                } else {
-                    last_fire[r] = frames[i].timestamp_ms;
-                }
-            }
-        }
-    }
+    runStage(frames, cerebra::make_refractory_stage(period_ms));
 }
 
 void applyStochasticModeling(std::vector<cerebra::BrainFrame>& frames, double noise_amplitude) {
-    static bool seeded = false;
-    if (!seeded) { std::srand(std::time(nullptr)); seeded = true; }
-    for (auto& f : frames) {
-        for (auto& r : f.regions) {
-            double noise = ((double)std::rand() / RAND_MAX * 2.0 - 1.0) * noise_amplitude;
-            r.intensity = std::max(0.0, std::min(1.0, r.intensity + noise));
-        }
-    }
+    runStage(frames, cerebra::make_stochastic_stage(noise_amplitude));
 }
 
 void applyCustomMathematicalFunctions(std::vector<cerebra::BrainFrame>& frames, const std::string& transform) {
-    for (auto& f : frames) {
-        for (auto& r : f.regions) {
-            if (transform == "square") r.intensity = r.intensity * r.intensity;
-            else if (transform == "sqrt") r.intensity = std::sqrt(r.intensity);
-            else if (transform == "sin") r.intensity = (std::sin(r.intensity * M_PI) + 1.0) / 2.0;
-            else if (transform == "exp") r.intensity = (std::exp(r.intensity) - 1.0) / (M_E - 1.0);
-        }
-    }
+    runStage(frames, cerebra::make_transform_stage(transform));
 }
 
 void applyNeurotransmitterSimulation(std::vector<cerebra::BrainFrame>& frames) {
-    for (auto& f : frames) {
-        for (auto& r : f.regions) {
-            double glutamate = 0;
-            double gaba = 0;
-            for (const auto& flow : r.flows) {
-                if (flow.type == "glutamate") glutamate += flow.rate;
-                else if (flow.type == "gaba") gaba += flow.rate;
-            }
-            r.intensity *= (1.0 + glutamate - gaba);
-            r.intensity = std::max(0.0, std::min(1.0, r.intensity));
-        }
-    }
+    runStage(frames, cerebra::make_neurotransmitter_stage());
 }
 
 void applyLongTermPotentiation(std::vector<cerebra::BrainFrame>& frames, double threshold, double increment) {
-    if (frames.empty()) return;
-    std::vector<double> plasticity(frames[0].regions.size(), 1.0);
-    for (size_t i = 1; i < frames.size(); ++i) {
-        for (size_t r = 0; r < frames[i].regions.size(); ++r) {
-            if (frames[i].regions[r].intensity > threshold && frames[i-1].regions[r].intensity > threshold) {
-                if (r < plasticity.size()) plasticity[r] += increment;
-            }
-            if (r < plasticity.size()) frames[i].regions[r].intensity *= plasticity[r];
-            frames[i].regions[r].intensity = std::max(0.0, std::min(1.0, frames[i].regions[r].intensity));
-        }
-    }
+    runStage(frames, cerebra::make_ltp_stage(threshold, increment));
 }
 
 std::vector<cerebra::BrainFrame> getBrainStateTemplate(const std::string& state) {
@@ -135,6 +58,16 @@ std::vector<cerebra::BrainFrame> getBrainStateTemplate(const std::string& state)
     return frames;
 }
 
-void processHierarchicalRegions(std::vector<cerebra::BrainFrame>& /*frames*/) {
-    // No-op
+void processHierarchicalRegions(std::vector<cerebra::BrainFrame>& frames) {
+    // Roll each parcellation up into its parent region: internal subregions
+    // take the mean of their children, and the region the mean of its
+    // top-level subregions.
+    for (auto& f : frames) {
+        for (auto& r : f.regions) {
+            if (!r.has_detail() || r.detail().subregions.empty()) continue;
+            cerebra::RegionTree& tree = r.mutable_detail().subregions;
+            tree.roll_up_child_means();
+            r.intensity = tree.root_mean(r.intensity);
+        }
+    }
 }
@@ -0,0 +1,669 @@
+#include "core/modeling_pipeline.h"
+#include "core/intensity_expression.h"
+#include "core/intensity_kernels.h"
+#include "core/pathway_network.h"
+#include "core/random.h"
+#include "core/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <unordered_map>
+#include <utility>
+
+namespace cerebra {
+
+namespace {
+
+double clamp01(double v) { return std::max(0.0, std::min(1.0, v)); }
+
+bool is_linear_transform(const std::string& transform) { return transform.empty() || transform == "linear"; }
+
+// The id of `rs` in `atlas`: its bound id while that still names the same
+// region, otherwise a lookup by key (states bound against a replaced atlas
+// may carry an id that now belongs to another region).
+RegionId id_in(const RegionState& rs, const RegionAtlas& atlas) {
+    const RegionDefinition* def = atlas.at(rs.region_id);
+    if (def && def->id == rs.region) return rs.region_id;
+    return atlas.id_of(rs.region);
+}
+
+// A stage whose regions evolve independently. prepare() runs on the calling
+// thread and sizes any per-region state for the block; the block is then
+// handed out by region range, each range walking its frames in order, so a
+// region's result is the same however the ranges fall.
+class RegionParallelStage : public ModelingStage {
+public:
+    void set_parallelism(ThreadPool* pool, std::size_t max_tasks) override {
+        pool_ = pool;
+        max_tasks_ = max_tasks;
+    }
+
+    void process(FrameWindow& frames, std::size_t begin, std::size_t end) final {
+        if (begin >= end) return;
+        atlas_ = acquire_atlas_snapshot();
+        std::size_t width = 0;
+        for (std::size_t i = begin; i < end; ++i) width = std::max(width, frames[i].regions.size());
+        prepare(frames, begin, end, width);
+        auto run = [&](std::size_t r_begin, std::size_t r_end) {
+            process_regions(frames, begin, end, r_begin, r_end);
+        };
+        if (pool_ && max_tasks_ > 1) {
+            pool_->parallel_for(width, kRegionsPerTask, max_tasks_, run);
+        } else {
+            run(0, width);
+        }
+        finish(frames, begin, end);
+        atlas_ = nullptr;
+    }
+
+protected:
+    // Fewer regions than this per task and the hand-off costs more than the work.
+    static constexpr std::size_t kRegionsPerTask = 16;
+
+    // The atlas snapshot held for the whole block, shared by every worker so
+    // none of them takes its own reference per region.
+    const AtlasSnapshot& atlas() const { return *atlas_; }
+
+    // The most process_regions calls one block can be split into.
+    std::size_t task_limit() const { return pool_ && max_tasks_ > 1 ? max_tasks_ : 1; }
+
+    virtual void prepare(FrameWindow& /*frames*/, std::size_t /*begin*/, std::size_t /*end*/,
+                         std::size_t /*width*/) {}
+    // Regions [r_begin, r_end) of frames [begin, end); frames with fewer
+    // regions just contribute fewer.
+    virtual void process_regions(FrameWindow& frames, std::size_t begin, std::size_t end,
+                                 std::size_t r_begin, std::size_t r_end) = 0;
+    virtual void finish(FrameWindow& /*frames*/, std::size_t /*begin*/, std::size_t /*end*/) {}
+
+private:
+    ThreadPool* pool_ = nullptr;
+    std::size_t max_tasks_ = 1;
+    std::shared_ptr<const AtlasSnapshot> atlas_;
+};
+
+// Centered moving average over the incoming (unsmoothed) intensities of
+// frames [i - half, i + half], matched by region identity rather than by
+// position. Each region keeps a running sum and count, and every frame's raw
+// values are remembered until they leave the window, so the cost per frame is
+// O(regions) whatever the window size.
+class TemporalSmoothingStage : public ModelingStage {
+public:
+    explicit TemporalSmoothingStage(int window) : half_(window >= 2 ? window / 2 : 0) {}
+
+    const char* name() const override { return "temporal_smoothing"; }
+    std::size_t lookahead() const override { return half_; }
+    void reset() override {
+        window_.assign(2 * half_ + 1, {});
+        sum_.clear();
+        count_.clear();
+        slot_by_id_.clear();
+        slot_by_key_.clear();
+        atlas_ = nullptr;
+        ingested_ = 0;
+    }
+
+    void process(FrameWindow& frames, std::size_t begin, std::size_t end) override {
+        if (half_ == 0) return;
+        if (window_.size() != 2 * half_ + 1) reset();
+        bind(acquire_atlas_snapshot());
+        for (std::size_t i = begin; i < end; ++i) {
+            // Drop the frame that fell out behind (its ring slot is the one
+            // frame i + half reuses), then bring frames up to i + half into the
+            // window; their values are still untouched by this stage.
+            if (i > half_) evict(i - half_ - 1);
+            for (std::size_t last = std::min(frames.size(), i + half_ + 1); ingested_ < last; ++ingested_) {
+                ingest(frames[ingested_], ingested_);
+            }
+
+            // The row for frame i was captured on ingest, so overwriting the
+            // frame cannot leak into any other frame's average.
+            const auto& row = window_[i % window_.size()];
+            for (std::size_t r = 0; r < row.size(); ++r) {
+                frames[i].regions[r].intensity = sum_[row[r].first] / count_[row[r].first];
+            }
+        }
+    }
+
+private:
+    // Ids in slot_by_id_ refer to atlas_. When another atlas is current, the
+    // slots move over to slot_by_key_, where the new ids pick them up again.
+    void bind(std::shared_ptr<const AtlasSnapshot> atlas) {
+        if (atlas_ && atlas_ != atlas) {
+            for (std::size_t id = 0; id < slot_by_id_.size(); ++id) {
+                if (slot_by_id_[id] != kNoSlot) slot_by_key_.emplace(atlas_->atlas.regions()[id].id, slot_by_id_[id]);
+            }
+            slot_by_id_.clear();
+        }
+        atlas_ = std::move(atlas);
+    }
+
+    std::size_t slot_for(const RegionState& rs) {
+        const RegionId id = id_in(rs, atlas_->atlas);
+        if (id != kNoRegion) {
+            if (id >= slot_by_id_.size()) slot_by_id_.resize(id + 1, kNoSlot);
+            if (slot_by_id_[id] == kNoSlot) {
+                auto it = slot_by_key_.find(rs.region);
+                slot_by_id_[id] = it != slot_by_key_.end() ? it->second : new_slot();
+            }
+            return slot_by_id_[id];
+        }
+        auto it = slot_by_key_.find(rs.region);
+        if (it != slot_by_key_.end()) return it->second;
+        return slot_by_key_.emplace(rs.region, new_slot()).first->second;
+    }
+
+    std::size_t new_slot() {
+        sum_.push_back(0.0);
+        count_.push_back(0);
+        return sum_.size() - 1;
+    }
+
+    void ingest(const BrainFrame& frame, std::size_t index) {
+        auto& row = window_[index % window_.size()];
+        row.clear();
+        for (const auto& rs : frame.regions) {
+            std::size_t slot = slot_for(rs);
+            row.emplace_back(slot, rs.intensity);
+            sum_[slot] += rs.intensity;
+            ++count_[slot];
+        }
+    }
+
+    void evict(std::size_t index) {
+        for (const auto& [slot, value] : window_[index % window_.size()]) {
+            sum_[slot] -= value;
+            --count_[slot];
+        }
+    }
+
+    static constexpr std::size_t kNoSlot = static_cast<std::size_t>(-1);
+
+    std::size_t half_;
+    // Raw (slot, intensity) rows of the frames in the window, one per region
+    // of the frame in order; indexed by frame % (2 * half_ + 1).
+    std::vector<std::vector<std::pair<std::size_t, double>>> window_;
+    std::vector<double> sum_;   // per slot, over the window
+    std::vector<int> count_;    // per slot, frames in the window reporting it
+    std::vector<std::size_t> slot_by_id_;  // by RegionId in atlas_
+    std::unordered_map<std::string, std::size_t> slot_by_key_;
+    std::shared_ptr<const AtlasSnapshot> atlas_;
+    std::size_t ingested_ = 0;  // frames [0, ingested_) have entered the window
+};
+
+class ActivityDecayStage : public RegionParallelStage {
+public:
+    explicit ActivityDecayStage(double rate) : rate_(rate) {}
+
+    const char* name() const override { return "activity_decay"; }
+
+protected:
+    void prepare(FrameWindow& frames, std::size_t begin, std::size_t end, std::size_t) override {
+        factor_.assign(end - begin, 1.0);  // the first frame is left as is
+        for (std::size_t i = begin; i < end; ++i) {
+            if (i > 0) factor_[i - begin] = std::exp(-rate_ * ((frames[i].timestamp_ms - previous_ms_) / 1000.0));
+            previous_ms_ = frames[i].timestamp_ms;
+        }
+    }
+
+    void process_regions(FrameWindow& frames, std::size_t begin, std::size_t end,
+                         std::size_t r_begin, std::size_t r_end) override {
+        for (std::size_t i = begin; i < end; ++i) {
+            auto& regions = frames[i].regions;
+            const double factor = factor_[i - begin];
+            for (std::size_t r = r_begin; r < std::min(r_end, regions.size()); ++r) regions[r].intensity *= factor;
+        }
+    }
+
+private:
+    double rate_;
+    std::vector<double> factor_;  // per frame of the block
+    std::int64_t previous_ms_ = 0;  // timestamp of the last frame prepared
+};
+
+// Each frame takes the intensities that arrived `delay` frames earlier; the
+// first `delay` frames go silent.
+class SynapticDelayStage : public ModelingStage {
+public:
+    explicit SynapticDelayStage(int delay) : delay_(delay > 0 ? static_cast<std::size_t>(delay) : 0) {}
+
+    const char* name() const override { return "synaptic_delay"; }
+    void reset() override { pending_.assign(delay_, {}); }
+
+    void process(FrameWindow& frames, std::size_t begin, std::size_t end) override {
+        if (delay_ == 0) return;
+        if (pending_.size() != delay_) reset();
+        for (std::size_t i = begin; i < end; ++i) {
+            auto& regions = frames[i].regions;
+            std::vector<double>& slot = pending_[i % delay_];
+            std::vector<double> incoming(regions.size());
+            for (std::size_t r = 0; r < regions.size(); ++r) incoming[r] = regions[r].intensity;
+            for (std::size_t r = 0; r < regions.size(); ++r) {
+                regions[r].intensity = (i >= delay_ && r < slot.size()) ? slot[r] : 0.0;
+            }
+            slot.swap(incoming);
+        }
+    }
+
+private:
+    std::size_t delay_;
+    std::vector<std::vector<double>> pending_;  // incoming rows of the last delay_ frames
+};
+
+// Propagates each frame's activity along the active PathwayCatalog, one
+// network step per frame; the catalog is compiled afresh for every run.
+// Regions a frame does not report still relay activity, but only reported
+// regions are written back.
+class PathwayStage : public ModelingStage {
+public:
+    PathwayStage(double coupling, std::int64_t step_ms) : coupling_(coupling), step_ms_(step_ms) {}
+
+    const char* name() const override { return "pathway_propagation"; }
+    void reset() override { network_ = nullptr; }
+
+    void process(FrameWindow& frames, std::size_t begin, std::size_t end) override {
+        if (!network_) network_ = std::make_unique<PathwayNetwork>(PathwayCatalog::all(), step_ms_, coupling_);
+        const std::size_t nodes = network_->node_count();
+        const RegionAtlas& atlas = network_->atlas();
+        for (std::size_t i = begin; i < end; ++i) {
+            auto& regions = frames[i].regions;
+            node_.resize(regions.size());
+            activity_.assign(nodes, 0.0);
+            for (std::size_t k = 0; k < regions.size(); ++k) {
+                const RegionState& r = regions[k];
+                node_[k] = id_in(r, atlas);
+                if (node_[k] < nodes) activity_[node_[k]] = r.intensity;
+            }
+            network_->step(activity_);
+            for (std::size_t k = 0; k < regions.size(); ++k) {
+                if (node_[k] < nodes) regions[k].intensity = activity_[node_[k]];
+            }
+        }
+    }
+
+private:
+    double coupling_;
+    std::int64_t step_ms_;
+    std::unique_ptr<PathwayNetwork> network_;
+    std::vector<double> activity_;  // per atlas region
+    std::vector<RegionId> node_;    // per region of the current frame
+};
+
+// A region firing (>0.8) again within `period` of its last accepted firing
+// is damped to a tenth.
+class RefractoryStage : public RegionParallelStage {
+public:
+    explicit RefractoryStage(int period_ms) : period_ms_(period_ms) {}
+
+    const char* name() const override { return "refractory"; }
+    void reset() override { last_fire_.clear(); }
+
+protected:
+    void prepare(FrameWindow&, std::size_t, std::size_t, std::size_t width) override {
+        if (last_fire_.size() < width) last_fire_.resize(width, kNever);
+    }
+
+    void process_regions(FrameWindow& frames, std::size_t begin, std::size_t end,
+                         std::size_t r_begin, std::size_t r_end) override {
+        for (std::size_t i = begin; i < end; ++i) {
+            auto& regions = frames[i].regions;
+            for (std::size_t r = r_begin; r < std::min(r_end, regions.size()); ++r) {
+                if (regions[r].intensity <= 0.8) continue;
+                if (last_fire_[r] != kNever && frames[i].timestamp_ms - last_fire_[r] < period_ms_) {
+                    regions[r].intensity *= 0.1;
+                } else {
+                    last_fire_[r] = frames[i].timestamp_ms;
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr std::int64_t kNever = INT64_MIN;
+    int period_ms_;
+    std::vector<std::int64_t> last_fire_;
+};
+
+// Uniform noise in [-amplitude, amplitude). Region r's noise for frame i is
+// element i of counter stream r under `seed`, so a run is reproducible from
+// its seed however it is blocked, streamed or split across threads.
+class StochasticStage : public RegionParallelStage {
+public:
+    StochasticStage(double amplitude, std::uint64_t seed) : amplitude_(amplitude), seed_(seed) {}
+
+    const char* name() const override { return "stochastic"; }
+
+protected:
+    void process_regions(FrameWindow& frames, std::size_t begin, std::size_t end,
+                         std::size_t r_begin, std::size_t r_end) override {
+        std::vector<double> noise(end - begin);
+        for (std::size_t r = r_begin; r < r_end; ++r) {
+            CounterRng(seed_, r).fill_uniform(begin, noise.data(), noise.size());
+            for (std::size_t i = begin; i < end; ++i) {
+                auto& regions = frames[i].regions;
+                if (r >= regions.size()) continue;
+                regions[r].intensity = clamp01(regions[r].intensity + (noise[i - begin] * 2.0 - 1.0) * amplitude_);
+            }
+        }
+    }
+
+private:
+    double amplitude_;
+    std::uint64_t seed_;
+};
+
+// Resolves the transform once, then runs it as a SIMD kernel over each
+// region range's intensities gathered into one contiguous column.
+class TransformStage : public RegionParallelStage {
+public:
+    explicit TransformStage(IntensityTransform kind) : kind_(kind) {}
+
+    const char* name() const override { return "transform"; }
+
+protected:
+    void process_regions(FrameWindow& frames, std::size_t begin, std::size_t end,
+                         std::size_t r_begin, std::size_t r_end) override {
+        std::vector<double> column;
+        column.reserve((end - begin) * (r_end - r_begin));
+        for (std::size_t i = begin; i < end; ++i) {
+            const auto& regions = frames[i].regions;
+            for (std::size_t r = r_begin; r < std::min(r_end, regions.size()); ++r) {
+                column.push_back(regions[r].intensity);
+            }
+        }
+        apply_intensity_transform(kind_, column.data(), column.size());
+        const double* v = column.data();
+        for (std::size_t i = begin; i < end; ++i) {
+            auto& regions = frames[i].regions;
+            for (std::size_t r = r_begin; r < std::min(r_end, regions.size()); ++r) regions[r].intensity = *v++;
+        }
+    }
+
+private:
+    IntensityTransform kind_;
+};
+
+// Runs a user formula over each region range's intensities, gathered into
+// columns with their frame times and region ids.
+class ExpressionStage : public RegionParallelStage {
+public:
+    explicit ExpressionStage(IntensityExpression expression) : expression_(std::move(expression)) {}
+
+    const char* name() const override { return "transform"; }
+
+protected:
+    // An expression evaluates in its own scratch registers, so every task of
+    // a block gets a copy of its own.
+    void prepare(FrameWindow& /*frames*/, std::size_t /*begin*/, std::size_t /*end*/,
+                 std::size_t /*width*/) override {
+        if (copies_.size() < task_limit()) copies_.resize(task_limit(), expression_);
+        next_copy_.store(0, std::memory_order_relaxed);
+    }
+
+    void process_regions(FrameWindow& frames, std::size_t begin, std::size_t end,
+                         std::size_t r_begin, std::size_t r_end) override {
+        const IntensityExpression& expression = copies_[next_copy_.fetch_add(1, std::memory_order_relaxed)];
+        std::vector<double> x, t;
+        std::vector<RegionId> region;
+        for (std::size_t i = begin; i < end; ++i) {
+            const auto& regions = frames[i].regions;
+            const double seconds = frames[i].timestamp_ms / 1000.0;
+            for (std::size_t r = r_begin; r < std::min(r_end, regions.size()); ++r) {
+                x.push_back(regions[r].intensity);
+                if (expression.uses_time()) t.push_back(seconds);
+                if (expression.uses_region()) region.push_back(id_in(regions[r], atlas().atlas));
+            }
+        }
+        expression.evaluate(x.data(), t.empty() ? nullptr : t.data(), region.empty() ? nullptr : region.data(),
+                            x.size(), atlas());
+        const double* v = x.data();
+        for (std::size_t i = begin; i < end; ++i) {
+            auto& regions = frames[i].regions;
+            for (std::size_t r = r_begin; r < std::min(r_end, regions.size()); ++r) regions[r].intensity = *v++;
+        }
+    }
+
+private:
+    IntensityExpression expression_;
+    std::vector<IntensityExpression> copies_;
+    std::atomic<std::size_t> next_copy_{0};
+};
+
+// Scales each region by its excitatory (glutamate) minus inhibitory (GABA)
+// drive.
+class NeurotransmitterStage : public RegionParallelStage {
+public:
+    const char* name() const override { return "neurotransmitter"; }
+
+protected:
+    void process_regions(FrameWindow& frames, std::size_t begin, std::size_t end,
+                         std::size_t r_begin, std::size_t r_end) override {
+        for (std::size_t i = begin; i < end; ++i) {
+            auto& regions = frames[i].regions;
+            for (std::size_t k = r_begin; k < std::min(r_end, regions.size()); ++k) {
+                auto& r = regions[k];
+                double glutamate = 0;
+                double gaba = 0;
+                for (const auto flow : r.effective_flows(atlas())) {
+                    if (flow.type == "glutamate") glutamate += flow.rate;
+                    else if (flow.type == "gaba") gaba += flow.rate;
+                }
+                r.intensity = clamp01(r.intensity * (1.0 + glutamate - gaba));
+            }
+        }
+    }
+};
+
+// Long-term potentiation: a region above `threshold` in two consecutive
+// frames gains `increment` plasticity, which scales it from then on.
+class LtpStage : public RegionParallelStage {
+public:
+    LtpStage(double threshold, double increment) : threshold_(threshold), increment_(increment) {}
+
+    const char* name() const override { return "ltp"; }
+    void reset() override {
+        plasticity_.clear();
+        previous_.clear();
+        previous_width_ = 0;
+    }
+
+protected:
+    void prepare(FrameWindow& frames, std::size_t begin, std::size_t, std::size_t width) override {
+        // Plasticity is tracked for the regions of the first frame.
+        if (begin == 0) plasticity_.assign(frames[0].regions.size(), 1.0);
+        if (previous_.size() < width) previous_.resize(width);
+    }
+
+    void process_regions(FrameWindow& frames, std::size_t begin, std::size_t end,
+                         std::size_t r_begin, std::size_t r_end) override {
+        for (std::size_t i = begin; i < end; ++i) {
+            auto& regions = frames[i].regions;
+            const std::size_t last = std::min(r_end, regions.size());
+            if (i > 0) {
+                // previous_[r] only counts if frame i - 1 reported region r.
+                const std::size_t previous_width = i == begin ? previous_width_ : frames[i - 1].regions.size();
+                for (std::size_t r = r_begin; r < last; ++r) {
+                    bool tracked = r < plasticity_.size();
+                    if (tracked && r < previous_width && regions[r].intensity > threshold_ &&
+                        previous_[r] > threshold_) {
+                        plasticity_[r] += increment_;
+                    }
+                    if (tracked) regions[r].intensity *= plasticity_[r];
+                    regions[r].intensity = clamp01(regions[r].intensity);
+                }
+            }
+            for (std::size_t r = r_begin; r < last; ++r) previous_[r] = regions[r].intensity;
+        }
+    }
+
+    void finish(FrameWindow& frames, std::size_t, std::size_t end) override {
+        previous_width_ = frames[end - 1].regions.size();
+    }
+
+private:
+    double threshold_;
+    double increment_;
+    std::vector<double> plasticity_;
+    std::vector<double> previous_;  // this stage's output for the previous frame
+    std::size_t previous_width_ = 0;  // regions in the last frame processed
+};
+}
+
+std::unique_ptr<ModelingStage> make_temporal_smoothing_stage(int window_size) {
+    return std::make_unique<TemporalSmoothingStage>(window_size);
+}
+
+std::unique_ptr<ModelingStage> make_activity_decay_stage(double decay_rate) {
+    return std::make_unique<ActivityDecayStage>(decay_rate);
+}
+
+std::unique_ptr<ModelingStage> make_synaptic_delay_stage(int delay_frames) {
+    return std::make_unique<SynapticDelayStage>(delay_frames);
+}
+
+std::unique_ptr<ModelingStage> make_pathway_stage(double coupling, std::int64_t step_ms) {
+    return std::make_unique<PathwayStage>(coupling, step_ms);
+}
+
+std::unique_ptr<ModelingStage> make_refractory_stage(int period_ms) {
+    return std::make_unique<RefractoryStage>(period_ms);
+}
+
+std::unique_ptr<ModelingStage> make_stochastic_stage(double noise_amplitude, std::uint64_t seed) {
+    return std::make_unique<StochasticStage>(noise_amplitude, seed);
+}
+
+std::unique_ptr<ModelingStage> make_transform_stage(const std::string& transform) {
+    const IntensityTransform kind = parse_intensity_transform(transform);
+    if (kind != IntensityTransform::Identity || is_linear_transform(transform)) {
+        return std::make_unique<TransformStage>(kind);
+    }
+    return std::make_unique<ExpressionStage>(IntensityExpression::compile(transform));
+}
+
+std::unique_ptr<ModelingStage> make_neurotransmitter_stage() {
+    return std::make_unique<NeurotransmitterStage>();
+}
+
+std::unique_ptr<ModelingStage> make_ltp_stage(double threshold, double increment) {
+    return std::make_unique<LtpStage>(threshold, increment);
+}
+
+ModelingPipeline ModelingPipeline::from_config(const AppConfig& config) {
+    ModelingPipeline p;
+    if (config.smoothing_window_size >= 2) p.add(make_temporal_smoothing_stage(config.smoothing_window_size));
+    if (config.activity_decay_rate != 0.0) p.add(make_activity_decay_stage(config.activity_decay_rate));
+    if (config.synaptic_delay_frames > 0) p.add(make_synaptic_delay_stage(config.synaptic_delay_frames));
+    if (config.pathway_coupling != 0.0) {
+        p.add(make_pathway_stage(config.pathway_coupling, config.pathway_step_ms));
+    }
+    if (config.refractory_period_ms > 0) p.add(make_refractory_stage(config.refractory_period_ms));
+    if (config.noise_amplitude > 0.0) {
+        p.add(make_stochastic_stage(config.noise_amplitude, static_cast<std::uint64_t>(config.random_seed)));
+    }
+    if (!is_linear_transform(config.intensity_transform)) {
+        p.add(make_transform_stage(config.intensity_transform));
+    }
+    if (config.enable_neurotransmitter_simulation) p.add(make_neurotransmitter_stage());
+    if (config.ltp_increment != 0.0) p.add(make_ltp_stage(config.ltp_threshold, config.ltp_increment));
+    p.set_threads(config.modeling_threads > 0 ? static_cast<std::size_t>(config.modeling_threads) : 0);
+    return p;
+}
+
+ModelingPipeline& ModelingPipeline::add(std::unique_ptr<ModelingStage> stage) {
+    if (stage) stages_.push_back(std::move(stage));
+    return *this;
+}
+
+std::vector<std::string> ModelingPipeline::stage_names() const {
+    std::vector<std::string> names;
+    names.reserve(stages_.size());
+    for (const auto& s : stages_) names.emplace_back(s->name());
+    return names;
+}
+
+void ModelingPipeline::start() {
+    ThreadPool* pool = threads_ == 1 ? nullptr : &ThreadPool::shared();
+    const std::size_t max_tasks = pool ? (threads_ ? threads_ : pool->concurrency()) : 1;
+    for (auto& s : stages_) {
+        s->reset();
+        s->set_parallelism(pool, max_tasks);
+    }
+    done_.assign(stages_.size(), 0);
+}
+
+// done_[k] frames have been through stage k. Stage 0 goes up to `target`;
+// stage k then follows up to what stage k-1 has finished, minus its
+// lookahead, or all the way once the timeline is `complete` and stage k-1
+// has reached its end.
+void ModelingPipeline::advance(FrameWindow& frames, std::size_t target, bool complete) {
+    const std::size_t n = frames.size();
+    for (std::size_t k = 0; k < stages_.size(); ++k) {
+        if (k > 0) {
+            std::size_t upstream = done_[k - 1];
+            std::size_t ahead = stages_[k]->lookahead();
+            target = complete && upstream == n ? n : (upstream > ahead ? upstream - ahead : 0);
+        }
+        if (target > done_[k]) {
+            stages_[k]->process(frames, done_[k], target);
+            done_[k] = target;
+        }
+    }
+}
+
+void ModelingPipeline::run(std::vector<BrainFrame>& frames) {
+    if (stages_.empty() || frames.empty()) return;
+    start();
+    // Each round advances stage 0 by one block; it reads untouched input, so
+    // with the whole timeline at hand it can look ahead freely.
+    FrameWindow window(frames);
+    const std::size_t n = frames.size();
+    while (done_.back() < n) advance(window, std::min(n, done_[0] + block_frames_), true);
+}
+
+ModelingStream::ModelingStream(ModelingPipeline pipeline) : pipeline_(std::move(pipeline)) {
+    reset();
+}
+
+void ModelingStream::reset() {
+    pending_.clear();
+    first_ = 0;
+    pipeline_.start();
+}
+
+std::size_t ModelingStream::latency_frames() const {
+    std::size_t total = 0;
+    for (const auto& s : pipeline_.stages_) total += s->lookahead();
+    return total;
+}
+
+std::vector<BrainFrame> ModelingStream::push(BrainFrame frame) {
+    pending_.push_back(std::move(frame));
+    if (pipeline_.empty()) return release(first_ + pending_.size());
+    FrameWindow window(pending_, first_);
+    // Stage 0 may only look ahead into frames that have arrived.
+    const std::size_t ahead = pipeline_.stages_.front()->lookahead();
+    const std::size_t n = window.size();
+    pipeline_.advance(window, n > ahead ? n - ahead : 0, false);
+    return release(pipeline_.done_.back());
+}
+
+std::vector<BrainFrame> ModelingStream::finish() {
+    if (pipeline_.empty()) return release(first_ + pending_.size());
+    FrameWindow window(pending_, first_);
+    pipeline_.advance(window, window.size(), true);
+    return release(pipeline_.done_.back());
+}
+
+std::vector<BrainFrame> ModelingStream::release(std::size_t upto) {
+    const auto count = static_cast<std::ptrdiff_t>(upto - first_);
+    std::vector<BrainFrame> out(std::make_move_iterator(pending_.begin()),
+                                std::make_move_iterator(pending_.begin() + count));
+    pending_.erase(pending_.begin(), pending_.begin() + count);
+    first_ = upto;
+    return out;
+}
+
+}
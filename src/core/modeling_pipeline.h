@@ -0,0 +1,145 @@
+#pragma once
+
+#include "core/state_manager.h"
+#include "io/config.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cerebra {
+
+class ThreadPool;
+
+// The frames of a timeline a stage is working on, addressed by their index
+// in the whole timeline. A batch run holds every frame; a stream only those
+// it has not handed back yet.
+class FrameWindow {
+public:
+    FrameWindow(std::vector<BrainFrame>& frames, std::size_t first = 0) : frames_(&frames), first_(first) {}
+
+    BrainFrame& operator[](std::size_t i) { return (*frames_)[i - first_]; }
+    // Frames that have arrived so far, including any already handed back.
+    std::size_t size() const { return first_ + frames_->size(); }
+
+private:
+    std::vector<BrainFrame>* frames_;
+    std::size_t first_;
+};
+
+// One modeling step over a timeline. A stage sees the frames in order, a
+// block of consecutive frames at a time, and carries whatever per-region
+// state it needs (history rings, plasticity, last-fire times) from one block
+// to the next. Earlier frames may be gone by the next call, so anything
+// needed from them has to be kept in that state.
+class ModelingStage {
+public:
+    virtual ~ModelingStage() = default;
+
+    virtual const char* name() const = 0;
+
+    // How many frames past the current one the stage reads. The pipeline
+    // holds the stage back so those frames have already been through every
+    // earlier stage, and not yet through this one or any later one.
+    virtual std::size_t lookahead() const { return 0; }
+
+    // Clear per-run state before a new timeline.
+    virtual void reset() {}
+
+    // Stages whose regions evolve independently may split each block by
+    // region across up to `max_tasks` tasks on `pool` (null: stay serial).
+    // Region i's result never depends on how the regions were split.
+    virtual void set_parallelism(ThreadPool* /*pool*/, std::size_t /*max_tasks*/) {}
+
+    // Rewrite frames[begin, end) in place, reading at most lookahead() frames
+    // beyond. Calls arrive in frame order and never overlap.
+    virtual void process(FrameWindow& frames, std::size_t begin, std::size_t end) = 0;
+};
+
+std::unique_ptr<ModelingStage> make_temporal_smoothing_stage(int window_size);
+std::unique_ptr<ModelingStage> make_activity_decay_stage(double decay_rate);
+std::unique_ptr<ModelingStage> make_synaptic_delay_stage(int delay_frames);
+// Activity propagation along PathwayCatalog::all() (see PathwayNetwork),
+// one step of `step_ms` per frame.
+std::unique_ptr<ModelingStage> make_pathway_stage(double coupling, std::int64_t step_ms);
+std::unique_ptr<ModelingStage> make_refractory_stage(int period_ms);
+std::unique_ptr<ModelingStage> make_stochastic_stage(double noise_amplitude, std::uint64_t seed = 0);
+// A named transform (square, sqrt, sin, exp), "linear" for none, or else an
+// IntensityExpression formula; throws std::runtime_error if it won't compile.
+std::unique_ptr<ModelingStage> make_transform_stage(const std::string& transform);
+std::unique_ptr<ModelingStage> make_neurotransmitter_stage();
+std::unique_ptr<ModelingStage> make_ltp_stage(double threshold, double increment);
+
+// A chain of stages fused into a single cache-blocked pass: every stage runs
+// over one block of frames before the pass moves on, so each block is pulled
+// into cache once rather than once per stage. The result matches running the
+// stages one after another over the whole timeline.
+class ModelingPipeline {
+public:
+    // Roughly an L2's worth of frames for a builtin-atlas timeline.
+    static constexpr std::size_t kDefaultBlockFrames = 64;
+
+    ModelingPipeline() = default;
+
+    // The stages `config` enables, in the canonical order: smoothing, decay,
+    // synaptic delay, pathways, refractory, noise, transform,
+    // neurotransmitters, LTP,
+    // run on `config.modeling_threads` threads.
+    static ModelingPipeline from_config(const AppConfig& config);
+
+    ModelingPipeline& add(std::unique_ptr<ModelingStage> stage);
+    void set_block_frames(std::size_t frames) { block_frames_ = frames ? frames : 1; }
+
+    // Threads the region-parallel stages may use from ThreadPool::shared():
+    // 0 for all of them, 1 to run everything on the calling thread.
+    void set_threads(std::size_t threads) { threads_ = threads; }
+    std::size_t threads() const { return threads_; }
+
+    std::size_t size() const { return stages_.size(); }
+    bool empty() const { return stages_.empty(); }
+    std::vector<std::string> stage_names() const;
+
+    void run(std::vector<BrainFrame>& frames);
+
+private:
+    friend class ModelingStream;
+
+    void start();
+    void advance(FrameWindow& frames, std::size_t target, bool complete);
+
+    std::vector<std::unique_ptr<ModelingStage>> stages_;
+    std::size_t block_frames_ = kDefaultBlockFrames;
+    std::size_t threads_ = 0;
+    std::vector<std::size_t> done_;  // frames through each stage so far
+};
+
+// A pipeline run online: frames are pushed one at a time as they arrive and
+// come back, fully modeled, as soon as every stage has seen the frames it
+// looks ahead to, i.e. latency_frames() behind the input. Only those frames
+// are held. The frames returned over a whole stream (finish() included)
+// equal ModelingPipeline::run over the same input.
+class ModelingStream {
+public:
+    explicit ModelingStream(ModelingPipeline pipeline);
+
+    // Feed the next frame; returns the frames it completes, oldest first.
+    std::vector<BrainFrame> push(BrainFrame frame);
+    // End of input: complete and return every frame still held back.
+    std::vector<BrainFrame> finish();
+    // Start a new timeline.
+    void reset();
+
+    std::size_t latency_frames() const;
+    std::size_t pending() const { return pending_.size(); }
+
+private:
+    std::vector<BrainFrame> release(std::size_t upto);
+
+    ModelingPipeline pipeline_;
+    std::vector<BrainFrame> pending_;  // frames [first_, first_ + size) not yet returned
+    std::size_t first_ = 0;
+};
+
+}
@@ -1,11 +1,15 @@
 #include "core/neurochemistry.h"
+#include "core/chemistry_integrator.h"
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <set>
 #include <sstream>
 #include <stdexcept>
 
+#include "io/json_document.h"
 #include "io/json_parser.h"
 #include "core/atlas_region.h"
 #include "io/config_util.hpp"
@@ -27,8 +31,10 @@ const std::vector<NeurotransmitterInfo>& builtin_catalog() {
   return kTransmitters;
 }
 
-std::vector<NeurotransmitterInfo>& active_catalog() {
-  static std::vector<NeurotransmitterInfo> active = builtin_catalog();
+using Catalog = ChemicalState::Catalog;
+
+std::shared_ptr<const Catalog>& active_catalog() {
+  static std::shared_ptr<const Catalog> active = std::make_shared<const Catalog>(builtin_catalog());
   return active;
 }
 
@@ -37,9 +43,76 @@ bool& custom_flag() {
   return f;
 }
 
+constexpr std::uint32_t kNoTransmitter = static_cast<std::uint32_t>(-1);
+
+// For each region of one atlas, the catalog index of its primary transmitter
+// (kNoTransmitter when the catalog does not model it). Every thread keeps its
+// own copy and rebuilds it when the atlas or the catalog is replaced, so a
+// step never takes a lock or touches a RegionDefinition.
+struct ReleaseTable {
+  std::shared_ptr<const Catalog> catalog;
+  std::shared_ptr<const AtlasSnapshot> snapshot;
+  const RegionAtlas* atlas = nullptr;  // snapshot->atlas
+  std::vector<std::uint32_t> transmitter;  // by RegionId
+};
+
+const ReleaseTable& release_table() {
+  thread_local ReleaseTable table;
+  const std::uint64_t version = current_atlas_version();
+  const auto& catalog = active_catalog();
+  if (table.catalog == catalog && table.snapshot && table.snapshot->version == version) {
+    return table;
+  }
+  table.catalog = catalog;
+  table.snapshot = acquire_atlas_snapshot();
+  table.atlas = &table.snapshot->atlas;
+  table.transmitter.assign(table.atlas->size(), kNoTransmitter);
+  for (std::size_t r = 0; r < table.atlas->size(); ++r) {
+    const std::string& key = table.atlas->regions()[r].primary_transmitter;
+    for (std::size_t t = 0; t < catalog->size(); ++t) {
+      if ((*catalog)[t].key == key) {
+        table.transmitter[r] = static_cast<std::uint32_t>(t);
+        break;
+      }
+    }
+  }
+  return table;
+}
+
+// The level of `catalog`'s transmitter `index` in `state`, which may have
+// been built against a different catalog.
+double level_in(const ChemicalState& state, const Catalog& catalog, std::size_t index) {
+  if (&state.catalog() == &catalog) return state[index];
+  const std::size_t j = state.index_of(catalog[index].key);
+  return j == ChemicalState::npos ? catalog[index].baseline : state[j];
+}
+
 }  // namespace
 
-const std::vector<NeurotransmitterInfo>& Neurochemistry::catalog() { return active_catalog(); }
+const ChemicalState::Catalog& ChemicalState::catalog() const {
+  static const Catalog kEmpty;
+  return catalog_ ? *catalog_ : kEmpty;
+}
+
+std::size_t ChemicalState::index_of(const std::string& key) const {
+  const Catalog& nts = catalog();
+  for (std::size_t i = 0; i < nts.size(); ++i) {
+    if (nts[i].key == key) return i;
+  }
+  return npos;
+}
+
+double& ChemicalState::at(const std::string& key) {
+  const std::size_t i = index_of(key);
+  if (i == npos) throw std::out_of_range("no such neurotransmitter in state: " + key);
+  return levels_[i];
+}
+
+double ChemicalState::at(const std::string& key) const {
+  return const_cast<ChemicalState&>(*this).at(key);
+}
+
+const std::vector<NeurotransmitterInfo>& Neurochemistry::catalog() { return *active_catalog(); }
 
 const NeurotransmitterInfo* Neurochemistry::find(const std::string& key) {
   for (const auto& nt : catalog()) {
@@ -50,66 +123,102 @@ const NeurotransmitterInfo* Neurochemistry::find(const std::string& key) {
 
 ChemicalState Neurochemistry::baseline_state() {
   ChemicalState state;
-  for (const auto& nt : catalog()) state[nt.key] = nt.baseline;
+  state.catalog_ = active_catalog();
+  state.levels_.reserve(state.catalog_->size());
+  for (const auto& nt : *state.catalog_) state.levels_.push_back(nt.baseline);
   return state;
 }
 
-ChemicalState Neurochemistry::step(const ChemicalState& previous,
-                                   const std::map<std::string, double>& region_intensities) {
-  ChemicalState next = previous.empty() ? baseline_state() : previous;
-  // Make sure every transmitter currently in the catalog has an entry.
-  for (const auto& nt : catalog()) {
-    if (next.find(nt.key) == next.end()) next[nt.key] = nt.baseline;
-  }
-
-  // Aggregate release pressure per transmitter from active regions.
-  std::map<std::string, double> release;
-  for (const auto& kv : region_intensities) {
-    auto info = RegionCatalog::find(kv.first);
-    if (!info) continue;
-    const NeurotransmitterInfo* nt = find(info->primary_transmitter);
-    if (!nt) continue;
-    release[nt->key] = std::max(release[nt->key], kv.second);
-  }
+namespace {
 
-  for (const auto& nt : catalog()) {
-    double level = next.count(nt.key) ? next.at(nt.key) : nt.baseline;
-    double target_release = release.count(nt.key) ? release.at(nt.key) : 0.0;
-    // Release pushes the level up toward release_gain * pressure.
-    double release_target = nt.baseline + nt.release_gain * target_release * (1.0 - nt.baseline);
+// Release pushes each level up toward baseline + release_gain * pressure,
+// then reuptake pulls it back toward baseline.
+void relax(std::vector<double>& levels, const Catalog& catalog, const std::vector<double>& release) {
+  for (std::size_t t = 0; t < catalog.size(); ++t) {
+    const NeurotransmitterInfo& nt = catalog[t];
+    double level = levels[t];
+    const double release_target = nt.baseline + nt.release_gain * release[t] * (1.0 - nt.baseline);
     if (release_target > level) {
       level += 0.5 * (release_target - level);
     }
-    // Reuptake always pulls toward baseline.
     level += nt.reuptake_rate * (nt.baseline - level);
-    next[nt.key] = clamp01(level);
+    levels[t] = clamp01(level);
+  }
+}
+
+}  // namespace
+
+const std::vector<double>& Neurochemistry::prepare(ChemicalState& state,
+                                                   const std::vector<double>& intensity_by_region) {
+  const ReleaseTable& table = release_table();
+  const Catalog& nts = *table.catalog;
+  if (state.catalog_ != table.catalog) {
+    // Carry levels over by key; transmitters new to the catalog start at baseline.
+    ChemicalState next = baseline_state();
+    for (std::size_t t = 0; t < nts.size(); ++t) next.levels_[t] = level_in(state, nts, t);
+    state = std::move(next);
   }
+
+  // Release pressure per transmitter is the strongest region driving it.
+  thread_local std::vector<double> release;
+  release.assign(nts.size(), 0.0);
+  const std::size_t regions = std::min(intensity_by_region.size(), table.transmitter.size());
+  for (std::size_t r = 0; r < regions; ++r) {
+    const std::uint32_t t = table.transmitter[r];
+    if (t != kNoTransmitter) release[t] = std::max(release[t], intensity_by_region[r]);
+  }
+  return release;
+}
+
+void Neurochemistry::advance(ChemicalState& state, const std::vector<double>& intensity_by_region) {
+  const std::vector<double>& release = prepare(state, intensity_by_region);
+  relax(state.levels_, *state.catalog_, release);
+}
+
+std::size_t Neurochemistry::integrate(ChemicalState& state, const std::vector<double>& intensity_by_region,
+                                      double dt_ms, const ChemistryIntegrator& integrator) {
+  const std::vector<double>& release = prepare(state, intensity_by_region);
+  return integrator.integrate(*state.catalog_, state.levels_, release, dt_ms);
+}
+
+ChemicalState Neurochemistry::step(const ChemicalState& previous,
+                                   const std::map<std::string, double>& region_intensities) {
+  const ReleaseTable& table = release_table();
+  thread_local std::vector<double> intensity;
+  intensity.assign(table.transmitter.size(), 0.0);
+  for (const auto& kv : region_intensities) {
+    const RegionId id = table.atlas->id_of(kv.first);
+    if (id < intensity.size()) intensity[id] = std::max(intensity[id], kv.second);
+  }
+  ChemicalState next = previous;
+  advance(next, intensity);
   return next;
 }
 
 std::vector<Neurochemistry::Flow> Neurochemistry::flows(
     const ChemicalState& previous, const ChemicalState& current,
     const std::map<std::string, double>& region_intensities) {
+  const ReleaseTable& table = release_table();
+  const Catalog& nts = *table.catalog;
+
   // Map each transmitter to the strongest region driving it (for arrow source).
-  std::map<std::string, std::pair<std::string, double>> dominant_source;
+  std::vector<std::pair<RegionId, double>> dominant_source(nts.size(), {kNoRegion, 0.0});
   for (const auto& kv : region_intensities) {
-    auto info = RegionCatalog::find(kv.first);
-    if (!info) continue;
-    auto& slot = dominant_source[info->primary_transmitter];
-    if (kv.second > slot.second) slot = {info->key, kv.second};
+    const RegionId id = table.atlas->id_of(kv.first);
+    if (id >= table.transmitter.size() || table.transmitter[id] == kNoTransmitter) continue;
+    auto& slot = dominant_source[table.transmitter[id]];
+    if (kv.second > slot.second) slot = {id, kv.second};
   }
 
   std::vector<Flow> out;
-  for (const auto& nt : catalog()) {
-    double before = previous.count(nt.key) ? previous.at(nt.key) : nt.baseline;
-    double after = current.count(nt.key) ? current.at(nt.key) : nt.baseline;
-    double delta = after - before;
+  for (std::size_t t = 0; t < nts.size(); ++t) {
+    double delta = level_in(current, nts, t) - level_in(previous, nts, t);
     if (std::abs(delta) < 1e-4) continue;
     Flow f;
-    f.transmitter = nt.key;
+    f.transmitter = nts[t].key;
     f.magnitude = delta;
-    if (delta > 0 && dominant_source.count(nt.key)) {
-      f.source_region = dominant_source.at(nt.key).first;
+    if (delta > 0 && dominant_source[t].first != kNoRegion) {
+      f.source_region = table.atlas->at(dominant_source[t].first)->key;
     }
     out.push_back(f);
   }
@@ -119,7 +228,11 @@ std::vector<Neurochemistry::Flow> Neurochemistry::flows(
   return out;
 }
 
-void Neurochemistry::load_from_json(const JsonValue& root) {
+namespace {
+
+// The body of both load_from_json overloads; `Json` is JsonValue or JsonElement.
+template <typename Json>
+std::vector<NeurotransmitterInfo> parse_catalog(const Json& root) {
   if (!root.is_array()) {
     throw std::runtime_error("neurotransmitter catalog must be a JSON array");
   }
@@ -141,9 +254,9 @@ void Neurochemistry::load_from_json(const JsonValue& root) {
     if (!seen.insert(nt.key).second) {
       throw std::runtime_error("duplicate neurotransmitter key: " + nt.key);
     }
-    nt.display_name = elem["display_name"].as_string();
+    nt.display_name = std::string(elem["display_name"].as_string());
     if (nt.display_name.empty()) nt.display_name = config_util::title_from_key(nt.key);
-    nt.symbol = elem["symbol"].as_string();
+    nt.symbol = std::string(elem["symbol"].as_string());
     if (nt.symbol.empty()) nt.symbol = config_util::short_code(nt.key, 4, "NT");
     nt.baseline = clamp01(elem["baseline"].as_number(0.2));
     nt.release_gain = clamp01(elem["release_gain"].as_number(0.8));
@@ -151,7 +264,18 @@ void Neurochemistry::load_from_json(const JsonValue& root) {
     nt.extra = config_util::parse_metadata(elem["metadata"]);
     parsed.push_back(std::move(nt));
   }
-  active_catalog() = std::move(parsed);
+  return parsed;
+}
+
+}  // namespace
+
+void Neurochemistry::load_from_json(const JsonValue& root) {
+  active_catalog() = std::make_shared<const Catalog>(parse_catalog(root));
+  custom_flag() = true;
+}
+
+void Neurochemistry::load_from_json(const JsonElement& root) {
+  active_catalog() = std::make_shared<const Catalog>(parse_catalog(root));
   custom_flag() = true;
 }
 
@@ -162,11 +286,12 @@ void Neurochemistry::load_from_file(const std::string& path) {
   }
   std::ostringstream buffer;
   buffer << in.rdbuf();
-  load_from_json(JsonValue::parse(buffer.str()));
+  const JsonDocument doc = JsonDocument::parse(buffer.str());
+  load_from_json(doc.root());
 }
 
 void Neurochemistry::reset_to_defaults() {
-  active_catalog() = builtin_catalog();
+  active_catalog() = std::make_shared<const Catalog>(builtin_catalog());
   custom_flag() = false;
 }
 
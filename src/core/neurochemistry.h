@@ -1,13 +1,17 @@
 #ifndef BRAIN_MODELER_NEUROTRANSMITTER_HPP
 #define BRAIN_MODELER_NEUROTRANSMITTER_HPP
 
+#include <cstddef>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace cerebra {
 
 class JsonValue;  // defined in json_utility.h; referenced only by reference here
+class JsonElement;  // io/json_document.h
+class ChemistryIntegrator;  // core/chemistry_integrator.h
 
 struct NeurotransmitterInfo {
   std::string key;
@@ -20,7 +24,40 @@ struct NeurotransmitterInfo {
 };
 
 // A snapshot of every modelled neurotransmitter concentration at one timestep.
-using ChemicalState = std::map<std::string, double>;
+// Levels are stored densely in the order of the catalog the state was built
+// against, and keyed access resolves names through that same catalog, so a
+// state stays readable after the active catalog is replaced.
+class ChemicalState {
+public:
+  using Catalog = std::vector<NeurotransmitterInfo>;
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  ChemicalState() = default;
+
+  std::size_t size() const { return levels_.size(); }
+  bool empty() const { return levels_.empty(); }
+
+  // The catalog the levels are indexed by (empty for a default-constructed
+  // state) and the level of its `index`th transmitter.
+  const Catalog& catalog() const;
+  const std::vector<double>& levels() const { return levels_; }
+  double& operator[](std::size_t index) { return levels_[index]; }
+  double operator[](std::size_t index) const { return levels_[index]; }
+
+  // Keyed access; at() and operator[] throw std::out_of_range for a
+  // transmitter that is not in catalog().
+  std::size_t index_of(const std::string& key) const;
+  std::size_t count(const std::string& key) const { return index_of(key) == npos ? 0 : 1; }
+  double& at(const std::string& key);
+  double at(const std::string& key) const;
+  double& operator[](const std::string& key) { return at(key); }
+
+private:
+  friend class Neurochemistry;
+
+  std::shared_ptr<const Catalog> catalog_;
+  std::vector<double> levels_;
+};
 
 class Neurochemistry {
 public:
@@ -38,6 +75,19 @@ public:
   static ChemicalState step(const ChemicalState& previous,
                             const std::map<std::string, double>& region_intensities);
 
+  // The same step in place, with intensities indexed by RegionId of the
+  // current atlas (missing trailing regions count as idle). The region ->
+  // transmitter table behind both forms is built once per atlas and catalog,
+  // so a step is a pass over the regions and one over the transmitters.
+  static void advance(ChemicalState& state, const std::vector<double>& intensity_by_region);
+
+  // Continuous-time counterpart of advance(): integrates the release/reuptake
+  // model over `dt_ms` of real time with these intensities held, so the
+  // result does not depend on how often it is called. Returns the number of
+  // integrator sub-steps taken.
+  static std::size_t integrate(ChemicalState& state, const std::vector<double>& intensity_by_region,
+                               double dt_ms, const ChemistryIntegrator& integrator);
+
   // A directed description of where chemicals are "flowing" this step, useful
   // for the ASCII flow visualization. Magnitude is the change vs. the previous
   // state (positive = release, negative = reuptake).
@@ -55,9 +105,16 @@ public:
   // std::runtime_error / JsonParseError on a malformed or invalid document; the
   // previous catalog is left intact on failure.
   static void load_from_json(const JsonValue& root);
+  static void load_from_json(const JsonElement& root);
   static void load_from_file(const std::string& path);
   static void reset_to_defaults();
   static bool using_custom_catalog();
+
+private:
+  // Re-index `state` to the active catalog if needed and return the release
+  // pressure per transmitter (valid until the next call on this thread).
+  static const std::vector<double>& prepare(ChemicalState& state,
+                                            const std::vector<double>& intensity_by_region);
 };
 
 }  // namespace cerebra
@@ -6,6 +6,7 @@
 #include <sstream>
 #include <stdexcept>
 
+#include "io/json_document.h"
 #include "io/json_parser.h"
 #include "core/neurochemistry.h"
 #include "core/atlas_region.h"
@@ -80,7 +81,11 @@ std::vector<Pathway> PathwayCatalog::efferent(const std::string& region_key) {
   return out;
 }
 
-void PathwayCatalog::load_from_json(const JsonValue& root) {
+namespace {
+
+// The body of both load_from_json overloads; `Json` is JsonValue or JsonElement.
+template <typename Json>
+std::vector<Pathway> parse_catalog(const Json& root) {
   if (!root.is_array()) {
     throw std::runtime_error("pathway catalog must be a JSON array");
   }
@@ -90,8 +95,8 @@ void PathwayCatalog::load_from_json(const JsonValue& root) {
       throw std::runtime_error("each pathway entry must be a JSON object");
     }
     Pathway p;
-    const std::string raw_from = elem["from"].as_string();
-    const std::string raw_to = elem["to"].as_string();
+    const std::string raw_from(elem["from"].as_string());
+    const std::string raw_to(elem["to"].as_string());
     if (raw_from.empty() || raw_to.empty()) {
       throw std::runtime_error("pathway entry needs non-empty 'from' and 'to'");
     }
@@ -105,12 +110,12 @@ void PathwayCatalog::load_from_json(const JsonValue& root) {
     p.weight = clamp01(elem["weight"].as_number(0.5));
     p.delay_ms = std::max<std::int64_t>(0, elem["delay_ms"].as_int(0));
     if (elem.contains("kind")) {
-      if (!parse_pathway_kind(elem["kind"].as_string(), p.kind)) {
-        throw std::runtime_error("pathway '" + p.label() + "' has unknown kind '" +
-                                 elem["kind"].as_string() + "'");
+      const std::string kind(elem["kind"].as_string());
+      if (!parse_pathway_kind(kind, p.kind)) {
+        throw std::runtime_error("pathway '" + p.label() + "' has unknown kind '" + kind + "'");
       }
     }
-    p.transmitter = elem["transmitter"].as_string();
+    p.transmitter = std::string(elem["transmitter"].as_string());
     if (!p.transmitter.empty() && !Neurochemistry::find(p.transmitter)) {
       throw std::runtime_error("pathway '" + p.label() + "' references unknown neurotransmitter '" +
                                p.transmitter + "'");
@@ -118,7 +123,18 @@ void PathwayCatalog::load_from_json(const JsonValue& root) {
     p.extra = config_util::parse_metadata(elem["metadata"]);
     parsed.push_back(std::move(p));
   }
-  active_catalog() = std::move(parsed);
+  return parsed;
+}
+
+}  // namespace
+
+void PathwayCatalog::load_from_json(const JsonValue& root) {
+  active_catalog() = parse_catalog(root);
+  custom_flag() = true;
+}
+
+void PathwayCatalog::load_from_json(const JsonElement& root) {
+  active_catalog() = parse_catalog(root);
   custom_flag() = true;
 }
 
@@ -129,7 +145,8 @@ void PathwayCatalog::load_from_file(const std::string& path) {
   }
   std::ostringstream buffer;
   buffer << in.rdbuf();
-  load_from_json(JsonValue::parse(buffer.str()));
+  const JsonDocument doc = JsonDocument::parse(buffer.str());
+  load_from_json(doc.root());
 }
 
 void PathwayCatalog::reset_to_defaults() {
@@ -9,6 +9,7 @@
 namespace cerebra {
 
 class JsonValue;  // defined in json_utility.h; referenced only by reference here
+class JsonElement;  // io/json_document.h
 
 enum class PathwayKind { Excitatory, Inhibitory, Modulatory };
 
@@ -52,6 +53,7 @@ public:
   // std::runtime_error / JsonParseError on a malformed or invalid document; the
   // previous catalog is left intact on failure.
   static void load_from_json(const JsonValue& root);
+  static void load_from_json(const JsonElement& root);
   static void load_from_file(const std::string& path);
   static void reset_to_defaults();          // -> empty
   static bool using_custom_catalog();
@@ -0,0 +1,84 @@
+#include "core/pathway_network.h"
+
+#include "core/atlas_region.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cerebra {
+
+PathwayNetwork::PathwayNetwork(const std::vector<Pathway>& pathways, std::int64_t step_ms, double coupling)
+    : atlas_(acquire_atlas_snapshot()), coupling_(coupling) {
+    // Resolve every endpoint against one atlas so ids and node count agree.
+    nodes_ = atlas_->atlas.size();
+    const double step = static_cast<double>(std::max<std::int64_t>(step_ms, 1));
+    std::vector<Edge> drive, gain;
+    for (const auto& p : pathways) {
+        const RegionId from = atlas_->atlas.id_of(p.from);
+        const RegionId to = atlas_->atlas.id_of(p.to);
+        if (from >= nodes_ || to >= nodes_) continue;
+        const auto delay = static_cast<std::uint32_t>(
+            std::max<long long>(1, std::llround(static_cast<double>(p.delay_ms) / step)));
+        ring_rows_ = std::max<std::size_t>(ring_rows_, delay);
+        auto& into = p.kind == PathwayKind::Modulatory ? gain : drive;
+        const double weight = p.kind == PathwayKind::Inhibitory ? -p.weight : p.weight;
+        into.push_back({to, from, delay, weight});
+        if (!p.directed && from != to) into.push_back({from, to, delay, weight});
+    }
+    drive_ = compile(std::move(drive), nodes_);
+    gain_ = compile(std::move(gain), nodes_);
+    reset();
+}
+
+PathwayNetwork::Csr PathwayNetwork::compile(std::vector<Edge> edges, std::size_t nodes) {
+    // Sorting by (target, source) keeps each row's reads in ascending order.
+    std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+        return a.to != b.to ? a.to < b.to : a.from < b.from;
+    });
+    Csr m;
+    m.row_begin.assign(nodes + 1, 0);
+    for (const auto& e : edges) ++m.row_begin[e.to + 1];
+    for (std::size_t r = 0; r < nodes; ++r) m.row_begin[r + 1] += m.row_begin[r];
+    m.col.reserve(edges.size());
+    m.delay.reserve(edges.size());
+    m.weight.reserve(edges.size());
+    for (const auto& e : edges) {
+        m.col.push_back(e.from);
+        m.delay.push_back(e.delay);
+        m.weight.push_back(e.weight);
+    }
+    return m;
+}
+
+void PathwayNetwork::reset() {
+    ring_.assign(ring_rows_ * nodes_, 0.0);
+    t_ = 0;
+}
+
+double PathwayNetwork::accumulate(const Csr& m, std::size_t row) const {
+    const std::size_t now = t_ % ring_rows_;
+    double sum = 0.0;
+    for (std::uint32_t k = m.row_begin[row]; k < m.row_begin[row + 1]; ++k) {
+        const std::size_t d = m.delay[k];
+        const std::size_t slot = now >= d ? now - d : now + ring_rows_ - d;
+        sum += m.weight[k] * ring_[slot * nodes_ + m.col[k]];
+    }
+    return sum;
+}
+
+void PathwayNetwork::step(std::vector<double>& activity) {
+    activity.resize(nodes_, 0.0);
+    for (std::size_t r = 0; r < nodes_; ++r) {
+        const double drive = accumulate(drive_, r);
+        const double gain = accumulate(gain_, r);
+        const double x = (activity[r] + coupling_ * drive) * (1.0 + coupling_ * gain);
+        activity[r] = std::max(0.0, std::min(1.0, x));
+    }
+    // Row t % ring_rows_ held x[t - ring_rows_], which the longest-delay
+    // edges have just read for the last time.
+    std::copy(activity.begin(), activity.begin() + static_cast<std::ptrdiff_t>(nodes_),
+              ring_.begin() + static_cast<std::ptrdiff_t>((t_ % ring_rows_) * nodes_));
+    ++t_;
+}
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "core/atlas_core.h"
+#include "core/pathway_logic.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace cerebra {
+
+// Activity propagation along a set of pathways, compiled into sparse CSR
+// matrices over the current atlas's region ids (row = target region, one
+// entry per arriving edge). Each step is an SpMV against the activity the
+// sources had `delay` steps earlier:
+//
+//   drive[t]  = sum of  weight * x_src[t - delay]   over excitatory edges
+//             - sum of  weight * x_src[t - delay]   over inhibitory edges
+//   gain[t]   = sum of  weight * x_src[t - delay]   over modulatory edges
+//   x[t]      = clamp01((a[t] + coupling * drive[t]) * (1 + coupling * gain[t]))
+//
+// where a[t] is the activity fed in for the step. Undirected pathways act as
+// a pair of directed edges. Delays are quantised to whole steps, at least
+// one, so a step only ever reads earlier state and rows are independent.
+// The delayed values come from one shared ring of past activity rows, which
+// serves every edge's delay without a buffer per edge.
+class PathwayNetwork {
+public:
+    PathwayNetwork(const std::vector<Pathway>& pathways, std::int64_t step_ms, double coupling);
+
+    std::size_t node_count() const { return nodes_; }
+    std::size_t edge_count() const { return drive_.col.size() + gain_.col.size(); }
+    std::size_t max_delay_steps() const { return ring_rows_; }
+    // The atlas the node ids belong to, held for the network's lifetime.
+    const RegionAtlas& atlas() const { return atlas_->atlas; }
+
+    // Forget all past activity.
+    void reset();
+
+    // Advance one step: `activity` (node_count() long, indexed by RegionId)
+    // holds a[t] on entry and x[t] on return.
+    void step(std::vector<double>& activity);
+
+private:
+    struct Csr {
+        std::vector<std::uint32_t> row_begin;  // nodes + 1 offsets into the columns below
+        std::vector<std::uint32_t> col;        // source region
+        std::vector<std::uint32_t> delay;      // in steps, >= 1
+        std::vector<double> weight;            // signed for drive_
+    };
+
+    struct Edge {
+        std::uint32_t to, from, delay;
+        double weight;
+    };
+
+    static Csr compile(std::vector<Edge> edges, std::size_t nodes);
+    double accumulate(const Csr& m, std::size_t row) const;
+
+    std::shared_ptr<const AtlasSnapshot> atlas_;
+    std::size_t nodes_ = 0;
+    double coupling_;
+    Csr drive_;
+    Csr gain_;
+    std::size_t ring_rows_ = 1;
+    std::vector<double> ring_;  // ring_rows_ rows of x, row (t % ring_rows_) = x[t]
+    std::size_t t_ = 0;
+};
+
+}
@@ -0,0 +1,200 @@
+#include "core/random.h"
+
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define CEREBRA_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace cerebra {
+
+namespace {
+
+constexpr std::uint32_t kMul0 = 0xD2511F53;
+constexpr std::uint32_t kMul1 = 0xCD9E8D57;
+constexpr std::uint32_t kWeyl0 = 0x9E3779B9;
+constexpr std::uint32_t kWeyl1 = 0xBB67AE85;
+constexpr int kRounds = 10;
+
+constexpr std::uint64_t kOneBits = 0x3FF0000000000000ull;  // 1.0
+
+// 52 random bits as the mantissa of a double in [1, 2), shifted to [0, 1).
+double unit_from_bits(std::uint64_t bits) {
+    const std::uint64_t b = (bits >> 12) | kOneBits;
+    double v;
+    std::memcpy(&v, &b, sizeof v);
+    return v - 1.0;
+}
+
+// Element n of a stream is half of Philox block n / 2: words 0-1 for even
+// n, words 2-3 for odd.
+std::array<std::uint32_t, 4> block_counter(std::uint64_t block, std::uint64_t stream) {
+    return {static_cast<std::uint32_t>(block), static_cast<std::uint32_t>(block >> 32),
+            static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32)};
+}
+
+void scalar_fill(std::uint64_t seed, std::uint64_t stream, std::uint64_t first, double* out, std::size_t count) {
+    for (std::size_t j = 0; j < count;) {
+        const std::uint64_t n = first + j;
+        const auto w = philox4x32(block_counter(n >> 1, stream), seed);
+        if ((n & 1) == 0) {
+            out[j++] = unit_from_bits(static_cast<std::uint64_t>(w[0]) << 32 | w[1]);
+            if (j == count) break;
+        }
+        out[j++] = unit_from_bits(static_cast<std::uint64_t>(w[2]) << 32 | w[3]);
+    }
+}
+
+#ifdef CEREBRA_X86_KERNELS
+
+// Both SIMD kernels keep each 32-bit Philox word in the low half of a 64-bit
+// lane, where pmuludq gives the full 64-bit product, and run one block per
+// lane.
+
+void sse2_fill(std::uint64_t seed, std::uint64_t stream, std::uint64_t first, double* out, std::size_t count) {
+    std::size_t j = 0;
+    if ((first & 1) && count > 0) {
+        scalar_fill(seed, stream, first, out, 1);
+        j = 1;
+    }
+    const __m128i low32 = _mm_set1_epi64x(0xFFFFFFFF);
+    const __m128i mul0 = _mm_set1_epi64x(kMul0);
+    const __m128i mul1 = _mm_set1_epi64x(kMul1);
+    const __m128i one_bits = _mm_set1_epi64x(static_cast<long long>(kOneBits));
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128i s0 = _mm_set1_epi64x(static_cast<std::uint32_t>(stream));
+    const __m128i s1 = _mm_set1_epi64x(static_cast<std::uint32_t>(stream >> 32));
+    for (; j + 4 <= count; j += 4) {
+        const std::uint64_t block = (first + j) >> 1;
+        __m128i blocks = _mm_set_epi64x(static_cast<long long>(block + 1), static_cast<long long>(block));
+        __m128i c0 = _mm_and_si128(blocks, low32);
+        __m128i c1 = _mm_srli_epi64(blocks, 32);
+        __m128i c2 = s0;
+        __m128i c3 = s1;
+        std::uint32_t k0 = static_cast<std::uint32_t>(seed);
+        std::uint32_t k1 = static_cast<std::uint32_t>(seed >> 32);
+        for (int round = 0; round < kRounds; ++round) {
+            if (round > 0) {
+                k0 += kWeyl0;
+                k1 += kWeyl1;
+            }
+            __m128i p0 = _mm_mul_epu32(c0, mul0);
+            __m128i p1 = _mm_mul_epu32(c2, mul1);
+            __m128i n0 = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi64(p1, 32), c1), _mm_set1_epi64x(k0));
+            __m128i n2 = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi64(p0, 32), c3), _mm_set1_epi64x(k1));
+            c1 = _mm_and_si128(p1, low32);
+            c3 = _mm_and_si128(p0, low32);
+            c0 = n0;
+            c2 = n2;
+        }
+        __m128i even = _mm_or_si128(_mm_slli_epi64(c0, 32), c1);
+        __m128i odd = _mm_or_si128(_mm_slli_epi64(c2, 32), c3);
+        __m128d a = _mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(_mm_srli_epi64(even, 12), one_bits)), one);
+        __m128d b = _mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(_mm_srli_epi64(odd, 12), one_bits)), one);
+        _mm_storeu_pd(out + j, _mm_unpacklo_pd(a, b));
+        _mm_storeu_pd(out + j + 2, _mm_unpackhi_pd(a, b));
+    }
+    scalar_fill(seed, stream, first + j, out + j, count - j);
+}
+
+#define CEREBRA_AVX2 __attribute__((target("avx2")))
+
+CEREBRA_AVX2 void avx2_fill(std::uint64_t seed, std::uint64_t stream, std::uint64_t first, double* out,
+                            std::size_t count) {
+    std::size_t j = 0;
+    if ((first & 1) && count > 0) {
+        scalar_fill(seed, stream, first, out, 1);
+        j = 1;
+    }
+    const __m256i low32 = _mm256_set1_epi64x(0xFFFFFFFF);
+    const __m256i mul0 = _mm256_set1_epi64x(kMul0);
+    const __m256i mul1 = _mm256_set1_epi64x(kMul1);
+    const __m256i one_bits = _mm256_set1_epi64x(static_cast<long long>(kOneBits));
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256i s0 = _mm256_set1_epi64x(static_cast<std::uint32_t>(stream));
+    const __m256i s1 = _mm256_set1_epi64x(static_cast<std::uint32_t>(stream >> 32));
+    const __m256i lane = _mm256_set_epi64x(3, 2, 1, 0);
+    for (; j + 8 <= count; j += 8) {
+        const std::uint64_t block = (first + j) >> 1;
+        __m256i blocks = _mm256_add_epi64(_mm256_set1_epi64x(static_cast<long long>(block)), lane);
+        __m256i c0 = _mm256_and_si256(blocks, low32);
+        __m256i c1 = _mm256_srli_epi64(blocks, 32);
+        __m256i c2 = s0;
+        __m256i c3 = s1;
+        std::uint32_t k0 = static_cast<std::uint32_t>(seed);
+        std::uint32_t k1 = static_cast<std::uint32_t>(seed >> 32);
+        for (int round = 0; round < kRounds; ++round) {
+            if (round > 0) {
+                k0 += kWeyl0;
+                k1 += kWeyl1;
+            }
+            __m256i p0 = _mm256_mul_epu32(c0, mul0);
+            __m256i p1 = _mm256_mul_epu32(c2, mul1);
+            __m256i n0 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(p1, 32), c1), _mm256_set1_epi64x(k0));
+            __m256i n2 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(p0, 32), c3), _mm256_set1_epi64x(k1));
+            c1 = _mm256_and_si256(p1, low32);
+            c3 = _mm256_and_si256(p0, low32);
+            c0 = n0;
+            c2 = n2;
+        }
+        __m256i even = _mm256_or_si256(_mm256_slli_epi64(c0, 32), c1);
+        __m256i odd = _mm256_or_si256(_mm256_slli_epi64(c2, 32), c3);
+        __m256d a = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(even, 12), one_bits)), one);
+        __m256d b = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(odd, 12), one_bits)), one);
+        // Lane i holds elements 2i and 2i + 1 of the eight; interleave them.
+        __m256d lo = _mm256_unpacklo_pd(a, b);
+        __m256d hi = _mm256_unpackhi_pd(a, b);
+        _mm256_storeu_pd(out + j, _mm256_permute2f128_pd(lo, hi, 0x20));
+        _mm256_storeu_pd(out + j + 4, _mm256_permute2f128_pd(lo, hi, 0x31));
+    }
+    scalar_fill(seed, stream, first + j, out + j, count - j);
+}
+
+#undef CEREBRA_AVX2
+
+#endif
+
+using FillKernel = void (*)(std::uint64_t, std::uint64_t, std::uint64_t, double*, std::size_t);
+
+FillKernel fill_kernel() {
+    static const FillKernel kernel = [] {
+#ifdef CEREBRA_X86_KERNELS
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? FillKernel{avx2_fill} : FillKernel{sse2_fill};
+#else
+        return FillKernel{scalar_fill};
+#endif
+    }();
+    return kernel;
+}
+
+}
+
+std::array<std::uint32_t, 4> philox4x32(std::array<std::uint32_t, 4> c, std::uint64_t key) {
+    std::uint32_t k0 = static_cast<std::uint32_t>(key);
+    std::uint32_t k1 = static_cast<std::uint32_t>(key >> 32);
+    for (int round = 0; round < kRounds; ++round) {
+        if (round > 0) {
+            k0 += kWeyl0;
+            k1 += kWeyl1;
+        }
+        const std::uint64_t p0 = static_cast<std::uint64_t>(kMul0) * c[0];
+        const std::uint64_t p1 = static_cast<std::uint64_t>(kMul1) * c[2];
+        c = {static_cast<std::uint32_t>(p1 >> 32) ^ c[1] ^ k0, static_cast<std::uint32_t>(p1),
+             static_cast<std::uint32_t>(p0 >> 32) ^ c[3] ^ k1, static_cast<std::uint32_t>(p0)};
+    }
+    return c;
+}
+
+double CounterRng::uniform(std::uint64_t n) const {
+    double v;
+    scalar_fill(seed_, stream_, n, &v, 1);
+    return v;
+}
+
+void CounterRng::fill_uniform(std::uint64_t first, double* out, std::size_t count) const {
+    fill_kernel()(seed_, stream_, first, out, count);
+}
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace cerebra {
+
+// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2,
+// 3"): a keyed bijection on 128-bit counters. Every value is a pure function
+// of (key, counter), so streams need no state and any element of any stream
+// can be computed directly, in any order, on any thread.
+std::array<std::uint32_t, 4> philox4x32(std::array<std::uint32_t, 4> counter, std::uint64_t key);
+
+// One reproducible stream of uniform doubles in [0, 1) (52 random bits each).
+// Streams with different (seed, stream) pairs are independent; element n of
+// a stream is the same however the stream is read.
+class CounterRng {
+public:
+    CounterRng(std::uint64_t seed, std::uint64_t stream) : seed_(seed), stream_(stream) {}
+
+    double uniform(std::uint64_t n) const;
+
+    // out[j] = uniform(first + j) for j in [0, count), with the widest SIMD
+    // kernel this CPU supports. Bit-identical to calling uniform() in a loop.
+    void fill_uniform(std::uint64_t first, double* out, std::size_t count) const;
+
+private:
+    std::uint64_t seed_;
+    std::uint64_t stream_;
+};
+
+}
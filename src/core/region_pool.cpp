@@ -12,11 +12,7 @@ BrainRegion* RegionPool::acquire() {
 
 void RegionPool::release(BrainRegion* r) {
     if (r) {
-        r->subregions.clear();
-        r->intensity_history.clear();
-        r->synaptic_buffer.clear();
-        r->neurotransmitters.clear();
-        r->synapses.clear();
+        r->extra.reset();
         pool.push_back(r);
     }
 }
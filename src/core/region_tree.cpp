@@ -0,0 +1,82 @@
+#include "core/region_tree.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace cerebra {
+
+std::size_t RegionTree::add(std::size_t parent, std::string region, double intensity) {
+    const std::size_t pos = parent == npos ? size() : parent + subtree_size_[parent];
+    const std::uint32_t depth = parent == npos ? 0 : depth_[parent] + 1;
+    const std::uint32_t parent_slot = parent == npos ? kNone : static_cast<std::uint32_t>(parent);
+
+    if (pos == size()) {
+        regions_.push_back(std::move(region));
+        intensity_.push_back(intensity);
+        parent_.push_back(parent_slot);
+        depth_.push_back(depth);
+        subtree_size_.push_back(1);
+    } else {
+        auto at = [pos](auto& column) { return column.begin() + static_cast<std::ptrdiff_t>(pos); };
+        regions_.insert(at(regions_), std::move(region));
+        intensity_.insert(at(intensity_), intensity);
+        parent_.insert(at(parent_), parent_slot);
+        depth_.insert(at(depth_), depth);
+        subtree_size_.insert(at(subtree_size_), 1);
+        for (std::size_t i = pos + 1; i < size(); ++i) {
+            if (parent_[i] != kNone && parent_[i] >= pos) ++parent_[i];
+        }
+    }
+    for (std::size_t a = parent; a != npos; a = this->parent(a)) ++subtree_size_[a];
+    return pos;
+}
+
+void RegionTree::clear() {
+    regions_.clear();
+    intensity_.clear();
+    parent_.clear();
+    depth_.clear();
+    subtree_size_.clear();
+}
+
+std::vector<double> RegionTree::subtree_sums() const {
+    std::vector<double> sums(intensity_);
+    for (std::size_t i = size(); i-- > 0;) {
+        if (parent_[i] != kNone) sums[parent_[i]] += sums[i];
+    }
+    return sums;
+}
+
+std::vector<double> RegionTree::subtree_max() const {
+    std::vector<double> best(intensity_);
+    for (std::size_t i = size(); i-- > 0;) {
+        if (parent_[i] != kNone) best[parent_[i]] = std::max(best[parent_[i]], best[i]);
+    }
+    return best;
+}
+
+void RegionTree::roll_up_child_means() {
+    std::vector<double> child_sum(size(), 0.0);
+    std::vector<std::uint32_t> child_count(size(), 0);
+    // Children always follow their parent, so by the time the reverse scan
+    // reaches a node all of its children have been folded in.
+    for (std::size_t i = size(); i-- > 0;) {
+        if (child_count[i] > 0) intensity_[i] = child_sum[i] / child_count[i];
+        if (parent_[i] != kNone) {
+            child_sum[parent_[i]] += intensity_[i];
+            ++child_count[parent_[i]];
+        }
+    }
+}
+
+double RegionTree::root_mean(double fallback) const {
+    double sum = 0.0;
+    std::size_t roots = 0;
+    for (std::size_t i = 0; i < size(); i += subtree_size_[i]) {
+        sum += intensity_[i];
+        ++roots;
+    }
+    return roots ? sum / roots : fallback;
+}
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cerebra {
+
+// A forest of hierarchical (sub)regions flattened into pre-order arrays.
+// Node i's subtree is the contiguous range [i, i + subtree_size(i)), and every
+// parent sits before its children, so roll-ups are a single reverse scan and
+// subtree queries a single forward scan; no node is reached through a pointer.
+class RegionTree {
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    // Add a node under `parent` (npos for a new root) after any existing
+    // children and return its index. Appending to the most recently added
+    // branch is O(depth); adding under an earlier node shifts later nodes.
+    std::size_t add(std::size_t parent, std::string region, double intensity);
+    void clear();
+
+    std::size_t size() const { return regions_.size(); }
+    bool empty() const { return regions_.empty(); }
+
+    const std::string& region(std::size_t i) const { return regions_[i]; }
+    double intensity(std::size_t i) const { return intensity_[i]; }
+    void set_intensity(std::size_t i, double v) { intensity_[i] = v; }
+    std::size_t parent(std::size_t i) const {
+        return parent_[i] == kNone ? npos : parent_[i];
+    }
+    std::size_t depth(std::size_t i) const { return depth_[i]; }
+    std::size_t subtree_size(std::size_t i) const { return subtree_size_[i]; }
+    bool is_leaf(std::size_t i) const { return subtree_size_[i] == 1; }
+
+    const std::vector<double>& intensities() const { return intensity_; }
+
+    // Per-node aggregates over each node's whole subtree (itself included).
+    std::vector<double> subtree_sums() const;
+    std::vector<double> subtree_max() const;
+
+    // Child -> parent aggregation: every internal node takes the mean
+    // intensity of its direct children, deepest nodes first so the means
+    // compound up the hierarchy.
+    void roll_up_child_means();
+
+    // Mean intensity of the top-level nodes, or `fallback` when empty.
+    double root_mean(double fallback) const;
+
+private:
+    static constexpr std::uint32_t kNone = static_cast<std::uint32_t>(-1);
+
+    std::vector<std::string> regions_;
+    std::vector<double> intensity_;
+    std::vector<std::uint32_t> parent_;
+    std::vector<std::uint32_t> depth_;
+    std::vector<std::uint32_t> subtree_size_;
+};
+
+}
@@ -2,10 +2,12 @@
 
 #include <algorithm>
 #include <fstream>
-#include <sstream>
+#include <iterator>
+#include <utility>
 #include <stdexcept>
 
 #include "core/atlas_region.h"
+#include "io/json_events.h"
 
 namespace cerebra {
 namespace {
@@ -14,6 +16,60 @@ double clamp01(double v) { return std::max(0.0, std::min(1.0, v)); }
 
 }  // namespace
 
+void BrainActivitySample::set(std::string_view region_key, double intensity) {
+  if (!atlas_) atlas_ = acquire_atlas_snapshot();
+  RegionId id = atlas_->atlas.id_of(region_key);
+  if (id != kNoRegion) {
+    if (dense_.empty()) {
+      dense_.assign(atlas_->atlas.size(), 0.0);
+      present_.assign((dense_.size() + 63) / 64, 0);
+    }
+    std::uint64_t& word = present_[id / 64];
+    const std::uint64_t bit = std::uint64_t{1} << (id % 64);
+    if ((word & bit) == 0) ++count_;
+    word |= bit;
+    dense_[id] = intensity;
+    return;
+  }
+  for (auto& kv : unbound_) {
+    if (kv.first == region_key) {
+      kv.second = intensity;
+      return;
+    }
+  }
+  unbound_.emplace_back(std::string(region_key), intensity);
+  ++count_;
+}
+
+void BrainActivitySample::assign(const std::map<std::string, double>& intensities) {
+  clear();
+  for (const auto& kv : intensities) set(kv.first, kv.second);
+}
+
+void BrainActivitySample::clear() {
+  atlas_.reset();
+  dense_.clear();
+  present_.clear();
+  unbound_.clear();
+  count_ = 0;
+}
+
+double BrainActivitySample::intensity_of(std::string_view region_key) const {
+  if (!atlas_) return 0.0;
+  RegionId id = atlas_->atlas.id_of(region_key);
+  if (id != kNoRegion) return intensity_of(id);
+  for (const auto& kv : unbound_) {
+    if (kv.first == region_key) return kv.second;
+  }
+  return 0.0;
+}
+
+std::map<std::string, double> BrainActivitySample::to_map() const {
+  std::map<std::string, double> out;
+  for_each([&](std::string_view key, double v) { out.emplace(std::string(key), v); });
+  return out;
+}
+
 ActivityTimeline::ActivityTimeline(std::vector<BrainActivitySample> samples)
     : samples_(std::move(samples)) {
   std::stable_sort(samples_.begin(), samples_.end(),
@@ -28,10 +84,14 @@ std::int64_t ActivityTimeline::duration_ms() const {
 }
 
 void ActivityTimeline::append(BrainActivitySample sample) {
-  auto it = std::upper_bound(samples_.begin(), samples_.end(), sample,
-                             [](const BrainActivitySample& a, const BrainActivitySample& b) {
-                               return a.timestamp_ms < b.timestamp_ms;
-                             });
+  if (samples_.empty() || samples_.back().timestamp_ms <= sample.timestamp_ms) {
+    samples_.push_back(std::move(sample));
+    return;
+  }
+  // Late samples from a live stream are usually only a few frames behind, so
+  // walk back from the end rather than bisecting the whole timeline.
+  auto it = samples_.end();
+  while (it != samples_.begin() && std::prev(it)->timestamp_ms > sample.timestamp_ms) --it;
   samples_.insert(it, std::move(sample));
 }
 
@@ -58,15 +118,48 @@ ActivityTimeline ActivityTimeline::from_json(const JsonValue& root) {
       if (raw_region.empty()) continue;
       std::string key = RegionCatalog::normalize_key(raw_region);
       double intensity = clamp01(entry["intensity"].as_number(0.0));
-      sample.intensities[key] = intensity;
+      sample.set(key, intensity);
+    }
+    samples.push_back(std::move(sample));
+  }
+  return ActivityTimeline(std::move(samples));
+}
+
+namespace {
+
+// Build samples straight from parse events, one frame at a time, applying
+// the same checks as from_json().
+template <typename Source>
+ActivityTimeline read_timeline(Source&& source) {
+  std::vector<BrainActivitySample> samples;
+  auto layout = read_json_frames(std::forward<Source>(source), [&](const JsonFrameRecord& frame) {
+    if (!frame.is_object) {
+      throw std::runtime_error("each frame must be a JSON object");
+    }
+    if (!frame.has_activity) {
+      throw std::runtime_error("frame is missing a 'brain_activity' array");
+    }
+    if (!frame.entries_are_objects) {
+      throw std::runtime_error("brain_activity entries must be objects");
+    }
+    BrainActivitySample sample;
+    sample.timestamp_ms = static_cast<std::int64_t>(frame.timestamp_ms);
+    for (const auto& entry : frame.entries) {
+      if (entry.region.empty()) continue;
+      sample.set(RegionCatalog::normalize_key(entry.region), clamp01(entry.intensity));
     }
     samples.push_back(std::move(sample));
+  });
+  if (layout != JsonFrameLayout::Array) {
+    throw std::runtime_error("brain activity JSON must be an array of frames");
   }
   return ActivityTimeline(std::move(samples));
 }
 
+}  // namespace
+
 ActivityTimeline ActivityTimeline::from_json_text(const std::string& text) {
-  return from_json(JsonValue::parse(text));
+  return read_timeline(std::string_view(text));
 }
 
 ActivityTimeline ActivityTimeline::from_json_file(const std::string& path) {
@@ -74,9 +167,7 @@ ActivityTimeline ActivityTimeline::from_json_file(const std::string& path) {
   if (!in) {
     throw std::runtime_error("cannot open input file: " + path);
   }
-  std::ostringstream buffer;
-  buffer << in.rdbuf();
-  return from_json_text(buffer.str());
+  return read_timeline(in);
 }
 
 ActivityTimeline ActivityTimeline::from_intensities(
@@ -84,7 +175,7 @@ ActivityTimeline ActivityTimeline::from_intensities(
   BrainActivitySample sample;
   sample.timestamp_ms = timestamp_ms;
   for (const auto& kv : intensities) {
-    sample.intensities[RegionCatalog::normalize_key(kv.first)] = clamp01(kv.second);
+    sample.set(RegionCatalog::normalize_key(kv.first), clamp01(kv.second));
   }
   return ActivityTimeline({sample});
 }
@@ -1,11 +1,15 @@
 #ifndef BRAIN_MODELER_SAMPLE_HPP
 #define BRAIN_MODELER_SAMPLE_HPP
 
+#include <cmath>
 #include <cstdint>
 #include <map>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "core/atlas_core.h"
 #include "io/json_parser.h"
 
 namespace cerebra {
@@ -14,14 +18,62 @@ class JsonValue;
 
 // One observation of brain activity at a point in time. Intensities are keyed
 // by canonical region key and clamped into [0,1].
-struct BrainActivitySample {
+//
+// Regions known to the atlas live in a dense array indexed by RegionId; the
+// atlas snapshot that resolved them is pinned by the sample, so ids stay
+// meaningful after the current atlas changes. The few regions the atlas does
+// not know are kept in a short keyed list.
+class BrainActivitySample {
+public:
   std::int64_t timestamp_ms = 0;
-  std::map<std::string, double> intensities;  // region key -> intensity
 
-  double intensity_of(const std::string& region_key) const {
-    auto it = intensities.find(region_key);
-    return it == intensities.end() ? 0.0 : it->second;
+  void set(std::string_view region_key, double intensity);
+  void assign(const std::map<std::string, double>& intensities);
+  void clear();
+
+  double intensity_of(std::string_view region_key) const;
+  double intensity_of(RegionId id) const { return reported(id) ? dense_[id] : 0.0; }
+
+  bool empty() const { return count_ == 0; }
+  std::size_t size() const { return count_; }
+  // The atlas that `intensity_of(RegionId)` ids refer to; null while empty.
+  const RegionAtlas* atlas() const { return atlas_ ? &atlas_->atlas : nullptr; }
+
+  // Visit every reported region: atlas regions in id order as (RegionId into
+  // atlas(), intensity), then regions outside the atlas in insertion order as
+  // (key, intensity).
+  template <typename OnId, typename OnKey>
+  void visit(OnId&& on_id, OnKey&& on_key) const {
+    for (std::size_t word = 0; word < present_.size(); ++word) {
+      for (std::uint64_t bits = present_[word]; bits != 0; bits &= bits - 1) {
+        const std::size_t id = word * 64 + static_cast<std::size_t>(__builtin_ctzll(bits));
+        on_id(static_cast<RegionId>(id), dense_[id]);
+      }
+    }
+    for (const auto& kv : unbound_) on_key(std::string_view(kv.first), kv.second);
+  }
+
+  // As visit(), but every region is passed as (key, intensity).
+  template <typename Fn>
+  void for_each(Fn&& fn) const {
+    visit([&](RegionId id, double v) { fn(std::string_view(atlas_->atlas.regions()[id].id), v); }, fn);
   }
+
+  // Ordered copy of the intensities, for callers that want a keyed map.
+  std::map<std::string, double> to_map() const;
+
+private:
+  bool reported(RegionId id) const {
+    return id < dense_.size() && (present_[id / 64] >> (id % 64) & 1) != 0;
+  }
+
+  std::shared_ptr<const AtlasSnapshot> atlas_;
+  std::vector<double> dense_;  // by RegionId; meaningful where present_ is set
+  // Bit per RegionId of the regions reported. A separate bitmap rather than a
+  // sentinel value, so any intensity (NaN included) can be stored.
+  std::vector<std::uint64_t> present_;
+  std::vector<std::pair<std::string, double>> unbound_;
+  std::size_t count_ = 0;
 };
 
 // An ordered sequence of samples plus helpers to load/synthesize them.
@@ -37,7 +89,8 @@ public:
 
   std::int64_t duration_ms() const;
 
-  // Append a sample, keeping the timeline sorted by timestamp.
+  // Append a sample, keeping the timeline sorted by timestamp. Amortised O(1)
+  // for in-order samples; a late sample costs O(k) in how far back it lands.
   void append(BrainActivitySample sample);
 
   // Parse the project's JSON array-of-frames format. Throws JsonParseError or
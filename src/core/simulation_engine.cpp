@@ -5,35 +5,42 @@
 
 namespace cerebra {
 
-Simulation::Simulation(std::vector<cerebra::BrainFrame> frames) : frames_(std::move(frames)) {}
+Simulation::Simulation(std::vector<cerebra::BrainFrame> frames) : store_(frames) {}
 
 void Simulation::set_frames(std::vector<cerebra::BrainFrame> frames) {
-    frames_ = std::move(frames);
+    store_.assign(frames);
     index_ = 0;
 }
 
 void Simulation::append_frame(cerebra::BrainFrame f) {
-    frames_.push_back(std::move(f));
+    store_.append(f);
 }
 
-const cerebra::BrainFrame& Simulation::current() const {
-    if (frames_.empty()) {
+FrameView Simulation::current() const {
+    if (store_.empty()) {
         throw std::out_of_range("Simulation is empty");
     }
-    return frames_[index_];
+    return store_.view(index_);
+}
+
+FrameView Simulation::at(std::size_t i) const {
+    if (i >= store_.frame_count()) {
+        throw std::out_of_range("Simulation frame index out of range");
+    }
+    return store_.view(i);
 }
 
 void Simulation::set_index(std::size_t i) {
-    if (frames_.empty()) { index_ = 0; return; }
-    if (i >= frames_.size()) i = frames_.size() - 1;
+    if (store_.empty()) { index_ = 0; return; }
+    if (i >= store_.frame_count()) i = store_.frame_count() - 1;
     index_ = i;
 }
 
 void Simulation::advance(int delta) {
-    if (frames_.empty()) { index_ = 0; return; }
+    if (store_.empty()) { index_ = 0; return; }
     long long ni = static_cast<long long>(index_) + delta;
     if (ni < 0) ni = 0;
-    if (ni >= static_cast<long long>(frames_.size())) ni = frames_.size() - 1;
+    if (ni >= static_cast<long long>(store_.frame_count())) ni = store_.frame_count() - 1;
     index_ = static_cast<std::size_t>(ni);
 }
 
@@ -44,24 +51,40 @@ void Simulation::set_speed(int s) {
 }
 
 void Simulation::set_timeline(ActivityTimeline timeline) {
-    std::vector<cerebra::BrainFrame> new_frames;
+    store_.clear();
+    const auto snapshot = acquire_atlas_snapshot();
     for (const auto& s : timeline.samples()) {
-        cerebra::BrainFrame f;
-        f.timestamp_ms = s.timestamp_ms;
-        for (const auto& kv : s.intensities) {
-            f.regions.push_back({kv.first, kv.second});
+        std::size_t row = store_.add_frame(s.timestamp_ms);
+        auto by_key = [&](std::string_view key, double intensity) {
+            store_.set(row, store_.column_for(key, *snapshot), intensity);
+        };
+        // Samples resolved against the current atlas hand over their dense ids
+        // as-is; anything else is rebound by key.
+        if (s.atlas() == &snapshot->atlas) {
+            s.visit([&](RegionId id, double intensity) {
+                store_.set(row, store_.column_for(id, *snapshot), intensity);
+            }, by_key);
+        } else {
+            s.for_each(by_key);
         }
-        new_frames.push_back(std::move(f));
     }
-    set_frames(std::move(new_frames));
+    index_ = 0;
+}
+
+std::int64_t Simulation::duration_ms() const {
+    if (store_.empty()) return 0;
+    return store_.timestamps().back() - store_.timestamps().front();
 }
 
 ActivityTimeline Simulation::timeline() const {
     std::vector<BrainActivitySample> samples;
-    for (const auto& f : frames_) {
+    samples.reserve(store_.frame_count());
+    for (std::size_t i = 0; i < store_.frame_count(); ++i) {
         BrainActivitySample s;
-        s.timestamp_ms = f.timestamp_ms;
-        for (const auto& r : f.regions) s.intensities[r.region] = r.intensity;
+        s.timestamp_ms = store_.timestamp(i);
+        for (std::size_t col = 0; col < store_.column_count(); ++col) {
+            if (store_.present(i, col)) s.set(store_.column_key(col), store_.intensity(i, col));
+        }
         samples.push_back(std::move(s));
     }
     return ActivityTimeline(std::move(samples));
@@ -71,7 +94,7 @@ std::optional<std::string> Simulation::selected_region() const { return {}; }
 void Simulation::select_region(const std::string& /* region */) {}
 
 void Simulation::jump_to_end() {
-    if (!frames_.empty()) index_ = frames_.size() - 1;
+    if (!store_.empty()) index_ = store_.frame_count() - 1;
 }
 
 std::map<std::string, double> Simulation::chemical_state() const { return {}; }
@@ -1,15 +1,20 @@
 #pragma once
 
+#include "core/frame_store.h"
 #include "core/state_manager.h"
 
 #include <cstddef>
 #include <vector>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <map>
 
 namespace cerebra {
 
+// A timeline plus a playback cursor. Frames are held column-wise in a
+// FrameStore; current(), at() and the cursor helpers hand out FrameViews into
+// it rather than stored BrainFrames.
 class Simulation {
 public:
     Simulation() = default;
@@ -18,15 +23,22 @@ public:
     void set_frames(std::vector<cerebra::BrainFrame> frames);
     void append_frame(cerebra::BrainFrame f);
 
-    std::size_t size() const { return frames_.size(); }
-    std::size_t frame_count() const { return frames_.size(); }
-    bool empty() const { return frames_.empty(); }
+    std::size_t size() const { return store_.frame_count(); }
+    std::size_t frame_count() const { return store_.frame_count(); }
+    bool empty() const { return store_.empty(); }
 
-    const cerebra::BrainFrame& current() const;
-    const cerebra::BrainFrame& current_sample() const { return current(); }
-    const cerebra::BrainFrame& at(std::size_t i) const { return frames_.at(i); }
+    FrameView current() const;
+    FrameView current_sample() const { return current(); }
+    FrameView at(std::size_t i) const;
+    const FrameStore& store() const { return store_; }
+
+    // Views over the stored frames; nothing is copied.
+    RegionSeries series(std::string_view region_key) const { return store_.series(region_key); }
+    std::int64_t duration_ms() const;
 
     void set_timeline(ActivityTimeline timeline);
+    // Rebuilds an owning ActivityTimeline from the store. Prefer series() or
+    // store() for read-only access.
     ActivityTimeline timeline() const;
     std::optional<std::string> selected_region() const;
     void select_region(const std::string& region);
@@ -50,7 +62,7 @@ public:
     void set_speed(int s);
 
 private:
-    std::vector<cerebra::BrainFrame> frames_;
+    FrameStore store_;
     std::size_t index_ = 0;
     bool paused_ = false;
     int speed_ = 1;
@@ -9,6 +9,84 @@
 
 namespace cerebra {
 
+double BrainFrame::intensity_of(const std::string& region_key) const {
+    // The id and the lookup must come from the same atlas, even if another
+    // one is published in between.
+    const auto atlas = acquire_atlas_snapshot();
+    RegionId id = atlas->atlas.id_of(region_key);
+    if (id != kNoRegion) {
+        const RegionState* r = find(id, *atlas);
+        return r ? r->intensity : 0.0;
+    }
+    for (const auto& r : regions) if (r.region == region_key) return r.intensity;
+    return 0.0;
+}
+
+const RegionState* BrainFrame::find(RegionId id) const { return find(id, current_atlas_snapshot()); }
+
+const RegionState* BrainFrame::find(RegionId id, const AtlasSnapshot& atlas) const {
+    const RegionDefinition* def = atlas.atlas.at(id);
+    if (!def) return nullptr;
+    // An id alone is not enough: a state bound against a replaced atlas may
+    // carry this id for a different region.
+    if (id < regions.size() && regions[id].region_id == id && regions[id].region == def->id) {
+        return &regions[id];
+    }
+    for (const auto& r : regions) if (r.region == def->id) return &r;
+    return nullptr;
+}
+
+namespace {
+
+// Slot tables handed back by destroyed FrameIndexes on this thread.
+std::vector<std::vector<std::uint32_t>>& spare_slot_tables() {
+    thread_local std::vector<std::vector<std::uint32_t>> spare;
+    return spare;
+}
+
+}
+
+FrameIndex::FrameIndex(const BrainFrame& frame) : frame_(&frame), atlas_(acquire_atlas_snapshot()) {
+    const RegionAtlas& atlas = atlas_->atlas;
+    auto& spare = spare_slot_tables();
+    if (!spare.empty()) {
+        slots_.swap(spare.back());
+        spare.pop_back();
+    }
+    slots_.assign(atlas.size(), kNoSlot);
+    for (std::size_t i = 0; i < frame.regions.size(); ++i) {
+        const RegionState& r = frame.regions[i];
+        RegionId id = r.region_id;
+        const RegionDefinition* def = atlas.at(id);
+        // Re-resolve states that were never bound, or were bound against an
+        // atlas that has since been replaced.
+        if (!def || def->id != r.region) id = atlas.id_of(r.region);
+        if (id == kNoRegion) {
+            unbound_.push_back(static_cast<std::uint32_t>(i));
+        } else if (slots_[id] == kNoSlot) {
+            slots_[id] = static_cast<std::uint32_t>(i);
+        }
+    }
+}
+
+FrameIndex::~FrameIndex() {
+    if (slots_.capacity() != 0) spare_slot_tables().push_back(std::move(slots_));
+}
+
+const RegionState* FrameIndex::find(RegionId id) const {
+    if (id >= slots_.size() || slots_[id] == kNoSlot) return nullptr;
+    return &frame_->regions[slots_[id]];
+}
+
+const RegionState* FrameIndex::find(std::string_view region_key) const {
+    RegionId id = atlas_->atlas.id_of(region_key);
+    if (id != kNoRegion) return find(id);
+    for (std::uint32_t slot : unbound_) {
+        if (frame_->regions[slot].region == region_key) return &frame_->regions[slot];
+    }
+    return nullptr;
+}
+
 const char* template_name(BrainTemplate t) {
     switch (t) {
         case BrainTemplate::Focused:  return "focused";
@@ -55,17 +133,15 @@ cerebra::BrainFrame template_frame(std::string_view template_id, std::int64_t ti
     f.timestamp_ms = timestamp_ms;
     std::string canonical = resolve_template_id(template_id);
     if (canonical.empty()) return f;
-    const TemplateDefinition* def = current_atlas().find_template(canonical);
+    // make_region_state() reads the atlas again; keep `def` alive across it.
+    const auto snapshot = acquire_atlas_snapshot();
+    const TemplateDefinition* def = snapshot->atlas.find_template(canonical);
     if (!def) return f;
     for (const auto& kv : def->intensities) {
-        cerebra::RegionState rs;
-        rs.region = kv.first;
         double inten = kv.second;
         if (inten < 0.0) inten = 0.0;
         if (inten > 1.0) inten = 1.0;
-        rs.intensity = inten;
-        rs.flows = default_flows_for(kv.first, inten);
-        f.regions.push_back(std::move(rs));
+        f.regions.push_back(make_region_state(kv.first, inten));
     }
     return f;
 }
@@ -105,7 +181,7 @@ ActivityTimeline BrainStateLibrary::synthesize_timeline(const BrainStateTemplate
     for (int i = 0; i < frames; ++i) {
         BrainActivitySample s;
         s.timestamp_ms = i * step_ms;
-        s.intensities = tmpl.region_intensities;
+        s.assign(tmpl.region_intensities);
         samples.push_back(std::move(s));
     }
     return ActivityTimeline(std::move(samples));
@@ -4,6 +4,7 @@
 #include "core/sample.hpp"
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -18,10 +19,59 @@ struct BrainFrame {
     std::int64_t timestamp_ms = 0;
     std::vector<RegionState> regions;
 
-    double intensity_of(const std::string& region_key) const {
-        for (const auto& r : regions) if (r.region == region_key) return r.intensity;
-        return 0.0;
+    // Atlas regions go through find(RegionId); only regions outside the atlas
+    // are matched by a key scan.
+    double intensity_of(const std::string& region_key) const;
+
+    // Lookup by RegionId in the current atlas. Frames laid out in atlas order
+    // resolve in O(1); otherwise this scans for the region's key, so states
+    // bound against a replaced atlas (or never bound) still match correctly.
+    const RegionState* find(RegionId id) const;
+    const RegionState* find(RegionId id, const AtlasSnapshot& atlas) const;  // id in `atlas`
+    double intensity_of(RegionId id) const {
+        const RegionState* r = find(id);
+        return r ? r->intensity : 0.0;
+    }
+};
+
+// Dense RegionId -> slot table over one frame, for callers that query many
+// regions of the same frame (renderers, pathway activation). Building it is a
+// single pass over the frame; every lookup afterwards is O(1). Regions that
+// are not in the current atlas remain reachable by key.
+//
+// The index holds the atlas snapshot it resolved against; callers walking the
+// regions alongside it use atlas(), so their ids and the index's agree and the
+// definitions stay alive even if the current atlas is replaced meanwhile.
+//
+// The atlas-sized slot table is recycled per thread, so building one index per
+// rendered frame does not allocate once the thread has built its first.
+class FrameIndex {
+public:
+    explicit FrameIndex(const BrainFrame& frame);
+    FrameIndex(const FrameIndex&) = delete;
+    FrameIndex& operator=(const FrameIndex&) = delete;
+    ~FrameIndex();
+
+    const RegionAtlas& atlas() const { return atlas_->atlas; }
+
+    const RegionState* find(RegionId id) const;
+    const RegionState* find(std::string_view region_key) const;
+    double intensity_of(RegionId id) const {
+        const RegionState* r = find(id);
+        return r ? r->intensity : 0.0;
+    }
+    double intensity_of(std::string_view region_key) const {
+        const RegionState* r = find(region_key);
+        return r ? r->intensity : 0.0;
     }
+
+private:
+    static constexpr std::uint32_t kNoSlot = static_cast<std::uint32_t>(-1);
+
+    const BrainFrame* frame_;
+    std::shared_ptr<const AtlasSnapshot> atlas_;
+    std::vector<std::uint32_t> slots_;    // by RegionId
+    std::vector<std::uint32_t> unbound_;  // slots whose region is not in the atlas
 };
 
 enum class BrainTemplate {
@@ -0,0 +1,90 @@
+#include "core/thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+namespace cerebra {
+
+ThreadPool::ThreadPool(std::size_t workers) {
+    workers_.reserve(workers);
+    for (std::size_t i = 0; i < workers; ++i) workers_.emplace_back([this] { worker_loop(); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_ready_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+void ThreadPool::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        work_ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) return;
+        auto task = std::move(queue_.front());
+        queue_.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+void ThreadPool::parallel_for(std::size_t n, std::size_t grain, std::size_t max_tasks,
+                              const std::function<void(std::size_t, std::size_t)>& fn) {
+    if (n == 0) return;
+    grain = std::max<std::size_t>(grain, 1);
+    const std::size_t tasks = std::min({max_tasks, (n + grain - 1) / grain, concurrency()});
+    if (tasks <= 1) {
+        fn(0, n);
+        return;
+    }
+
+    std::size_t remaining = tasks;  // guarded by mutex_
+    std::exception_ptr error;
+    auto run = [&](std::size_t t) {
+        std::exception_ptr caught;
+        try {
+            fn(n * t / tasks, n * (t + 1) / tasks);
+        } catch (...) {
+            caught = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (caught && !error) error = caught;
+        if (--remaining == 0) task_done_.notify_all();
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (std::size_t t = 1; t < tasks; ++t) queue_.emplace_back([&run, t] { run(t); });
+    }
+    work_ready_.notify_all();
+    run(0);
+
+    // Help with whatever is queued (ours or another batch's) until our own
+    // tasks are done; only sleep when there is nothing left to pick up.
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (remaining > 0) {
+        if (!queue_.empty()) {
+            auto task = std::move(queue_.front());
+            queue_.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+        } else {
+            task_done_.wait(lock);
+        }
+    }
+    lock.unlock();
+    if (error) std::rethrow_exception(error);
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+}
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cerebra {
+
+// A fixed set of worker threads running fork-join batches. The thread that
+// calls parallel_for takes part in its own batch (and in any other queued
+// work while it waits), so batches may be issued from several threads, or
+// from inside another batch, without deadlocking.
+class ThreadPool {
+public:
+    explicit ThreadPool(std::size_t workers);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Workers plus the calling thread.
+    std::size_t concurrency() const { return workers_.size() + 1; }
+
+    // Split [0, n) into at most `max_tasks` contiguous ranges of at least
+    // `grain` items (fewer when n is small) and call fn(begin, end) on each,
+    // returning once all have finished. The split depends only on the
+    // arguments, never on timing. The first exception thrown by fn is
+    // rethrown here after the rest of the batch has finished.
+    void parallel_for(std::size_t n, std::size_t grain, std::size_t max_tasks,
+                      const std::function<void(std::size_t, std::size_t)>& fn);
+
+    // The process-wide pool, one thread per hardware thread, started on
+    // first use.
+    static ThreadPool& shared();
+
+private:
+    void worker_loop();
+
+    std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable task_done_;
+    std::deque<std::function<void()>> queue_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+}
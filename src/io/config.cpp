@@ -1,8 +1,10 @@
 #include "io/config.h"
 #include "core/data_parsing_hub.h"
+#include "io/number_decode.h"
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <algorithm>
 #include <iostream>
 
@@ -39,27 +41,35 @@ AppConfig loadConfig(const std::string& filename) {
             if (key == "enable_color") {
                 config.enable_color = (value == "true");
             } else if (key == "smoothing_window_size") {
-                try {
-                    config.smoothing_window_size = std::stoi(value);
-                } catch (...) {}
+                cerebra::decode_number(value, config.smoothing_window_size);
             } else if (key == "layout_mode") {
                 if (!value.empty()) {
                     config.layout_mode = value;
                 }
             } else if (key == "activity_decay_rate") {
-                try { config.activity_decay_rate = std::stod(value); } catch (...) {}
+                cerebra::decode_number(value, config.activity_decay_rate);
             } else if (key == "synaptic_delay_frames") {
-                try { config.synaptic_delay_frames = std::stoi(value); } catch (...) {}
+                cerebra::decode_number(value, config.synaptic_delay_frames);
             } else if (key == "refractory_period_ms") {
-                try { config.refractory_period_ms = std::stoi(value); } catch (...) {}
+                cerebra::decode_number(value, config.refractory_period_ms);
+            } else if (key == "pathway_coupling") {
+                cerebra::decode_number(value, config.pathway_coupling);
+            } else if (key == "pathway_step_ms") {
+                cerebra::decode_number(value, config.pathway_step_ms);
             } else if (key == "noise_amplitude") {
-                try { config.noise_amplitude = std::stod(value); } catch (...) {}
+                cerebra::decode_number(value, config.noise_amplitude);
+            } else if (key == "random_seed") {
+                cerebra::decode_number(value, config.random_seed);
             } else if (key == "intensity_transform") {
                 if (!value.empty()) config.intensity_transform = value;
             } else if (key == "ltp_threshold") {
-                try { config.ltp_threshold = std::stod(value); } catch (...) {}
+                cerebra::decode_number(value, config.ltp_threshold);
             } else if (key == "ltp_increment") {
-                try { config.ltp_increment = std::stod(value); } catch (...) {}
+                cerebra::decode_number(value, config.ltp_increment);
+            } else if (key == "enable_neurotransmitter_simulation") {
+                config.enable_neurotransmitter_simulation = (value == "true");
+            } else if (key == "modeling_threads") {
+                cerebra::decode_number(value, config.modeling_threads);
             } else if (key == "intensity_map") {
                 if (!value.empty()) config.intensity_map = value;
             } else if (key == "output_log_file") {
@@ -67,7 +77,7 @@ AppConfig loadConfig(const std::string& filename) {
             } else if (key == "theme") {
                 if (!value.empty()) config.theme = value;
             } else if (key == "zoom") {
-                try { config.zoom = std::stod(value); } catch (...) {}
+                cerebra::decode_number(value, config.zoom);
             } else if (key == "enable_anomaly_detection") {
                 config.enable_anomaly_detection = (value == "true");
             } else if (key == "encryption_key") {
@@ -96,7 +106,7 @@ AppConfig loadConfigJSON(const std::string& filename) {
         if (pos != std::string::npos) {
             size_t colon = content.find(":", pos);
             size_t comma = content.find_first_of(",}", colon);
-            val = std::stoi(trim_string(content.substr(colon + 1, comma - colon - 1)));
+            cerebra::decode_number(std::string_view(content).substr(colon + 1, comma - colon - 1), val);
         }
     };
 
@@ -105,7 +115,7 @@ AppConfig loadConfigJSON(const std::string& filename) {
         if (pos != std::string::npos) {
             size_t colon = content.find(":", pos);
             size_t comma = content.find_first_of(",}", colon);
-            val = std::stod(trim_string(content.substr(colon + 1, comma - colon - 1)));
+            cerebra::decode_number(std::string_view(content).substr(colon + 1, comma - colon - 1), val);
         }
     };
 
@@ -125,10 +135,15 @@ AppConfig loadConfigJSON(const std::string& filename) {
     parse_double("activity_decay_rate", config.activity_decay_rate);
     parse_int("synaptic_delay_frames", config.synaptic_delay_frames);
     parse_int("refractory_period_ms", config.refractory_period_ms);
+    parse_double("pathway_coupling", config.pathway_coupling);
+    parse_int("pathway_step_ms", config.pathway_step_ms);
     parse_double("noise_amplitude", config.noise_amplitude);
+    parse_int("random_seed", config.random_seed);
     parse_string("intensity_transform", config.intensity_transform);
     parse_double("ltp_threshold", config.ltp_threshold);
     parse_double("ltp_increment", config.ltp_increment);
+    parse_bool("enable_neurotransmitter_simulation", config.enable_neurotransmitter_simulation);
+    parse_int("modeling_threads", config.modeling_threads);
     parse_string("intensity_map", config.intensity_map);
     parse_string("output_log_file", config.output_log_file);
     parse_string("theme", config.theme);
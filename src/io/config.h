@@ -11,10 +11,15 @@ struct AppConfig {
     double activity_decay_rate = 0.1;
     int synaptic_delay_frames = 0;
     int refractory_period_ms = 0;
+    double pathway_coupling = 0.0; // 0 = no propagation along pathways
+    int pathway_step_ms = 100;     // frame interval pathway delays are counted in
     double noise_amplitude = 0.0;
+    int random_seed = 0; // noise is reproducible for a given seed
     std::string intensity_transform = "linear";
     double ltp_threshold = 0.8;
     double ltp_increment = 0.05;
+    bool enable_neurotransmitter_simulation = false;
+    int modeling_threads = 0; // 0 = one per hardware thread
     std::string intensity_map = "default";
     std::string output_log_file = "";
     std::string theme = "default";
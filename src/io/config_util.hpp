@@ -10,7 +10,9 @@
 #include <cstddef>
 #include <map>
 #include <string>
+#include <string_view>
 
+#include "io/json_document.h"
 #include "io/json_parser.h"
 
 namespace cerebra {
@@ -19,7 +21,7 @@ namespace config_util {
 inline double clamp01(double v) { return std::max(0.0, std::min(1.0, v)); }
 
 // Collapse runs of non-alphanumerics to single underscores; lowercase the rest.
-inline std::string slugify(const std::string& raw) {
+inline std::string slugify(std::string_view raw) {
   std::string out;
   bool last_sep = false;
   for (unsigned char c : raw) {
@@ -61,12 +63,14 @@ inline std::string short_code(const std::string& key, std::size_t max_len, const
 }
 
 // A JSON object's values flattened to a string map (string values verbatim,
-// everything else via dump()). Empty if `v` is not an object.
-inline std::map<std::string, std::string> parse_metadata(const JsonValue& v) {
+// everything else via dump()). Empty if `v` is not an object. `Json` is
+// JsonValue or JsonElement.
+template <typename Json>
+std::map<std::string, std::string> parse_metadata(const Json& v) {
   std::map<std::string, std::string> out;
   if (!v.is_object()) return out;
-  for (const auto& kv : v.as_object())
-    out[kv.first] = kv.second.is_string() ? kv.second.as_string() : kv.second.dump();
+  for (const auto& [key, value] : v.as_object())
+    out.emplace(std::string(key), value.is_string() ? std::string(value.as_string()) : value.dump());
   return out;
 }
 
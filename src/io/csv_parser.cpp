@@ -1,30 +1,234 @@
 #include "io/csv_parser.h"
-#include "core/data_parsing_hub.h"
-#include <sstream>
+#include "core/atlas_core.h"
+#include "core/thread_pool.h"
+#include "io/number_decode.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
 
 namespace cerebra {
 
-std::vector<cerebra::BrainFrame> parse_csv_frames(const std::string& csv) {
-    std::vector<cerebra::BrainFrame> frames;
-    std::stringstream ss(csv);
-    std::string line;
-    while (std::getline(ss, line)) {
-        std::stringstream ls(line);
-        std::string ts_s, name, intens_s;
-        if (std::getline(ls, ts_s, ',') && std::getline(ls, name, ',') && std::getline(ls, intens_s, ',')) {
-            std::int64_t ts = std::stoll(trim(ts_s));
-            cerebra::BrainFrame* f = nullptr;
-            for (auto& frame : frames) if (frame.timestamp_ms == ts) { f = &frame; break; }
-            if (!f) { frames.push_back({ts, {}}); f = &frames.back(); }
-            
-            cerebra::RegionState r;
-            r.region = internString(trim(name));
-            r.intensity = std::stod(trim(intens_s));
-            r.flows = default_flows_for(r.region, r.intensity);
-            f->regions.push_back(std::move(r));
-        }
-    }
-    return frames;
+namespace {
+
+// Inputs are cut into chunks of at least this many bytes, a few per thread.
+constexpr std::size_t kMinChunkBytes = std::size_t{1} << 20;
+constexpr std::size_t kChunksPerThread = 4;
+
+constexpr std::size_t kNoColumn = static_cast<std::size_t>(-1);
+
+struct CsvColumns {
+    std::size_t timestamp = 0;
+    std::size_t region = 1;
+    std::size_t intensity = 2;
+    std::vector<std::pair<std::string, std::size_t>> metrics;  // header name, column
+    std::size_t needed = 3;  // fields a row must have to be read
+};
+
+std::string_view trim_field(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t' || s.front() == '\r')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+    return s;
+}
+
+// Split `line` on commas into `fields`, reusing its storage.
+void split_fields(std::string_view line, std::vector<std::string_view>& fields) {
+    fields.clear();
+    for (;;) {
+        const std::size_t comma = line.find(',');
+        fields.push_back(trim_field(line.substr(0, comma)));
+        if (comma == std::string_view::npos) return;
+        line.remove_prefix(comma + 1);
+    }
+}
+
+// The next line of `text` from `pos`, without its newline; advances `pos`.
+std::string_view next_line(std::string_view text, std::size_t& pos) {
+    const char* start = text.data() + pos;
+    const void* nl = std::memchr(start, '\n', text.size() - pos);
+    const std::size_t len = nl ? static_cast<std::size_t>(static_cast<const char*>(nl) - start) : text.size() - pos;
+    pos += nl ? len + 1 : len;
+    return std::string_view(start, len);
+}
+
+std::string lower(std::string_view s) {
+    std::string out(s);
+    std::transform(out.begin(), out.end(), out.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return out;
+}
+
+bool is_timestamp_name(const std::string& name) {
+    return name == "timestamp_ms" || name == "timestamp" || name == "time_ms" || name == "time";
+}
+
+bool is_region_name(const std::string& name) {
+    return name == "region" || name == "region_key" || name == "name";
+}
+
+bool is_intensity_name(const std::string& name) {
+    return name == "intensity" || name == "value" || name == "activity";
+}
+
+// A header row names at least one of the required columns; anything else is
+// data, so a malformed first row reports its bad field instead.
+bool is_header(const std::vector<std::string_view>& row) {
+    for (std::string_view field : row) {
+        const std::string name = lower(field);
+        if (is_timestamp_name(name) || is_region_name(name) || is_intensity_name(name)) return true;
+    }
+    return false;
+}
+
+CsvColumns columns_from_header(const std::vector<std::string_view>& header) {
+    CsvColumns c;
+    c.timestamp = c.region = c.intensity = kNoColumn;
+    for (std::size_t i = 0; i < header.size(); ++i) {
+        const std::string name = lower(header[i]);
+        if (c.timestamp == kNoColumn && is_timestamp_name(name)) {
+            c.timestamp = i;
+        } else if (c.region == kNoColumn && is_region_name(name)) {
+            c.region = i;
+        } else if (c.intensity == kNoColumn && is_intensity_name(name)) {
+            c.intensity = i;
+        } else if (!header[i].empty()) {
+            c.metrics.emplace_back(std::string(header[i]), i);
+        }
+    }
+    if (c.timestamp == kNoColumn || c.region == kNoColumn || c.intensity == kNoColumn) {
+        throw std::invalid_argument("CSV header needs timestamp, region and intensity columns");
+    }
+    c.needed = std::max({c.timestamp, c.region, c.intensity}) + 1;
+    return c;
+}
+
+// Frames in order of first appearance, indexed by timestamp. Rows for one
+// timestamp are usually adjacent, so the last frame is checked before the map.
+class TimestampFrames {
+public:
+    BrainFrame& frame(std::int64_t ts) {
+        if (!frames_.empty() && frames_.back().timestamp_ms == ts) return frames_.back();
+        const auto [it, inserted] = index_.emplace(ts, frames_.size());
+        if (inserted) {
+            frames_.emplace_back();
+            frames_.back().timestamp_ms = ts;
+        }
+        return frames_[it->second];
+    }
+
+    std::vector<BrainFrame>& frames() { return frames_; }
+
+private:
+    std::vector<BrainFrame> frames_;
+    std::unordered_map<std::int64_t, std::size_t> index_;
+};
+
+void parse_chunk(std::string_view text, const CsvColumns& cols, const RegionAtlas& atlas, TimestampFrames& out) {
+    std::vector<std::string_view> fields;
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+        const std::string_view line = next_line(text, pos);
+        split_fields(line, fields);
+        if (fields.size() < cols.needed) continue;
+
+        std::int64_t ts = 0;
+        double intensity = 0.0;
+        const std::string_view ts_s = fields[cols.timestamp];
+        const std::string_view intens_s = fields[cols.intensity];
+        if (decode_number(ts_s, ts) != std::errc()) {
+            throw std::invalid_argument("CSV: bad timestamp '" + std::string(ts_s) + "'");
+        }
+        if (decode_number(intens_s, intensity) != std::errc()) {
+            throw std::invalid_argument("CSV: bad intensity '" + std::string(intens_s) + "'");
+        }
+
+        RegionState rs;
+        rs.region = std::string(fields[cols.region]);
+        rs.region_id = atlas.id_of(rs.region);
+        rs.intensity = intensity;
+        rs.use_atlas_flows();
+        for (const auto& [name, col] : cols.metrics) {
+            double v = 0.0;
+            if (col < fields.size() && !fields[col].empty() && decode_number(fields[col], v) == std::errc()) {
+                rs.mutable_detail().metrics[name] = v;
+            }
+        }
+        out.frame(ts).regions.push_back(std::move(rs));
+    }
+}
+
+std::vector<BrainFrame> parse_csv(std::string_view csv, ThreadPool* pool) {
+    // The header, if any, is the first non-blank row.
+    std::size_t body = 0;
+    std::vector<std::string_view> fields;
+    while (body < csv.size()) {
+        const std::size_t line_start = body;
+        const std::string_view line = next_line(csv, body);
+        if (trim_field(line).empty()) continue;
+        split_fields(line, fields);
+        if (!is_header(fields)) {
+            body = line_start;
+            fields.clear();
+        }
+        break;
+    }
+    const CsvColumns cols = fields.empty() ? CsvColumns{} : columns_from_header(fields);
+    const std::string_view text = csv.substr(body);
+
+    // Chunk boundaries, each just past a newline.
+    const std::size_t threads = pool ? pool->concurrency() : 1;
+    const std::size_t chunks = std::max<std::size_t>(1, std::min(threads * kChunksPerThread, text.size() / kMinChunkBytes));
+    std::vector<std::size_t> bounds{0};
+    for (std::size_t k = 1; k < chunks; ++k) {
+        std::size_t at = std::max(bounds.back(), text.size() * k / chunks);
+        const void* nl = std::memchr(text.data() + at, '\n', text.size() - at);
+        at = nl ? static_cast<std::size_t>(static_cast<const char*>(nl) - text.data()) + 1 : text.size();
+        bounds.push_back(at);
+    }
+    bounds.push_back(text.size());
+
+    const auto snapshot = acquire_atlas_snapshot();
+    const RegionAtlas& atlas = snapshot->atlas;
+    std::vector<TimestampFrames> parts(chunks);
+    auto parse_range = [&](std::size_t begin, std::size_t end) {
+        for (std::size_t c = begin; c < end; ++c) {
+            parse_chunk(text.substr(bounds[c], bounds[c + 1] - bounds[c]), cols, atlas, parts[c]);
+        }
+    };
+    if (chunks == 1) {
+        parse_range(0, 1);
+        return std::move(parts[0].frames());
+    }
+    pool->parallel_for(chunks, 1, chunks, parse_range);
+
+    // Merge in chunk order, which keeps both the frame order and the row
+    // order within each frame of a sequential read.
+    TimestampFrames merged;
+    for (auto& part : parts) {
+        for (auto& f : part.frames()) {
+            auto& regions = merged.frame(f.timestamp_ms).regions;
+            if (regions.empty()) {
+                regions = std::move(f.regions);
+            } else {
+                regions.insert(regions.end(), std::make_move_iterator(f.regions.begin()),
+                               std::make_move_iterator(f.regions.end()));
+            }
+        }
+    }
+    return std::move(merged.frames());
+}
+
+} // namespace
+
+std::vector<cerebra::BrainFrame> parse_csv_frames(std::string_view csv) {
+    // Small inputs are a single chunk; only large ones start the shared pool.
+    return parse_csv(csv, csv.size() >= 2 * kMinChunkBytes ? &ThreadPool::shared() : nullptr);
+}
+
+std::vector<cerebra::BrainFrame> parse_csv_frames(std::string_view csv, ThreadPool& pool) {
+    return parse_csv(csv, &pool);
 }
 
 } // namespace cerebra
@@ -2,7 +2,27 @@
 #include "core/state_manager.h"
 #include <vector>
 #include <string>
+#include <string_view>
 
 namespace cerebra {
-std::vector<cerebra::BrainFrame> parse_csv_frames(const std::string& csv);
+
+class ThreadPool;
+
+// Activity samples as CSV, one region reading per row:
+//   timestamp_ms,region,intensity[,metric...]
+// A first row whose leading field is not a number is a header naming the
+// columns, in any order: timestamp (timestamp_ms, time_ms, time), region
+// (region_key, name), intensity (value, activity); every other named column
+// is a numeric metric stored in the region's detail, skipped where blank.
+// Without a header the first three columns are used and the rest ignored.
+// Rows with too few fields are skipped; a malformed number throws
+// std::invalid_argument.
+//
+// Frames come out in order of each timestamp's first row, with regions in
+// row order. Large inputs are cut into newline-aligned chunks parsed in
+// parallel on `pool` (ThreadPool::shared() by default) and merged by
+// timestamp, in time linear in the input.
+std::vector<cerebra::BrainFrame> parse_csv_frames(std::string_view csv);
+std::vector<cerebra::BrainFrame> parse_csv_frames(std::string_view csv, ThreadPool& pool);
+
 }
@@ -51,7 +51,7 @@ std::string exportToSVG(const std::vector<cerebra::BrainFrame>& frames) {
     oss << "<svg xmlns='http://www.w3.org/2000/svg' viewBox='0 0 500 500'>\n";
     for (const auto& f : frames) {
         for (const auto& r : f.regions) {
-            oss << "<circle cx='" << (r.x * 400 + 50) << "' cy='" << (r.y * 400 + 50)
+            oss << "<circle cx='" << (r.detail().x * 400 + 50) << "' cy='" << (r.detail().y * 400 + 50)
                 << "' r='" << (r.intensity * 20 + 5) << "' fill='red' opacity='0.5'/>\n";
         }
     }
@@ -73,7 +73,7 @@ void exportToPNG(const std::vector<cerebra::BrainFrame>& frames, const AppConfig
         for(int y=0; y<h; y++) {
             pixels[y*(w*3+1)] = 0;
             for(const auto& r : frames[fIdx].regions) {
-                int cx = (int)(r.x * 255), cy = (int)(r.y * 255);
+                int cx = (int)(r.detail().x * 255), cy = (int)(r.detail().y * 255);
                 if(std::abs(cy-y) < 10) {
                     for(int x=std::max(0,cx-10); x<std::min(256,cx+10); x++) {
                         pixels[y*(w*3+1) + 1 + x*3] = (unsigned char)(r.intensity*255);
@@ -113,7 +113,7 @@ void exportToBMP(const std::vector<cerebra::BrainFrame>& frames, const AppConfig
         ofs.write((char*)fileHeader, 14); ofs.write((char*)infoHeader, 40);
         std::vector<unsigned char> pixels(3*w*h, 0);
         for (const auto& r : f.regions) {
-            int cx = (int)(r.x * 255), cy = (int)(r.y * 255);
+            int cx = (int)(r.detail().x * 255), cy = (int)(r.detail().y * 255);
             for(int dy=-5; dy<=5; ++dy) for(int dx=-5; dx<=5; ++dx) {
                 int nx = cx+dx, ny = cy+dy;
                 if(nx>=0 && nx<w && ny>=0 && ny<h) {
@@ -154,7 +154,7 @@ void exportToGIF(const std::vector<cerebra::BrainFrame>& frames, const AppConfig
         pack(0x80, 9);
         for(int i=0; i<w*h; i++) {
             unsigned char p = 0;
-            for(const auto& r : f.regions) if(std::abs(r.x*255-(i%256))<10 && std::abs(r.y*255-(i/256))<10) p=(unsigned char)(r.intensity*255);
+            for(const auto& r : f.regions) if(std::abs(r.detail().x*255-(i%256))<10 && std::abs(r.detail().y*255-(i/256))<10) p=(unsigned char)(r.intensity*255);
             pack(p, 9);
         }
         pack(0x81, 9);
@@ -0,0 +1,169 @@
+#include "io/json_document.h"
+#include "io/json_tape.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <sstream>
+
+namespace cerebra {
+
+namespace {
+
+// Objects up to this size are scanned rather than bisected.
+constexpr std::uint32_t kLinearLookup = 8;
+
+const JsonMember* find_member(const JsonMember* members, std::uint32_t size, std::string_view key) {
+    if (size <= kLinearLookup) {
+        for (std::uint32_t k = 0; k < size; ++k) {
+            if (members[k].key == key) return members + k;
+        }
+        return nullptr;
+    }
+    const JsonMember* it = std::lower_bound(members, members + size, key,
+                                            [](const JsonMember& m, std::string_view k) { return m.key < k; });
+    return it != members + size && it->key == key ? it : nullptr;
+}
+
+} // namespace
+
+const JsonElement& JsonElement::operator[](std::string_view key) const {
+    static const JsonElement kNull;
+    if (!is_object()) return kNull;
+    const JsonMember* m = find_member(members_, size_, key);
+    return m ? m->value : kNull;
+}
+
+const JsonElement& JsonElement::operator[](std::size_t index) const {
+    static const JsonElement kNull;
+    return is_array() && index < size_ ? items_[index] : kNull;
+}
+
+bool JsonElement::contains(std::string_view key) const {
+    return is_object() && find_member(members_, size_, key) != nullptr;
+}
+
+std::string JsonElement::dump() const {
+    switch (type_) {
+        case Type::Bool: return boolean_ ? "true" : "false";
+        case Type::Number: {
+            std::ostringstream os; os << number_; return os.str();
+        }
+        case Type::String: return "\"" + std::string(as_string()) + "\"";
+        case Type::Array: {
+            std::string out = "[";
+            for (std::uint32_t k = 0; k < size_; ++k) {
+                if (k) out += ",";
+                out += items_[k].dump();
+            }
+            return out + "]";
+        }
+        case Type::Object: {
+            std::string out = "{";
+            for (std::uint32_t k = 0; k < size_; ++k) {
+                if (k) out += ",";
+                out += "\"" + std::string(members_[k].key) + "\":" + members_[k].value.dump();
+            }
+            return out + "}";
+        }
+        default: return "null";
+    }
+}
+
+// Where the next array elements and object members go, and the arena's
+// copies of the source text and the tape's unescaped strings.
+struct JsonDocument::Cursor {
+    JsonElement* elements;
+    JsonMember* members;
+    const char* source;
+    const char* strings;
+
+    std::string_view text(const JsonTape::Entry& e) const {
+        return std::string_view((e.unescaped() ? strings : source) + e.offset(), e.count());
+    }
+};
+
+void JsonDocument::build(const JsonTape& tape, std::size_t& i, JsonElement& out, Cursor& at) {
+    const JsonTape::Entry& e = tape.entries()[i++];
+    switch (e.type()) {
+        case JsonTape::Type::True:
+        case JsonTape::Type::False:
+            out.type_ = JsonElement::Type::Bool;
+            out.boolean_ = e.type() == JsonTape::Type::True;
+            break;
+        case JsonTape::Type::Number:
+            out.type_ = JsonElement::Type::Number;
+            out.number_ = tape.number(e);
+            break;
+        case JsonTape::Type::String:
+            out.type_ = JsonElement::Type::String;
+            out.size_ = e.count();
+            out.chars_ = at.text(e).data();
+            break;
+        case JsonTape::Type::StartArray: {
+            JsonElement* items = at.elements;
+            at.elements += e.count();
+            for (std::uint32_t k = 0; k < e.count(); ++k) build(tape, i, *new (items + k) JsonElement(), at);
+            ++i;
+            out.type_ = JsonElement::Type::Array;
+            out.size_ = e.count();
+            out.items_ = items;
+            break;
+        }
+        case JsonTape::Type::StartObject: {
+            JsonMember* members = at.members;
+            at.members += e.count();
+            for (std::uint32_t k = 0; k < e.count(); ++k) {
+                JsonMember* m = new (members + k) JsonMember{at.text(tape.entries()[i++]), JsonElement()};
+                build(tape, i, m->value, at);
+            }
+            ++i;
+            // Stable, so after unique() each key keeps its first occurrence.
+            std::stable_sort(members, members + e.count(),
+                             [](const JsonMember& a, const JsonMember& b) { return a.key < b.key; });
+            const JsonMember* last = std::unique(members, members + e.count(),
+                                                 [](const JsonMember& a, const JsonMember& b) { return a.key == b.key; });
+            out.type_ = JsonElement::Type::Object;
+            out.size_ = static_cast<std::uint32_t>(last - members);
+            out.members_ = members;
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+JsonDocument JsonDocument::parse(std::string_view json) {
+    const JsonTape tape = JsonTape::parse(json);
+
+    // Every element except the root is an array item; members are counted
+    // before duplicate keys are dropped, so the sizes are upper bounds.
+    std::size_t elements = 1, members = 0;
+    for (const auto& e : tape.entries()) {
+        if (e.type() == JsonTape::Type::StartArray) elements += e.count();
+        if (e.type() == JsonTape::Type::StartObject) members += e.count();
+    }
+    const std::size_t element_bytes = elements * sizeof(JsonElement);
+    const std::size_t member_bytes = members * sizeof(JsonMember);
+
+    JsonDocument doc;
+    doc.arena_bytes_ = element_bytes + member_bytes + json.size() + tape.strings().size();
+    doc.arena_.reset(new std::max_align_t[(doc.arena_bytes_ + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t)]);
+    char* base = reinterpret_cast<char*>(doc.arena_.get());
+    char* text = base + element_bytes + member_bytes;
+    std::memcpy(text, json.data(), json.size());
+    std::memcpy(text + json.size(), tape.strings().data(), tape.strings().size());
+
+    Cursor at{reinterpret_cast<JsonElement*>(base) + 1, reinterpret_cast<JsonMember*>(base + element_bytes), text,
+              text + json.size()};
+    std::size_t i = 0;
+    build(tape, i, *new (base) JsonElement(), at);
+    return doc;
+}
+
+const JsonElement& JsonDocument::root() const {
+    static const JsonElement kNull;
+    return arena_ ? *reinterpret_cast<const JsonElement*>(arena_.get()) : kNull;
+}
+
+} // namespace cerebra
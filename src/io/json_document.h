@@ -0,0 +1,118 @@
+#pragma once
+
+#include "io/json_parser.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace cerebra {
+
+class JsonTape;
+struct JsonMember;
+
+// A contiguous run of array elements or object members in a JsonDocument.
+template <typename T>
+class JsonRange {
+public:
+    JsonRange() = default;
+    JsonRange(const T* first, std::size_t size) : first_(first), size_(size) {}
+
+    const T* begin() const { return first_; }
+    const T* end() const { return first_ + size_; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const T& operator[](std::size_t i) const { return first_[i]; }
+
+private:
+    const T* first_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+/**
+ * A read-only value inside a JsonDocument, with the accessors of JsonValue.
+ * Strings are views and containers point at their members, all inside the
+ * document's arena, so an element is only valid while its document lives.
+ */
+class JsonElement {
+public:
+    enum class Type : std::uint8_t { Null, Bool, Number, String, Array, Object };
+
+    JsonElement() : type_(Type::Null), size_(0), number_(0.0) {}
+
+    Type type() const { return type_; }
+    bool is_null()   const { return type_ == Type::Null; }
+    bool is_bool()   const { return type_ == Type::Bool; }
+    bool is_number() const { return type_ == Type::Number; }
+    bool is_string() const { return type_ == Type::String; }
+    bool is_array()  const { return type_ == Type::Array; }
+    bool is_object() const { return type_ == Type::Object; }
+
+    bool as_bool(bool fallback = false) const { return is_bool() ? boolean_ : fallback; }
+    double as_number(double fallback = 0.0) const { return is_number() ? number_ : fallback; }
+    std::int64_t as_int(std::int64_t fallback = 0) const { return is_number() ? (std::int64_t)number_ : fallback; }
+    std::string_view as_string() const { return is_string() ? std::string_view(chars_, size_) : std::string_view(); }
+    JsonRange<JsonElement> as_array() const;
+    JsonRange<JsonMember> as_object() const;  // sorted by key, each key once
+
+    // A null element when the key or index is absent or this is the wrong type.
+    const JsonElement& operator[](std::string_view key) const;
+    const JsonElement& operator[](std::size_t index) const;
+    bool contains(std::string_view key) const;
+
+    std::string dump() const;
+
+private:
+    friend class JsonDocument;
+
+    Type type_;
+    std::uint32_t size_;  // String: bytes; Array/Object: members
+    union {
+        bool boolean_;
+        double number_;
+        const char* chars_;
+        const JsonElement* items_;
+        const JsonMember* members_;
+    };
+};
+
+struct JsonMember {
+    std::string_view key;
+    JsonElement value;
+};
+
+inline JsonRange<JsonElement> JsonElement::as_array() const {
+    return is_array() ? JsonRange<JsonElement>(items_, size_) : JsonRange<JsonElement>();
+}
+
+inline JsonRange<JsonMember> JsonElement::as_object() const {
+    return is_object() ? JsonRange<JsonMember>(members_, size_) : JsonRange<JsonMember>();
+}
+
+/**
+ * A parsed JSON document for loaders that need random access (atlases,
+ * catalogs, config). Every element, member array and string, plus a copy of
+ * the source text that unescaped strings view into, lives in one allocation
+ * sized exactly from the tape, which is released in one go with the
+ * document. Objects are key-sorted member arrays: the first of a repeated key
+ * wins, as with JsonValue.
+ */
+class JsonDocument {
+public:
+    // Throws JsonParseError with the byte offset of the first error.
+    static JsonDocument parse(std::string_view json);
+
+    const JsonElement& root() const;
+    std::size_t arena_bytes() const { return arena_bytes_; }
+
+private:
+    struct Cursor;
+    static void build(const JsonTape& tape, std::size_t& i, JsonElement& out, Cursor& at);
+
+    std::unique_ptr<std::max_align_t[]> arena_;
+    std::size_t arena_bytes_ = 0;
+};
+
+} // namespace cerebra
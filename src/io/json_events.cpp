@@ -0,0 +1,451 @@
+#include "io/json_events.h"
+#include "io/json_tape.h"
+
+#include <charconv>
+#include <cstdint>
+#include <istream>
+
+namespace cerebra {
+
+namespace {
+
+constexpr std::size_t kChunkBytes = 1 << 16;
+
+// The characters std::isspace accepts in the C locale, which is what the
+// DOM parser skips.
+bool is_space(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+bool is_number_char(char c) {
+    return (c >= '0' && c <= '9') || c == '.' || c == '-' || c == '+' || c == 'e' || c == 'E';
+}
+
+int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+constexpr std::uint32_t kReplacementChar = 0xFFFD;
+
+// Single-pass pull parser over either an in-memory buffer or a stream read
+// through a fixed window. Containers are tracked on an explicit stack, so
+// nesting depth costs one byte per level and no recursion.
+class EventParser {
+public:
+    EventParser(JsonEventHandler& handler, std::string_view text) : handler_(handler), window_(text) {}
+    EventParser(JsonEventHandler& handler, std::istream& in)
+        : handler_(handler), in_(&in), buffer_(kChunkBytes, '\0') {}
+
+    void run();
+
+private:
+    enum class Expect { Value, FirstKey, Key, FirstElement, Next };
+
+    std::size_t offset() const { return base_ + pos_; }
+    [[noreturn]] void fail(const char* what, std::size_t at) const { throw JsonParseError(what, at); }
+
+    // True when a byte is available at pos_, reading the next chunk once the
+    // window is used up.
+    bool more() {
+        if (pos_ < window_.size()) return true;
+        if (!in_) return false;
+        base_ += window_.size();
+        in_->read(&buffer_[0], static_cast<std::streamsize>(buffer_.size()));
+        window_ = std::string_view(buffer_.data(), static_cast<std::size_t>(in_->gcount()));
+        pos_ = 0;
+        return !window_.empty();
+    }
+
+    void skip_ws() {
+        while (more()) {
+            while (pos_ < window_.size() && is_space(window_[pos_])) ++pos_;
+            if (pos_ < window_.size()) return;
+        }
+    }
+
+    Expect value(char c);
+    std::string_view read_string();
+    void read_escape();
+    std::uint32_t read_hex4();
+    void read_number();
+    void read_literal(std::string_view word);
+
+    JsonEventHandler& handler_;
+    std::istream* in_ = nullptr;
+    std::string buffer_;
+    std::string_view window_;
+    std::size_t pos_ = 0;   // within window_
+    std::size_t base_ = 0;  // document offset of window_
+    std::string scratch_;   // strings with escapes, tokens split across chunks
+    std::vector<char> stack_;
+};
+
+void EventParser::run() {
+    Expect state = Expect::Value;
+    for (;;) {
+        skip_ws();
+        const bool have = pos_ < window_.size();
+        const char c = have ? window_[pos_] : '\0';
+        switch (state) {
+            case Expect::FirstElement:
+                if (c == ']') {
+                    ++pos_;
+                    stack_.pop_back();
+                    handler_.on_end_array();
+                    state = Expect::Next;
+                    break;
+                }
+                state = value(c);
+                break;
+            case Expect::Value:
+                state = value(c);
+                break;
+            case Expect::FirstKey:
+                if (c == '}') {
+                    ++pos_;
+                    stack_.pop_back();
+                    handler_.on_end_object();
+                    state = Expect::Next;
+                    break;
+                }
+                [[fallthrough]];
+            case Expect::Key:
+                if (c != '"') fail("Expected '\"'", offset());
+                handler_.on_key(read_string());
+                skip_ws();
+                if (pos_ >= window_.size() || window_[pos_] != ':') fail("Expected ':'", offset());
+                ++pos_;
+                state = Expect::Value;
+                break;
+            case Expect::Next: {
+                if (stack_.empty()) {
+                    if (have) fail("Extra data after JSON", offset());
+                    return;
+                }
+                const bool object = stack_.back() == '{';
+                if (c == ',') {
+                    ++pos_;
+                    state = object ? Expect::Key : Expect::Value;
+                } else if (c == (object ? '}' : ']')) {
+                    ++pos_;
+                    stack_.pop_back();
+                    if (object) handler_.on_end_object();
+                    else handler_.on_end_array();
+                } else {
+                    fail(object ? "Expected ',' or '}'" : "Expected ',' or ']'", offset());
+                }
+                break;
+            }
+        }
+    }
+}
+
+EventParser::Expect EventParser::value(char c) {
+    switch (c) {
+        case '{':
+            ++pos_;
+            stack_.push_back('{');
+            handler_.on_start_object();
+            return Expect::FirstKey;
+        case '[':
+            ++pos_;
+            stack_.push_back('[');
+            handler_.on_start_array();
+            return Expect::FirstElement;
+        case '"':
+            handler_.on_string(read_string());
+            return Expect::Next;
+        case 't':
+            read_literal("true");
+            handler_.on_bool(true);
+            return Expect::Next;
+        case 'f':
+            read_literal("false");
+            handler_.on_bool(false);
+            return Expect::Next;
+        case 'n':
+            read_literal("null");
+            handler_.on_null();
+            return Expect::Next;
+        default:
+            if (c == '-' || (c >= '0' && c <= '9')) {
+                read_number();
+                return Expect::Next;
+            }
+            fail("Unexpected character", offset());
+    }
+}
+
+std::string_view EventParser::read_string() {
+    ++pos_;
+    const std::size_t begin = pos_;
+    // Common case: no escapes and the closing quote is in this window.
+    while (pos_ < window_.size()) {
+        const char c = window_[pos_];
+        if (c == '"') return window_.substr(begin, pos_++ - begin);
+        if (c == '\\') break;
+        ++pos_;
+    }
+    scratch_.assign(window_.data() + begin, pos_ - begin);
+    for (;;) {
+        if (!more()) fail("Unterminated string", offset());
+        const std::size_t run = pos_;
+        while (pos_ < window_.size() && window_[pos_] != '"' && window_[pos_] != '\\') ++pos_;
+        scratch_.append(window_.data() + run, pos_ - run);
+        if (pos_ == window_.size()) continue;
+        if (window_[pos_++] == '"') return scratch_;
+        read_escape();
+    }
+}
+
+// After a backslash: decode one escape into scratch_.
+void EventParser::read_escape() {
+    if (!more()) fail("Unterminated string", offset());
+    const char e = window_[pos_++];
+    switch (e) {
+        case 'b': scratch_ += '\b'; return;
+        case 'f': scratch_ += '\f'; return;
+        case 'n': scratch_ += '\n'; return;
+        case 'r': scratch_ += '\r'; return;
+        case 't': scratch_ += '\t'; return;
+        case 'u': break;
+        default:  scratch_ += e; return;  // \" \\ \/ and, leniently, anything else
+    }
+    std::uint32_t cp = read_hex4();
+    if (cp >= 0xD800 && cp < 0xDC00) {
+        // A high surrogate must be followed by an escaped low one.
+        if (more() && window_[pos_] == '\\') {
+            ++pos_;
+            if (more() && window_[pos_] == 'u') {
+                ++pos_;
+                const std::uint32_t low = read_hex4();
+                if (low >= 0xDC00 && low < 0xE000) {
+                    append_utf8(scratch_, 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00));
+                } else {
+                    append_utf8(scratch_, kReplacementChar);
+                    append_utf8(scratch_, low >= 0xD800 && low < 0xE000 ? kReplacementChar : low);
+                }
+                return;
+            }
+            // An ordinary escape follows the lone high surrogate.
+            append_utf8(scratch_, kReplacementChar);
+            read_escape();
+            return;
+        }
+        cp = kReplacementChar;
+    } else if (cp >= 0xDC00 && cp < 0xE000) {
+        cp = kReplacementChar;
+    }
+    append_utf8(scratch_, cp);
+}
+
+std::uint32_t EventParser::read_hex4() {
+    std::uint32_t cp = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (!more()) fail("Unterminated string", offset());
+        const int digit = hex_value(window_[pos_]);
+        if (digit < 0) fail("Invalid \\u escape", offset());
+        cp = cp << 4 | static_cast<std::uint32_t>(digit);
+        ++pos_;
+    }
+    return cp;
+}
+
+void EventParser::read_number() {
+    const std::size_t start = offset();
+    const std::size_t begin = pos_;
+    while (pos_ < window_.size() && is_number_char(window_[pos_])) ++pos_;
+    std::string_view token = window_.substr(begin, pos_ - begin);
+    if (pos_ == window_.size() && in_) {
+        // The number may run on into the next chunk.
+        scratch_.assign(token.data(), token.size());
+        while (more() && is_number_char(window_[pos_])) scratch_ += window_[pos_++];
+        token = scratch_;
+    }
+    double v = 0.0;
+    const auto [end, ec] = std::from_chars(token.data(), token.data() + token.size(), v);
+    if (ec == std::errc::result_out_of_range) fail("Number out of range", start);
+    if (ec != std::errc() || end != token.data() + token.size()) fail("Invalid number", start);
+    handler_.on_number(v);
+}
+
+void EventParser::read_literal(std::string_view word) {
+    const std::size_t start = offset();
+    for (char expected : word) {
+        if (!more() || window_[pos_] != expected) fail("Invalid literal", start);
+        ++pos_;
+    }
+}
+
+// Assembles frames of the activity format from events. A value's role is
+// fixed by its depth: with `frame_depth_` the depth at which frame values
+// arrive, frame members sit one level below, brain_activity elements two,
+// entry members three and metrics members four.
+class FrameAssembler : public JsonEventHandler {
+public:
+    explicit FrameAssembler(const JsonFrameCallback& on_frame) : on_frame_(on_frame) {}
+
+    JsonFrameLayout layout() const { return layout_; }
+
+    void on_null() override { scalar(); }
+    void on_bool(bool) override { scalar(); }
+    void on_string(std::string_view s) override {
+        if (field_ == Field::Region && in(Level::Entry)) entry().region.assign(s.data(), s.size());
+        scalar();
+    }
+    void on_number(double v) override {
+        if (field_ == Field::Timestamp && in(Level::Frame)) frame_.timestamp_ms = v;
+        else if (field_ == Field::Intensity && in(Level::Entry)) entry().intensity = v;
+        else if (field_ == Field::Metric && in(Level::Metrics)) entry().metrics.emplace_back(metric_key_, v);
+        scalar();
+    }
+
+    void on_key(std::string_view key) override {
+        field_ = Field::Other;
+        if (in(Level::Frame)) {
+            if (key == "timestamp_ms") claim(Field::Timestamp, seen_timestamp_);
+            else if (key == "brain_activity") claim(Field::Activity, seen_activity_);
+        } else if (in(Level::Entry)) {
+            if (key == "region") claim(Field::Region, seen_region_);
+            else if (key == "intensity") claim(Field::Intensity, seen_intensity_);
+            else if (key == "metrics") claim(Field::Metrics, seen_metrics_);
+        } else if (in(Level::Metrics)) {
+            for (const auto& k : metric_keys_) {
+                if (k == key) return;
+            }
+            metric_keys_.emplace_back(key);
+            metric_key_.assign(key.data(), key.size());
+            field_ = Field::Metric;
+        }
+    }
+
+    void on_start_object() override {
+        if (depth_ == 0) {
+            layout_ = JsonFrameLayout::Single;
+            frame_depth_ = 0;
+            begin_frame(true);
+        } else if (depth_ == frame_depth_ && layout_ == JsonFrameLayout::Array) {
+            begin_frame(true);
+        } else if (in(Level::Activity)) {
+            frame_.entries.emplace_back();
+            entry_open_ = true;
+            seen_region_ = seen_intensity_ = seen_metrics_ = false;
+        } else if (field_ == Field::Metrics && in(Level::Entry)) {
+            metrics_open_ = true;
+            metric_keys_.clear();
+        }
+        field_ = Field::Other;
+        ++depth_;
+    }
+
+    void on_end_object() override { close(); }
+
+    void on_start_array() override {
+        if (depth_ == 0) {
+            layout_ = JsonFrameLayout::Array;
+            frame_depth_ = 1;
+        } else if (depth_ == frame_depth_ && layout_ == JsonFrameLayout::Array) {
+            begin_frame(false);
+        } else if (field_ == Field::Activity && in(Level::Frame)) {
+            frame_.has_activity = true;
+            activity_open_ = true;
+        } else if (in(Level::Activity)) {
+            frame_.entries_are_objects = false;
+        }
+        field_ = Field::Other;
+        ++depth_;
+    }
+
+    void on_end_array() override { close(); }
+
+private:
+    enum class Field { Other, Timestamp, Activity, Region, Intensity, Metrics, Metric };
+    enum class Level { Frame = 1, Activity, Entry, Metrics };
+
+    // True when the next event is a direct member of the container at `level`.
+    bool in(Level level) const {
+        if (depth_ != frame_depth_ + static_cast<std::size_t>(level)) return false;
+        switch (level) {
+            case Level::Frame: return frame_open_ && frame_.is_object;
+            case Level::Activity: return activity_open_;
+            case Level::Entry: return entry_open_;
+            case Level::Metrics: return metrics_open_;
+        }
+        return false;
+    }
+
+    void claim(Field field, bool& seen) {
+        if (!seen) field_ = field;
+        seen = true;
+    }
+
+    JsonFrameRecord::Entry& entry() { return frame_.entries.back(); }
+
+    void begin_frame(bool is_object) {
+        frame_.is_object = is_object;
+        frame_.timestamp_ms = 0.0;
+        frame_.has_activity = false;
+        frame_.entries_are_objects = true;
+        frame_.entries.clear();
+        frame_open_ = true;
+        seen_timestamp_ = seen_activity_ = false;
+    }
+
+    void end_frame() {
+        frame_open_ = false;
+        on_frame_(frame_);
+    }
+
+    void scalar() {
+        if (depth_ == frame_depth_ && layout_ == JsonFrameLayout::Array) {
+            begin_frame(false);
+            end_frame();
+        } else if (in(Level::Activity)) {
+            frame_.entries_are_objects = false;
+        }
+        field_ = Field::Other;
+    }
+
+    // The container opened at depth_ - 1 has ended.
+    void close() {
+        --depth_;
+        field_ = Field::Other;
+        if (depth_ == frame_depth_ && frame_open_) end_frame();
+        else if (depth_ == frame_depth_ + 1) activity_open_ = false;
+        else if (depth_ == frame_depth_ + 2) entry_open_ = false;
+        else if (depth_ == frame_depth_ + 3) metrics_open_ = false;
+    }
+
+    const JsonFrameCallback& on_frame_;
+    JsonFrameLayout layout_ = JsonFrameLayout::None;
+    std::size_t depth_ = 0;
+    std::size_t frame_depth_ = 1;
+    Field field_ = Field::Other;
+    JsonFrameRecord frame_;
+    bool frame_open_ = false, activity_open_ = false, entry_open_ = false, metrics_open_ = false;
+    bool seen_timestamp_ = false, seen_activity_ = false;
+    bool seen_region_ = false, seen_intensity_ = false, seen_metrics_ = false;
+    std::string metric_key_;
+    std::vector<std::string> metric_keys_;
+};
+
+} // namespace
+
+void parse_json_events(std::string_view json, JsonEventHandler& handler) { EventParser(handler, json).run(); }
+
+void parse_json_events(std::istream& in, JsonEventHandler& handler) { EventParser(handler, in).run(); }
+
+JsonFrameLayout read_json_frames(std::string_view json, const JsonFrameCallback& on_frame) {
+    FrameAssembler assembler(on_frame);
+    parse_json_events(json, assembler);
+    return assembler.layout();
+}
+
+JsonFrameLayout read_json_frames(std::istream& in, const JsonFrameCallback& on_frame) {
+    FrameAssembler assembler(on_frame);
+    parse_json_events(in, assembler);
+    return assembler.layout();
+}
+
+} // namespace cerebra
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "io/json_parser.h"
+
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cerebra {
+
+/**
+ * Receives the events of a JSON document in document order. String views
+ * passed to the callbacks are only valid for the duration of the call.
+ */
+class JsonEventHandler {
+public:
+    virtual ~JsonEventHandler() = default;
+
+    virtual void on_null() {}
+    virtual void on_bool(bool) {}
+    virtual void on_number(double) {}
+    virtual void on_string(std::string_view) {}
+    virtual void on_key(std::string_view) {}
+    virtual void on_start_object() {}
+    virtual void on_end_object() {}
+    virtual void on_start_array() {}
+    virtual void on_end_array() {}
+};
+
+// Parse one JSON document in a single pass, delivering events to `handler`
+// without building a tree. Strings without escapes are handed over as views
+// into the input; the stream overload reads `in` in fixed-size chunks, so
+// auxiliary memory is bounded by the nesting depth and the longest string or
+// number rather than the document size. Throws JsonParseError with the byte
+// offset of the first error; events before it have already been delivered.
+void parse_json_events(std::string_view json, JsonEventHandler& handler);
+void parse_json_events(std::istream& in, JsonEventHandler& handler);
+
+// One frame of the array-of-frames activity format:
+//   {"timestamp_ms": 0, "brain_activity": [
+//       {"region": "amygdala", "intensity": 0.6, "metrics": {"snr": 3.1}}, ...]}
+// Fields keep the DOM's rules: the first of a repeated key wins, a value of
+// the wrong type reads as absent, and unknown keys are skipped.
+struct JsonFrameRecord {
+    struct Entry {
+        std::string region;  // empty when absent or not a string
+        double intensity = 0.0;
+        std::vector<std::pair<std::string, double>> metrics;  // numeric members, first occurrence
+    };
+
+    bool is_object = false;       // false for a non-object array element
+    double timestamp_ms = 0.0;
+    bool has_activity = false;    // "brain_activity" was an array
+    bool entries_are_objects = true;
+    std::vector<Entry> entries;   // the object entries of "brain_activity", in order
+};
+
+enum class JsonFrameLayout {
+    Array,   // a top-level array of frames
+    Single,  // a top-level object read as one frame
+    None,    // any other top-level value; no frames
+};
+
+// Stream the frames of an activity document to `on_frame` as each one is
+// complete, holding only the current frame in memory.
+using JsonFrameCallback = std::function<void(const JsonFrameRecord&)>;
+JsonFrameLayout read_json_frames(std::string_view json, const JsonFrameCallback& on_frame);
+JsonFrameLayout read_json_frames(std::istream& in, const JsonFrameCallback& on_frame);
+
+} // namespace cerebra
@@ -0,0 +1,566 @@
+#include "io/json_tape.h"
+#include "io/number_decode.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define CEREBRA_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace cerebra {
+
+namespace {
+
+// Per-byte class bits for one 64-byte block; bit i is byte i.
+struct BlockMasks {
+    std::uint64_t quote = 0;
+    std::uint64_t backslash = 0;
+    std::uint64_t structural = 0;  // { } [ ] : ,
+};
+
+// Classifies `blocks` consecutive 64-byte blocks into out[0..blocks). Kernels
+// take a run of blocks so the dispatch and constant setup are paid per run.
+using ClassifyFn = void (*)(const char*, std::size_t, BlockMasks*);
+
+void classify_scalar(const char* p, std::size_t blocks, BlockMasks* out) {
+    for (std::size_t b = 0; b < blocks; ++b, p += 64) {
+        BlockMasks& m = out[b];
+        m = BlockMasks{};
+        for (int i = 0; i < 64; ++i) {
+            const unsigned char c = static_cast<unsigned char>(p[i]);
+            const std::uint64_t bit = std::uint64_t{1} << i;
+            switch (c) {
+                case '"': m.quote |= bit; break;
+                case '\\': m.backslash |= bit; break;
+                case '{': case '}': case '[': case ']': case ':': case ',': m.structural |= bit; break;
+                default: break;
+            }
+        }
+    }
+}
+
+#ifdef CEREBRA_X86_KERNELS
+
+// '[' and ']' are '{' and '}' with bit 5 clear, so OR-ing 0x20 folds each
+// bracket pair into one compare.
+void classify_sse2(const char* p, std::size_t blocks, BlockMasks* out) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i bit5 = _mm_set1_epi8(0x20);
+    const __m128i open = _mm_set1_epi8('{');
+    const __m128i close = _mm_set1_epi8('}');
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i comma = _mm_set1_epi8(',');
+    for (std::size_t b = 0; b < blocks; ++b, p += 64) {
+        BlockMasks& m = out[b];
+        m = BlockMasks{};
+        for (int k = 0; k < 4; ++k) {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * k));
+            const __m128i folded = _mm_or_si128(x, bit5);
+            const __m128i structural = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(folded, open), _mm_cmpeq_epi8(folded, close)),
+                _mm_or_si128(_mm_cmpeq_epi8(x, colon), _mm_cmpeq_epi8(x, comma)));
+            const int shift = 16 * k;
+            m.quote |= static_cast<std::uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, quote))) << shift;
+            m.backslash |= static_cast<std::uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, backslash))) << shift;
+            m.structural |= static_cast<std::uint64_t>(_mm_movemask_epi8(structural)) << shift;
+        }
+    }
+}
+
+#define CEREBRA_AVX2 __attribute__((target("avx2")))
+
+CEREBRA_AVX2 std::uint64_t bits(__m256i v) {
+    return static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(v)));
+}
+
+CEREBRA_AVX2 void classify_avx2(const char* p, std::size_t blocks, BlockMasks* out) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i bit5 = _mm256_set1_epi8(0x20);
+    const __m256i open = _mm256_set1_epi8('{');
+    const __m256i close = _mm256_set1_epi8('}');
+    const __m256i colon = _mm256_set1_epi8(':');
+    const __m256i comma = _mm256_set1_epi8(',');
+    for (std::size_t b = 0; b < blocks; ++b, p += 64) {
+        BlockMasks& m = out[b];
+        m = BlockMasks{};
+        for (int k = 0; k < 2; ++k) {
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32 * k));
+            const __m256i folded = _mm256_or_si256(x, bit5);
+            const __m256i structural = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(folded, open), _mm256_cmpeq_epi8(folded, close)),
+                _mm256_or_si256(_mm256_cmpeq_epi8(x, colon), _mm256_cmpeq_epi8(x, comma)));
+            const int shift = 32 * k;
+            m.quote |= bits(_mm256_cmpeq_epi8(x, quote)) << shift;
+            m.backslash |= bits(_mm256_cmpeq_epi8(x, backslash)) << shift;
+            m.structural |= bits(structural) << shift;
+        }
+    }
+}
+
+#undef CEREBRA_AVX2
+
+#endif
+
+struct ScanChoice {
+    ClassifyFn classify;
+    const char* isa;
+};
+
+const ScanChoice& scan_choice() {
+    static const ScanChoice choice = [] {
+#ifdef CEREBRA_X86_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return ScanChoice{classify_avx2, "avx2"};
+        return ScanChoice{classify_sse2, "sse2"};
+#else
+        return ScanChoice{classify_scalar, "scalar"};
+#endif
+    }();
+    return choice;
+}
+
+// Bits of the characters escaped by a backslash. `carry` is 1 when the
+// previous block ended in a backslash that escapes this block's first byte.
+// Backslashes are rare in our data, so they are walked one at a time.
+std::uint64_t escaped_bits(std::uint64_t backslash, std::uint64_t& carry) {
+    std::uint64_t escaped = carry;
+    backslash &= ~carry;
+    carry = 0;
+    while (backslash) {
+        const int i = __builtin_ctzll(backslash);
+        if (i == 63) {
+            carry = 1;
+            break;
+        }
+        escaped |= std::uint64_t{1} << (i + 1);
+        backslash &= ~(std::uint64_t{3} << i);
+    }
+    return escaped;
+}
+
+// Bit i set when an odd number of bits at or below i are set.
+std::uint64_t prefix_xor(std::uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+// Stage 1, one run of blocks at a time: the offsets of a run go into a
+// buffer that stays in cache and are consumed before the next run is
+// scanned, so the index of the whole document is never stored.
+class StructuralScanner {
+public:
+    StructuralScanner(std::string_view json, ClassifyFn classify) : json_(json), classify_(classify) {
+        if (json.size() > std::numeric_limits<std::uint32_t>::max()) {
+            throw JsonParseError("Document too large for the DOM parser", std::numeric_limits<std::uint32_t>::max());
+        }
+    }
+
+    // Scan the next run into [begin(), end()). False once the input is used
+    // up; throws there if a string was left open.
+    bool next_run();
+    const std::uint32_t* begin() const { return stage_; }
+    const std::uint32_t* end() const { return stage_ + size_; }
+
+    // Whether [begin, end) may hold a backslash; exact for text that is
+    // already scanned and free of them, so documents without escapes never
+    // search their strings.
+    bool may_escape(std::size_t begin) const { return last_backslash_ >= begin && last_backslash_ != kNone; }
+
+    // The next offset, across runs; the document size once there are none.
+    std::uint32_t next() {
+        while (k_ == size_) {
+            if (!next_run()) return static_cast<std::uint32_t>(json_.size());
+        }
+        return stage_[k_++];
+    }
+
+private:
+    static constexpr std::size_t kRunBlocks = 64;
+    static constexpr std::size_t kNone = ~std::size_t{0};
+
+    std::string_view json_;
+    ClassifyFn classify_;
+    std::size_t run_ = 0;
+    std::size_t k_ = 0;
+    std::size_t size_ = 0;
+    std::uint64_t escape_carry_ = 0;
+    std::uint64_t in_string_carry_ = 0;  // all ones while a string is open
+    std::size_t last_backslash_ = kNone;
+    BlockMasks masks_[kRunBlocks];
+    // Each block stores its offsets unconditionally, eight at a time, so
+    // there is room for every byte of a run plus a block's worth of slack.
+    std::uint32_t stage_[kRunBlocks * 64 + 64];
+};
+
+bool StructuralScanner::next_run() {
+    const std::size_t n = json_.size();
+    k_ = size_ = 0;
+    if (run_ >= n) {
+        if (in_string_carry_) throw JsonParseError("Unterminated string", n);
+        return false;
+    }
+    std::size_t blocks = std::min(kRunBlocks, (n - run_) / 64);
+    classify_(json_.data() + run_, blocks, masks_);
+    if (blocks < kRunBlocks && run_ + blocks * 64 < n) {
+        char tail[64];
+        std::memset(tail, ' ', sizeof tail);
+        std::memcpy(tail, json_.data() + run_ + blocks * 64, n - run_ - blocks * 64);
+        classify_(tail, 1, masks_ + blocks);
+        ++blocks;
+    }
+    std::uint32_t* out = stage_;
+    for (std::size_t b = 0; b < blocks; ++b) {
+        const BlockMasks& m = masks_[b];
+        const auto offset = static_cast<std::uint32_t>(run_ + b * 64);
+        if (m.backslash) last_backslash_ = offset + 63 - static_cast<std::size_t>(__builtin_clzll(m.backslash));
+        const std::uint64_t quote = m.quote & ~escaped_bits(m.backslash, escape_carry_);
+        // Set from each opening quote up to, not including, its closing quote.
+        const std::uint64_t in_string = prefix_xor(quote) ^ in_string_carry_;
+        in_string_carry_ = static_cast<std::uint64_t>(static_cast<std::int64_t>(in_string) >> 63);
+
+        std::uint64_t emit = (m.structural & ~in_string) | quote;
+        std::uint32_t* next = out + __builtin_popcountll(emit);
+        while (emit) {
+            for (int j = 0; j < 8; ++j) {
+                out[j] = offset + static_cast<std::uint32_t>(__builtin_ctzll(emit | (std::uint64_t{1} << 63)));
+                emit &= emit - 1;
+            }
+            out += 8;
+        }
+        out = next;
+    }
+    run_ += kRunBlocks * 64;
+    size_ = static_cast<std::size_t>(out - stage_);
+    return true;
+}
+
+bool is_space(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+// Whether a scalar may end just before `c`.
+bool ends_scalar(char c) {
+    switch (c) {
+        case ',': case ':': case '{': case '}': case '[': case ']': case '"': return true;
+        default: return is_space(c);
+    }
+}
+
+int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+constexpr std::uint32_t kReplacementChar = 0xFFFD;
+
+// Stage 2. Structural characters and quotes are met in the same order as
+// stage 1 found them, so each one the builder reaches is the scanner's next
+// offset; that is what lets a string jump straight to its closing quote.
+// Scalars and whitespace are not indexed and are read in place.
+class TapeBuilder {
+public:
+    TapeBuilder(std::string_view json, StructuralScanner& index, std::vector<JsonTape::Entry>& entries,
+                std::vector<double>& numbers, std::string& strings)
+        : json_(json), index_(index), entries_(entries), numbers_(numbers), strings_(strings) {}
+
+    void run();
+
+private:
+    enum class Expect { Value, FirstKey, Key, FirstElement, Next };
+
+    struct Open {
+        std::uint32_t entry;
+        std::uint32_t members;
+        bool object;
+    };
+
+    [[noreturn]] void fail(const char* what, std::size_t at) const { throw JsonParseError(what, at); }
+
+    // The first byte at or after pos_ that is not whitespace. Compact
+    // documents have none; indented ones have runs, taken 16 bytes at a time.
+    std::size_t skip_space() const {
+        std::size_t at = pos_;
+        if (at >= json_.size() || !is_space(json_[at])) return at;
+#ifdef CEREBRA_X86_KERNELS
+        const __m128i blank = _mm_set1_epi8(' ');
+        const __m128i tab = _mm_set1_epi8('\t');
+        const __m128i cr = _mm_set1_epi8('\r');
+        while (at + 16 <= json_.size()) {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(json_.data() + at));
+            const __m128i control = _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(x, tab), x),
+                                                  _mm_cmpeq_epi8(_mm_min_epu8(x, cr), x));
+            const unsigned space = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(x, blank), control)));
+            if (space != 0xFFFF) return at + static_cast<std::size_t>(__builtin_ctz(~space));
+            at += 16;
+        }
+#endif
+        while (at < json_.size() && is_space(json_[at])) ++at;
+        return at;
+    }
+
+    char at_or_nul(std::size_t at) const { return at < json_.size() ? json_[at] : '\0'; }
+
+    std::uint32_t tape_size() const { return static_cast<std::uint32_t>(entries_.size()); }
+
+    Expect value(std::size_t at, char c);
+    void open(JsonTape::Type type, bool object, std::size_t at);
+    void close(JsonTape::Type type, std::size_t at);
+    void string(std::size_t at);
+    void unescape(std::size_t begin, std::size_t end);
+    std::uint32_t hex4(std::size_t at) const;
+    void scalar(std::size_t at, char c);
+
+    std::string_view json_;
+    StructuralScanner& index_;
+    std::vector<JsonTape::Entry>& entries_;
+    std::vector<double>& numbers_;
+    std::string& strings_;
+    std::size_t pos_ = 0;  // one past the last token read
+    std::vector<Open> stack_;
+};
+
+void TapeBuilder::run() {
+    Expect state = Expect::Value;
+    for (;;) {
+        const std::size_t at = skip_space();
+        const char c = at_or_nul(at);
+        switch (state) {
+            case Expect::FirstElement:
+                if (c == ']') {
+                    close(JsonTape::Type::EndArray, at);
+                    state = Expect::Next;
+                    break;
+                }
+                [[fallthrough]];
+            case Expect::Value:
+                state = value(at, c);
+                break;
+            case Expect::FirstKey:
+                if (c == '}') {
+                    close(JsonTape::Type::EndObject, at);
+                    state = Expect::Next;
+                    break;
+                }
+                [[fallthrough]];
+            case Expect::Key: {
+                if (c != '"') fail("Expected '\"'", at);
+                string(at);
+                const std::size_t colon = skip_space();
+                if (at_or_nul(colon) != ':') fail("Expected ':'", colon);
+                index_.next();
+                pos_ = colon + 1;
+                state = Expect::Value;
+                break;
+            }
+            case Expect::Next: {
+                if (stack_.empty()) {
+                    if (at < json_.size()) fail("Extra data after JSON", at);
+                    return;
+                }
+                const bool object = stack_.back().object;
+                if (c == ',') {
+                    index_.next();
+                    pos_ = at + 1;
+                    state = object ? Expect::Key : Expect::Value;
+                } else if (c == (object ? '}' : ']')) {
+                    close(object ? JsonTape::Type::EndObject : JsonTape::Type::EndArray, at);
+                } else {
+                    fail(object ? "Expected ',' or '}'" : "Expected ',' or ']'", at);
+                }
+                break;
+            }
+        }
+    }
+}
+
+TapeBuilder::Expect TapeBuilder::value(std::size_t at, char c) {
+    if (!stack_.empty()) ++stack_.back().members;
+    switch (c) {
+        case '{':
+            open(JsonTape::Type::StartObject, true, at);
+            return Expect::FirstKey;
+        case '[':
+            open(JsonTape::Type::StartArray, false, at);
+            return Expect::FirstElement;
+        case '"':
+            string(at);
+            return Expect::Next;
+        default:
+            scalar(at, c);
+            return Expect::Next;
+    }
+}
+
+void TapeBuilder::open(JsonTape::Type type, bool object, std::size_t at) {
+    index_.next();
+    stack_.push_back({tape_size(), 0, object});
+    entries_.emplace_back(type, 0, 0);
+    pos_ = at + 1;
+}
+
+// The start entry is filled in now that its size and end are known.
+void TapeBuilder::close(JsonTape::Type type, std::size_t at) {
+    index_.next();
+    const Open& top = stack_.back();
+    if (top.members > JsonTape::Entry::kMaxCount) fail("Container too large for the DOM parser", at);
+    entries_.emplace_back(type, 0, 0);
+    entries_[top.entry] = JsonTape::Entry(entries_[top.entry].type(), top.members, tape_size());
+    stack_.pop_back();
+    pos_ = at + 1;
+}
+
+void TapeBuilder::string(std::size_t at) {
+    index_.next();
+    const std::size_t begin = at + 1;
+    const std::size_t end = index_.next();
+    if (end - begin > JsonTape::Entry::kMaxCount) fail("String too long for the DOM parser", at);
+    if (!index_.may_escape(begin) || std::memchr(json_.data() + begin, '\\', end - begin) == nullptr) {
+        entries_.emplace_back(JsonTape::Type::String, static_cast<std::uint32_t>(end - begin),
+                              static_cast<std::uint32_t>(begin));
+    } else {
+        // Unescaping never lengthens a string, so the count still fits.
+        const std::size_t first = strings_.size();
+        unescape(begin, end);
+        entries_.emplace_back(JsonTape::Type::String, static_cast<std::uint32_t>(strings_.size() - first),
+                              static_cast<std::uint32_t>(first), true);
+    }
+    pos_ = end + 1;
+}
+
+std::uint32_t TapeBuilder::hex4(std::size_t at) const {
+    std::uint32_t cp = 0;
+    for (std::size_t i = at; i < at + 4; ++i) {
+        const int digit = i < json_.size() ? hex_value(json_[i]) : -1;
+        if (digit < 0) fail("Invalid \\u escape", i);
+        cp = cp << 4 | static_cast<std::uint32_t>(digit);
+    }
+    return cp;
+}
+
+void TapeBuilder::unescape(std::size_t begin, std::size_t end) {
+    std::size_t i = begin;
+    while (i < end) {
+        const char* slash = static_cast<const char*>(std::memchr(json_.data() + i, '\\', end - i));
+        const std::size_t run_end = slash ? static_cast<std::size_t>(slash - json_.data()) : end;
+        strings_.append(json_.data() + i, run_end - i);
+        if (run_end == end) return;
+        i = run_end + 1;
+        const char e = json_[i++];
+        switch (e) {
+            case 'b': strings_ += '\b'; continue;
+            case 'f': strings_ += '\f'; continue;
+            case 'n': strings_ += '\n'; continue;
+            case 'r': strings_ += '\r'; continue;
+            case 't': strings_ += '\t'; continue;
+            case 'u': break;
+            default: strings_ += e; continue;  // \" \\ \/ and, leniently, anything else
+        }
+        std::uint32_t cp = hex4(i);
+        i += 4;
+        if (cp >= 0xD800 && cp < 0xDC00) {
+            // A high surrogate pairs with an escaped low one that follows.
+            if (i + 1 < end && json_[i] == '\\' && json_[i + 1] == 'u') {
+                const std::uint32_t low = hex4(i + 2);
+                if (low >= 0xDC00 && low < 0xE000) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                } else {
+                    cp = kReplacementChar;
+                }
+            } else {
+                cp = kReplacementChar;
+            }
+        } else if (cp >= 0xDC00 && cp < 0xE000) {
+            cp = kReplacementChar;
+        }
+        append_utf8(strings_, cp);
+    }
+}
+
+void TapeBuilder::scalar(std::size_t at, char c) {
+    const std::string_view rest = json_.substr(at);
+    std::size_t used = 0;
+    const bool literal = c == 't' || c == 'f' || c == 'n';
+    if (literal) {
+        const std::string_view word = c == 't' ? "true" : c == 'f' ? "false" : "null";
+        if (rest.substr(0, word.size()) != word) fail("Invalid literal", at);
+        entries_.emplace_back(c == 't' ? JsonTape::Type::True : c == 'f' ? JsonTape::Type::False : JsonTape::Type::Null,
+                              0, 0);
+        used = word.size();
+    } else if (c == '-' || (c >= '0' && c <= '9')) {
+        // decode_number_prefix would also take "-inf" and "-nan".
+        if (c == '-' && (rest.size() < 2 || rest[1] < '0' || rest[1] > '9')) fail("Invalid number", at);
+        double v = 0.0;
+        const std::errc ec = decode_number_prefix(rest, v, used);
+        if (ec == std::errc::result_out_of_range) fail("Number out of range", at);
+        if (ec != std::errc()) fail("Invalid number", at);
+        entries_.emplace_back(JsonTape::Type::Number, 0, static_cast<std::uint32_t>(numbers_.size()));
+        numbers_.push_back(v);
+    } else {
+        fail("Unexpected character", at);
+    }
+    // "1.2.3" or "truex": the token runs on past what was read.
+    if (used < rest.size() && !ends_scalar(rest[used])) fail(literal ? "Invalid literal" : "Invalid number", at);
+    pos_ = at + used;
+}
+
+std::vector<std::uint32_t> structural_index(std::string_view json, ClassifyFn classify) {
+    StructuralScanner scanner(json, classify);
+    std::vector<std::uint32_t> index;
+    while (scanner.next_run()) index.insert(index.end(), scanner.begin(), scanner.end());
+    return index;
+}
+
+} // namespace
+
+void append_utf8(std::string& out, std::uint32_t cp) {
+    if (cp < 0x80) {
+        out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+std::vector<std::uint32_t> json_structural_index(std::string_view json) {
+    return structural_index(json, scan_choice().classify);
+}
+
+std::vector<std::uint32_t> json_structural_index_scalar(std::string_view json) {
+    return structural_index(json, classify_scalar);
+}
+
+const char* json_scan_isa() { return scan_choice().isa; }
+
+JsonTape JsonTape::parse(std::string_view json) {
+    JsonTape tape;
+    tape.source_ = json;
+    // Compact documents average a little over four bytes per entry and
+    // twenty per number.
+    tape.entries_.reserve(json.size() / 4 + 16);
+    tape.numbers_.reserve(json.size() / 16 + 16);
+    StructuralScanner index(json, scan_choice().classify);
+    TapeBuilder(json, index, tape.entries_, tape.numbers_, tape.strings_).run();
+    return tape;
+}
+
+} // namespace cerebra
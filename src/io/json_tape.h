@@ -0,0 +1,76 @@
+#pragma once
+
+#include "io/json_parser.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cerebra {
+
+// Stage 1 of the DOM parser: the offsets of every structural character
+// ({ } [ ] : ,) and every unescaped quote (opening and closing) outside
+// strings, in order. Found 64 bytes at a time with SSE2/AVX2 compare masks
+// where available. Throws JsonParseError for an unterminated string or a
+// document over 4 GiB.
+std::vector<std::uint32_t> json_structural_index(std::string_view json);
+std::vector<std::uint32_t> json_structural_index_scalar(std::string_view json);
+const char* json_scan_isa();
+
+// Stage 2: the document flattened into one 8-byte entry per value, in
+// document order. A container's entry is followed by its members (object
+// keys and values alternate) and then its End entry. Numbers are kept in
+// numbers(); strings without escapes refer to the source text and the rest
+// are unescaped once into strings().
+class JsonTape {
+public:
+    enum class Type : std::uint8_t {
+        Null, True, False, Number, String, StartObject, EndObject, StartArray, EndArray,
+    };
+
+    class Entry {
+    public:
+        // Strings and member counts past this do not fit an entry.
+        static constexpr std::uint32_t kMaxCount = (std::uint32_t{1} << 27) - 1;
+
+        Entry() = default;
+        Entry(Type type, std::uint32_t count, std::uint32_t offset, bool unescaped = false)
+            : bits_(static_cast<std::uint32_t>(type) | (unescaped ? 0x10u : 0u) | count << 5), offset_(offset) {}
+
+        Type type() const { return static_cast<Type>(bits_ & 0xF); }
+        bool unescaped() const { return bits_ & 0x10; }      // String: offset is into strings(), not the source
+        std::uint32_t count() const { return bits_ >> 5; }   // String: byte length; Start*: member count
+        std::uint32_t offset() const { return offset_; }     // String: start of the text; Number: index into
+                                                             // numbers(); Start*: index one past the End entry
+    private:
+        std::uint32_t bits_ = 0;
+        std::uint32_t offset_ = 0;
+    };
+
+    // Throws JsonParseError with the byte offset of the first error,
+    // including a string or container too large for an entry.
+    static JsonTape parse(std::string_view json);
+
+    std::string_view source() const { return source_; }
+    const std::vector<Entry>& entries() const { return entries_; }
+    const std::vector<double>& numbers() const { return numbers_; }
+    const std::string& strings() const { return strings_; }
+    double number(const Entry& e) const { return numbers_[e.offset()]; }
+    std::string_view string(const Entry& e) const {
+        return e.unescaped() ? std::string_view(strings_).substr(e.offset(), e.count())
+                             : source_.substr(e.offset(), e.count());
+    }
+
+private:
+    std::string_view source_;
+    std::vector<Entry> entries_;
+    std::vector<double> numbers_;
+    std::string strings_;
+};
+
+// Append code point `cp` to `out` as UTF-8.
+void append_utf8(std::string& out, std::uint32_t cp);
+
+} // namespace cerebra
@@ -0,0 +1,81 @@
+#include "io/number_decode.h"
+
+#include <charconv>
+
+namespace cerebra {
+
+namespace {
+
+// The characters std::isspace accepts in the C locale.
+bool is_space(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+std::string_view trim_number(std::string_view text) {
+    while (!text.empty() && is_space(text.front())) text.remove_prefix(1);
+    while (!text.empty() && is_space(text.back())) text.remove_suffix(1);
+    // from_chars rejects '+', which stod and stoll accepted; "+-1" stays invalid.
+    if (text.size() > 1 && text[0] == '+' && text[1] != '-') text.remove_prefix(1);
+    return text;
+}
+
+template <typename T>
+std::errc decode_whole(std::string_view text, T& out) {
+    text = trim_number(text);
+    T v{};
+    const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), v);
+    if (ec != std::errc()) return ec;
+    if (end != text.data() + text.size()) return std::errc::invalid_argument;
+    out = v;
+    return std::errc();
+}
+
+// Powers of ten that a double holds exactly.
+constexpr double kExactPowers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// "-12.345" with at most 15 digits: the digits and the power of ten are both
+// exact doubles, so one correctly rounded division gives what from_chars
+// would. Anything else (an exponent, more digits) is left to from_chars.
+bool decode_simple_decimal(std::string_view text, double& out, std::size_t& used) {
+    const char* p = text.data();
+    const char* const end = p + text.size();
+    const bool negative = p != end && *p == '-';
+    if (negative) ++p;
+    const char* const first = p;
+    std::uint64_t digits = 0;
+    while (p != end && *p >= '0' && *p <= '9') digits = digits * 10 + static_cast<unsigned>(*p++ - '0');
+    if (p == first) return false;
+    std::size_t count = static_cast<std::size_t>(p - first);
+    std::size_t fraction = 0;
+    if (p != end && *p == '.') {
+        const char* const point = ++p;
+        while (p != end && *p >= '0' && *p <= '9') digits = digits * 10 + static_cast<unsigned>(*p++ - '0');
+        fraction = static_cast<std::size_t>(p - point);
+        if (fraction == 0) return false;
+        count += fraction;
+    }
+    if (count > 15 || (p != end && (*p == 'e' || *p == 'E'))) return false;
+    const double v = static_cast<double>(digits) / kExactPowers[fraction];
+    out = negative ? -v : v;
+    used = static_cast<std::size_t>(p - text.data());
+    return true;
+}
+
+} // namespace
+
+std::errc decode_number(std::string_view text, double& out) { return decode_whole(text, out); }
+
+std::errc decode_number(std::string_view text, std::int64_t& out) { return decode_whole(text, out); }
+
+std::errc decode_number(std::string_view text, int& out) { return decode_whole(text, out); }
+
+std::errc decode_number_prefix(std::string_view text, double& out, std::size_t& used) {
+    if (decode_simple_decimal(text, out, used)) return std::errc();
+    double v = 0.0;
+    const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), v);
+    if (ec != std::errc()) return ec;
+    out = v;
+    used = static_cast<std::size_t>(end - text.data());
+    return std::errc();
+}
+
+} // namespace cerebra
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <system_error>
+
+namespace cerebra {
+
+// Shared number decoding for the text parsers, built on std::from_chars:
+// locale-independent, no allocation and no exceptions. Failures come back as
+// std::errc (invalid_argument or result_out_of_range) and leave `out`
+// unchanged, so a caller can keep a default or raise its own error.
+
+// Decode all of `text`, allowing surrounding whitespace and one leading '+'.
+std::errc decode_number(std::string_view text, double& out);
+std::errc decode_number(std::string_view text, std::int64_t& out);
+std::errc decode_number(std::string_view text, int& out);
+
+// Decode the longest number at the start of `text` (no whitespace or '+'
+// skipped) and set `used` to the bytes it took, like strtod without hex or
+// locale handling.
+std::errc decode_number_prefix(std::string_view text, double& out, std::size_t& used);
+
+} // namespace cerebra
@@ -251,7 +251,7 @@ std::optional<BrainActivitySample> SerialActivityStream::parse_line(const std::s
       const std::string& raw = entry["region"].as_string();
       if (raw.empty()) continue;
       double intensity = std::max(0.0, std::min(1.0, entry["intensity"].as_number(0.0)));
-      sample.intensities[RegionCatalog::normalize_key(raw)] = intensity;
+      sample.set(RegionCatalog::normalize_key(raw), intensity);
     }
     return sample;
   } catch (const std::exception&) {
@@ -14,11 +14,11 @@ std::string frame_to_json_line(const BrainActivitySample& s, std::int64_t timest
   std::ostringstream os;
   os << "{\"brain_activity\":[";
   bool first = true;
-  for (const auto& kv : s.intensities) {
+  s.for_each([&](std::string_view key, double intensity) {
     if (!first) os << ",";
     first = false;
-    os << "{\"region\":\"" << kv.first << "\",\"intensity\":" << kv.second << "}";
-  }
+    os << "{\"region\":\"" << key << "\",\"intensity\":" << intensity << "}";
+  });
   os << "],\"timestamp_ms\":" << timestamp_ms << "}\n";
   return os.str();
 }
@@ -1,31 +1,41 @@
 #include "io/xml_parser.h"
 #include "core/data_parsing_hub.h"
+#include "io/number_decode.h"
 #include <sstream>
+#include <stdexcept>
+#include <string_view>
 
 namespace cerebra {
 
 std::vector<cerebra::BrainFrame> parse_xml_frames(const std::string& xml) {
+    const std::string_view text(xml);
     std::vector<cerebra::BrainFrame> frames;
     size_t pos = 0;
     while ((pos = xml.find("<frame>", pos)) != std::string::npos) {
         cerebra::BrainFrame f;
         size_t tpos = xml.find("<timestamp>", pos);
         if (tpos != std::string::npos) {
-            f.timestamp_ms = std::stoll(xml.substr(tpos + 11, xml.find("</", tpos) - tpos - 11));
+            const std::string_view ts = text.substr(tpos + 11, xml.find("</", tpos) - tpos - 11);
+            if (decode_number(ts, f.timestamp_ms) != std::errc()) {
+                throw std::invalid_argument("XML: bad timestamp '" + std::string(ts) + "'");
+            }
         }
         size_t rpos = pos;
         while ((rpos = xml.find("<region>", rpos)) != std::string::npos && rpos < xml.find("</frame>", pos)) {
-            cerebra::RegionState r;
+            std::string region;
+            double intensity = 0.0;
             size_t npos = xml.find("<name>", rpos);
             if (npos != std::string::npos) {
-                r.region = internString(xml.substr(npos + 6, xml.find("</", npos) - npos - 6));
+                region = internString(xml.substr(npos + 6, xml.find("</", npos) - npos - 6));
             }
             size_t ipos = xml.find("<intensity>", rpos);
             if (ipos != std::string::npos) {
-                r.intensity = std::stod(xml.substr(ipos + 11, xml.find("</", ipos) - ipos - 11));
+                const std::string_view value = text.substr(ipos + 11, xml.find("</", ipos) - ipos - 11);
+                if (decode_number(value, intensity) != std::errc()) {
+                    throw std::invalid_argument("XML: bad intensity '" + std::string(value) + "'");
+                }
             }
-            r.flows = default_flows_for(r.region, r.intensity);
-            f.regions.push_back(std::move(r));
+            f.regions.push_back(make_region_state(std::move(region), intensity));
             rpos = xml.find("</region>", rpos) + 9;
         }
         frames.push_back(std::move(f));
@@ -1,9 +1,21 @@
 #include "io/yaml_parser.h"
 #include "core/data_parsing_hub.h"
+#include "io/number_decode.h"
 #include <sstream>
+#include <stdexcept>
+#include <string_view>
 
 namespace cerebra {
 
+namespace {
+
+// The text after the first ':' on `line`.
+std::string_view after_colon(const std::string& line) {
+    return std::string_view(line).substr(line.find(':') + 1);
+}
+
+} // namespace
+
 std::vector<cerebra::BrainFrame> parse_yaml_frames(const std::string& yaml) {
     std::vector<cerebra::BrainFrame> frames;
     std::stringstream ss(yaml);
@@ -13,15 +25,18 @@ std::vector<cerebra::BrainFrame> parse_yaml_frames(const std::string& yaml) {
         if (line.find("timestamp_ms:") != std::string::npos) {
             frames.push_back(cerebra::BrainFrame());
             current = &frames.back();
-            current->timestamp_ms = std::stoll(trim(line.substr(line.find(":") + 1)));
+            if (decode_number(after_colon(line), current->timestamp_ms) != std::errc()) {
+                throw std::invalid_argument("YAML: bad timestamp in '" + line + "'");
+            }
         } else if (line.find("- region:") != std::string::npos && current) {
-            cerebra::RegionState r;
-            r.region = internString(trim(line.substr(line.find(":") + 1)));
+            std::string region = internString(trim(line.substr(line.find(":") + 1)));
+            double intensity = 0.0;
             if (std::getline(ss, line)) {
-                r.intensity = std::stod(trim(line.substr(line.find(":") + 1)));
+                if (decode_number(after_colon(line), intensity) != std::errc()) {
+                    throw std::invalid_argument("YAML: bad intensity in '" + line + "'");
+                }
             }
-            r.flows = default_flows_for(r.region, r.intensity);
-            current->regions.push_back(std::move(r));
+            current->regions.push_back(make_region_state(std::move(region), intensity));
         }
     }
     return frames;
@@ -10,6 +10,7 @@
 #include "core/neurochemistry.h"
 #include "core/pathway_logic.h"
 #include "core/atlas_region.h"
+#include "io/number_decode.h"
 
 namespace cerebra {
 namespace {
@@ -20,29 +21,9 @@ std::string lower(std::string s) {
   return s;
 }
 
-bool parse_int(const std::string& s, int& out) {
-  try {
-    std::size_t idx = 0;
-    int v = std::stoi(s, &idx);
-    if (idx != s.size()) return false;
-    out = v;
-    return true;
-  } catch (...) {
-    return false;
-  }
-}
+bool parse_int(const std::string& s, int& out) { return decode_number(s, out) == std::errc(); }
 
-bool parse_double(const std::string& s, double& out) {
-  try {
-    std::size_t idx = 0;
-    double v = std::stod(s, &idx);
-    if (idx != s.size()) return false;
-    out = v;
-    return true;
-  } catch (...) {
-    return false;
-  }
-}
+bool parse_double(const std::string& s, double& out) { return decode_number(s, out) == std::errc(); }
 
 CliOptions make_exit(int code, std::string message) {
   CliOptions o;
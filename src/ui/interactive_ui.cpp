@@ -49,7 +49,7 @@ std::string format_footer(const Theme& theme) {
 std::string render_frame(const Simulation& sim, const InteractiveSnapshot& state,
                          const Theme& theme, int cols, int rows) {
     std::ostringstream out;
-    const cerebra::BrainFrame& f = sim.current();
+    const cerebra::BrainFrame f = sim.current().to_frame();
     out << format_header(theme, state, sim.size(), f.timestamp_ms);
     out << render_2d_slice(f, cols, theme, state.highlight);
     int proj_h = std::max(12, rows - 24);
@@ -69,9 +69,7 @@ int run_report(const Simulation& sim, const std::string& theme_name, std::ostrea
     const Theme& theme = theme_by_name(theme_name);
     TerminalSize ts = terminal_size();
     for (std::size_t i = 0; i < sim.size(); ++i) {
-        Simulation s = sim;
-        s.set_index(i);
-        const cerebra::BrainFrame& f = s.current();
+        const cerebra::BrainFrame f = sim.at(i).to_frame();
         out << ansi(theme.title_color) << "Brain Modeler" << ansi_reset()
             << "  " << ansi(theme.accent_color) << "frame " << (i + 1)
             << "/" << sim.size() << ansi_reset()
@@ -163,15 +161,16 @@ int run_interactive(Simulation& sim, const InteractiveOptions& opts) {
 
         std::ostringstream out;
         out << ansi_clear_screen();
-        out << format_header(theme, snap, sim.size(), sim.current().timestamp_ms);
-        if (show_2d) out << render_2d_slice(sim.current(), ts.cols, theme, snap.highlight);
+        const cerebra::BrainFrame frame = sim.current().to_frame();
+        out << format_header(theme, snap, sim.size(), frame.timestamp_ms);
+        if (show_2d) out << render_2d_slice(frame, ts.cols, theme, snap.highlight);
         if (show_3d) {
             int proj_h = std::max(12, ts.rows - (show_2d ? 26 : 8));
             int proj_w = std::max(40, ts.cols - 4);
-            out << render_3d_projection(sim.current(), proj_w, proj_h, theme, 35.0, snap.highlight);
+            out << render_3d_projection(frame, proj_w, proj_h, theme, 35.0, snap.highlight);
         }
-        out << render_region_table(sim.current(), ts.cols, theme, snap.highlight);
-        out << render_pathways_table(sim.current(), ts.cols, theme, snap.highlight);
+        out << render_region_table(frame, ts.cols, theme, snap.highlight);
+        out << render_pathways_table(frame, ts.cols, theme, snap.highlight);
         out << format_footer(theme);
         std::cout << out.str() << std::flush;
 
@@ -61,7 +61,9 @@ std::string bar(double value, int width, bool ascii_only) {
   return out;
 }
 
-std::string sparkline(const std::vector<double>& series, int width, bool ascii_only) {
+// `series` is anything indexable with a size(): a vector or a RegionSeries.
+template <typename Series>
+std::string sparkline(const Series& series, int width, bool ascii_only) {
   if (series.empty() || width <= 0) return std::string(static_cast<std::size_t>(std::max(0, width)), ' ');
   std::string out;
   for (int i = 0; i < width; ++i) {
@@ -222,7 +224,7 @@ void draw_pathways(Canvas& c, const RenderOptions& opt,
 std::vector<std::string> render_slice(const Simulation& sim, const RenderOptions& opt,
                                       int w, int h) {
   Canvas canvas(w, h);
-  const auto& sample = sim.current_sample();
+  const FrameView sample = sim.current_sample();
   double cx = (w - 1) / 2.0;
   double cy = (h - 1) / 2.0;
   double rx = (w - 2) / 2.0;
@@ -231,10 +233,13 @@ std::vector<std::string> render_slice(const Simulation& sim, const RenderOptions
   if (ry < 2) ry = 2;
 
   std::vector<PlacedRegion> placed;
-  for (const auto& info : RegionCatalog::all()) {
+  const auto atlas = acquire_atlas_snapshot();
+  const auto& regions = atlas->atlas.regions();
+  for (RegionId id = 0; id < regions.size(); ++id) {
+    const auto& info = regions[id];
     PlacedRegion pr;
     pr.info = info;
-    pr.intensity = sample.intensity_of(info.key);
+    pr.intensity = sample.intensity_of(id, *atlas);
     pr.cx = static_cast<int>(std::lround(cx + (info.slice_x - 0.5) * 2.0 * rx * 0.82));
     pr.cy = static_cast<int>(std::lround(cy + (info.slice_y - 0.5) * 2.0 * ry * 0.88));
     placed.push_back(pr);
@@ -356,13 +361,16 @@ std::vector<std::string> render_projection(const Simulation& sim, const RenderOp
   // Region blobs, painted far-to-near so nearer regions overdraw farther ones.
   struct Blob { RegionInfo info; double intensity; int x; int y; double depth; };
   std::vector<Blob> blobs;
-  const auto& sample = sim.current_sample();
-  for (const auto& info : RegionCatalog::all()) {
+  const FrameView sample = sim.current_sample();
+  const auto atlas = acquire_atlas_snapshot();
+  const auto& regions = atlas->atlas.regions();
+  for (RegionId id = 0; id < regions.size(); ++id) {
+    const auto& info = regions[id];
     double px, py, pd;
     project(info.slice_x - 0.5, info.slice_y - 0.5, info.depth - 0.5, px, py, pd);
     Blob b;
     b.info = info;
-    b.intensity = sample.intensity_of(info.key);
+    b.intensity = sample.intensity_of(id, *atlas);
     b.x = static_cast<int>(std::lround(px));
     b.y = static_cast<int>(std::lround(py));
     b.depth = pd;
@@ -452,11 +460,8 @@ std::vector<std::string> selected_region_lines(const Simulation& sim, const Rend
   // Stats over the whole timeline.
   double cur = sim.current_sample().intensity_of(key);
   double mn = 1e9, mx = -1e9, sum = 0.0;
-  std::vector<double> series;
-  auto tl = sim.timeline();
-  for (const auto& s : tl.samples()) {
-    double v = s.intensity_of(key);
-    series.push_back(v);
+  RegionSeries series = sim.series(key);
+  for (double v : series) {
     mn = std::min(mn, v);
     mx = std::max(mx, v);
     sum += v;
@@ -644,9 +649,9 @@ std::string Renderer::render_report(const Simulation& sim, int width, ViewMode v
   os << repeat("=", width) << "\n";
   os << "frames      : " << sim.frame_count() << "\n";
   if (sim.frame_count()) {
-    os << "duration    : " << sim.timeline().duration_ms() << " ms\n";
-    os << "start ts    : " << sim.timeline().samples().front().timestamp_ms << " ms\n";
-    os << "end ts      : " << sim.timeline().samples().back().timestamp_ms << " ms\n";
+    os << "duration    : " << sim.duration_ms() << " ms\n";
+    os << "start ts    : " << sim.store().timestamps().front() << " ms\n";
+    os << "end ts      : " << sim.store().timestamps().back() << " ms\n";
   }
   os << "view        : " << (view == ViewMode::Projection3D ? "3D projection" : "2D slice") << "\n\n";
 
@@ -656,12 +661,9 @@ std::string Renderer::render_report(const Simulation& sim, int width, ViewMode v
   int spark_w = std::max(12, width - name_w - 26);
   os << pad_right("region", name_w) << " ROI  peak  mean  last  trace\n";
   for (const auto& info : RegionCatalog::all()) {
-    std::vector<double> series;
+    RegionSeries series = sim.series(info.key);
     double mx = 0.0, sum = 0.0, last = 0.0;
-    auto tl = sim.timeline();
-    for (const auto& s : tl.samples()) {
-      double v = s.intensity_of(info.key);
-      series.push_back(v);
+    for (double v : series) {
       mx = std::max(mx, v);
       sum += v;
       last = v;
@@ -73,19 +73,25 @@ std::string intensityToColor(double intensity, const std::string& theme) {
     return "\033[38;5;" + std::to_string(colorCode) + "m";
 }
 
-void renderRegion(std::ostringstream& oss, const cerebra::RegionState& region, int depth, const AppConfig& config) {
+static void renderRegionBar(std::ostringstream& oss, const std::string& name, double intensity,
+                            int depth, int max_width, const AppConfig& config) {
     for (int i = 0; i < depth; ++i) oss << "  ";
-    oss << "[" << region.region << "] ";
-    if (config.enable_color) oss << intensityToColor(region.intensity, config.theme);
+    oss << "[" << name << "] ";
+    if (config.enable_color) oss << intensityToColor(intensity, config.theme);
+    int barWidth = static_cast<int>(intensity * max_width);
+    for (int i = 0; i < barWidth; ++i) oss << intensityToSymbol(intensity, config.intensity_map);
+    if (config.enable_color) oss << "\033[0m";
+}
+
+void renderRegion(std::ostringstream& oss, const cerebra::RegionState& region, int depth, const AppConfig& config) {
     int max_width = cerebra::terminal_size().cols / 4;
     if (max_width < 10) max_width = 10;
-    int barWidth = static_cast<int>(region.intensity * max_width);
-    for (int i = 0; i < barWidth; ++i) oss << intensityToSymbol(region.intensity, config.intensity_map);
-    if (config.enable_color) oss << "\033[0m";
-    if (!region.intensity_history.empty()) {
+    renderRegionBar(oss, region.region, region.intensity, depth, max_width, config);
+    const cerebra::RegionDetail& detail = region.detail();
+    if (!detail.intensity_history.empty()) {
         oss << "  ";
         const char* sparkline[] = {" ", "▂", "▃", "▄", "▅", "▆", "▇", "█"};
-        for (double val : region.intensity_history) {
+        for (double val : detail.intensity_history) {
             int idx = std::max(0, std::min(7, (int)(val * 8))); // Modified to val * 8
             oss << sparkline[idx];
         }
@@ -93,15 +99,23 @@ void renderRegion(std::ostringstream& oss, const cerebra::RegionState& region, i
 
     }
     oss << "\n";
-    for (const cerebra::RegionState& subregion : region.subregions) renderRegion(oss, subregion, depth + 1, config);
+    // Subregions are stored in pre-order, so printing them in array order
+    // with their depth reproduces the indented outline.
+    const cerebra::RegionTree& tree = detail.subregions;
+    for (std::size_t i = 0; i < tree.size(); ++i) {
+        renderRegionBar(oss, tree.region(i), tree.intensity(i),
+                        depth + 1 + static_cast<int>(tree.depth(i)), max_width, config);
+        oss << "\n";
+    }
 }
 
 void renderGrid(std::ostringstream& oss, const cerebra::BrainFrame& frame, const AppConfig& config) {
     double grid[10][10]; bool occupied[10][10];
     for(int i=0; i<10; ++i) for(int j=0; j<10; ++j) { grid[i][j] = 0; occupied[i][j] = false; }
     for (const auto& region : frame.regions) {
-        double zx = (region.x - 0.5 + config.offset_x) * config.zoom + 0.5;
-        double zy = (region.y - 0.5 + config.offset_y) * config.zoom + 0.5;
+        const cerebra::RegionDetail& pos = region.detail();
+        double zx = (pos.x - 0.5 + config.offset_x) * config.zoom + 0.5;
+        double zy = (pos.y - 0.5 + config.offset_y) * config.zoom + 0.5;
         int gx = std::max(0, std::min(9, (int)(zx * 9)));
         int gy = std::max(0, std::min(9, (int)(zy * 9)));
         grid[gy][gx] = region.intensity; occupied[gy][gx] = true;
@@ -132,9 +146,10 @@ void render3D(std::ostringstream& oss, const cerebra::BrainFrame& frame, const A
     double canvas[20][40]; bool occupied[20][40];
     for(int i=0; i<20; ++i) for(int j=0; j<40; ++j) { canvas[i][j] = 0; occupied[i][j] = false; }
     for (const auto& region : frame.regions) {
-        double zx = (region.x - 0.5 + config.offset_x) * config.zoom + 0.5;
-        double zy = (region.y - 0.5 + config.offset_y) * config.zoom + 0.5;
-        double zz = region.z * config.zoom;
+        const cerebra::RegionDetail& pos = region.detail();
+        double zx = (pos.x - 0.5 + config.offset_x) * config.zoom + 0.5;
+        double zy = (pos.y - 0.5 + config.offset_y) * config.zoom + 0.5;
+        double zz = pos.z * config.zoom;
         double xp = (zx - zz) * 15 + 20;
         double yp = (zy + (zx + zz) / 2.0) * 8 + 2;
         int ix = std::max(0, std::min(39, (int)xp));
@@ -14,11 +14,6 @@ namespace {
 constexpr int kBaseW = 38; // intrinsic slice template width
 constexpr int kBaseH = 22; // intrinsic slice template height
 
-double intensity_for(const cerebra::BrainFrame& f, const std::string& id) {
-    for (const auto& r : f.regions) if (r.region == id) return r.intensity;
-    return 0.0;
-}
-
 }
 
 std::string render_2d_slice(const cerebra::BrainFrame& frame, int width, const Theme& theme,
@@ -62,8 +57,11 @@ std::string render_2d_slice(const cerebra::BrainFrame& frame, int width, const T
     // Place each region as a filled rectangle of intensity blocks. We use
     // single-byte ASCII glyphs so the grid stays in fixed-byte alignment
     // (multi-byte UTF-8 would break overlapping writes / clipping math).
-    for (const auto& region : known_regions()) {
-        double inten = intensity_for(frame, region.id);
+    const FrameIndex index(frame);
+    const auto& regions = index.atlas().regions();
+    for (RegionId id = 0; id < regions.size(); ++id) {
+        const auto& region = regions[id];
+        double inten = index.intensity_of(id);
         char block = grayscale_block(inten);
         int col0 = static_cast<int>((region.slice_col / static_cast<double>(kBaseW)) * slice_w);
         int colw = std::max(1, static_cast<int>((region.slice_w / static_cast<double>(kBaseW)) * slice_w));
@@ -91,8 +89,9 @@ std::string render_2d_slice(const cerebra::BrainFrame& frame, int width, const T
     // Legend with highlight
     out << "  Regions: ";
     bool first = true;
-    for (const auto& region : known_regions()) {
-        double inten = intensity_for(frame, region.id);
+    for (RegionId id = 0; id < regions.size(); ++id) {
+        const auto& region = regions[id];
+        double inten = index.intensity_of(id);
         if (!first) out << "  ";
         first = false;
         const Theme& t = theme;
@@ -113,12 +112,11 @@ std::string render_region_table(const cerebra::BrainFrame& frame, int width, con
     out << ansi(theme.title_color)
         << "Region                       Intensity  Bar          Neurotransmitters\n"
         << ansi_reset();
-    auto lookup = [&](const std::string& id) -> const cerebra::RegionState* {
-        for (const auto& r : frame.regions) if (r.region == id) return &r;
-        return nullptr;
-    };
-    for (const auto& info : known_regions()) {
-        const cerebra::RegionState* rs = lookup(info.id);
+    const FrameIndex index(frame);
+    const auto& regions = index.atlas().regions();
+    for (RegionId id = 0; id < regions.size(); ++id) {
+        const auto& info = regions[id];
+        const cerebra::RegionState* rs = index.find(id);
         double inten = rs ? rs->intensity : 0.0;
         int bar = static_cast<int>(inten * 10);
         std::string b;
@@ -129,16 +127,16 @@ std::string render_region_table(const cerebra::BrainFrame& frame, int width, con
             << "  [" << b << "]  ";
         if (rs) {
             bool first = true;
-            for (const auto& nf : rs->flows) {
+            for (const auto nf : rs->effective_flows()) {
                 if (!first) out << ", ";
                 first = false;
                 out << nf.type << "=" << std::fixed
                     << std::setprecision(2) << nf.rate;
             }
-            if (!rs->metrics.empty()) {
+            if (!rs->detail().metrics.empty()) {
                 out << "  |  ";
                 bool first_metric = true;
-                for (const auto& kv : rs->metrics) {
+                for (const auto& kv : rs->detail().metrics) {
                     if (!first_metric) out << ", ";
                     first_metric = false;
                     out << kv.first << "=" << std::fixed << std::setprecision(2) << kv.second;
@@ -151,13 +149,15 @@ std::string render_region_table(const cerebra::BrainFrame& frame, int width, con
 }
 
 double pathway_activation(const PathwayDefinition& p, const cerebra::BrainFrame& frame) {
+    return pathway_activation(p, FrameIndex(frame));
+}
+
+double pathway_activation(const PathwayDefinition& p, const FrameIndex& index) {
     if (p.nodes.empty()) return 0.0;
     double sum = 0.0;
     int counted = 0;
     for (const auto& node : p.nodes) {
-        for (const auto& r : frame.regions) {
-            if (r.region == node) { sum += r.intensity; ++counted; break; }
-        }
+        if (const cerebra::RegionState* r = index.find(node)) { sum += r->intensity; ++counted; }
     }
     if (counted == 0) return 0.0;
     double mean = sum / counted;
@@ -168,19 +168,21 @@ std::string render_pathways_table(const cerebra::BrainFrame& frame, int width, c
                                   const std::string& highlight) {
     (void)width;
     std::ostringstream out;
-    const auto& paths = current_atlas().pathways();
+    const FrameIndex index(frame);
+    const RegionAtlas& atlas = index.atlas();
+    const auto& paths = atlas.pathways();
     if (paths.empty()) return out.str();
 
     out << ansi(theme.title_color)
         << "Pathway                       Strength  Activation  Route\n"
         << ansi_reset();
     for (const auto& p : paths) {
-        double act = pathway_activation(p, frame);
+        double act = pathway_activation(p, index);
         // Build a route string from the regions' display names when available.
         std::string route;
         for (std::size_t i = 0; i < p.nodes.size(); ++i) {
             if (i) route += p.bidirectional ? " <-> " : " -> ";
-            const cerebra::RegionDefinition* def = find_region(p.nodes[i]);
+            const cerebra::RegionDefinition* def = atlas.find(p.nodes[i]);
             route += def ? def->display_name : p.nodes[i];
         }
         const std::string& color = (p.id == highlight) ? theme.warn_color : theme.label_color;
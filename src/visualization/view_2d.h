@@ -20,6 +20,7 @@ std::string render_region_table(const cerebra::BrainFrame& frame, int width, con
 // mean intensity of its node regions in `frame` multiplied by the pathway's
 // baseline strength from the current atlas.
 double pathway_activation(const PathwayDefinition& p, const cerebra::BrainFrame& frame);
+double pathway_activation(const PathwayDefinition& p, const FrameIndex& index);
 
 std::string render_pathways_table(const cerebra::BrainFrame& frame, int width, const Theme& theme,
                                   const std::string& highlight = {});
@@ -12,15 +12,6 @@
 
 namespace cerebra {
 
-namespace {
-
-double intensity_for(const cerebra::BrainFrame& f, const std::string& id) {
-    for (const auto& r : f.regions) if (r.region == id) return r.intensity;
-    return 0.0;
-}
-
-}
-
 std::string render_3d_projection(const cerebra::BrainFrame& frame, int width, int height,
                                  const Theme& theme, double yaw_deg,
                                  const std::string& highlight) {
@@ -74,8 +65,11 @@ std::string render_3d_projection(const cerebra::BrainFrame& frame, int width, in
         return "@";
     };
 
-    for (const auto& g : current_atlas().regions()) {
-        double inten = intensity_for(frame, g.id);
+    const FrameIndex index(frame);
+    const auto& regions = index.atlas().regions();
+    for (RegionId id = 0; id < regions.size(); ++id) {
+        const auto& g = regions[id];
+        double inten = index.intensity_of(id);
         if (inten <= 0.0) continue;
         int px, py; double pz;
         project(g.proj_x, g.proj_y, g.proj_z, px, py, pz);
@@ -13,7 +13,7 @@ GIVEN("a loaded simulation with {int} frames at {int} fps") {
   for (int i = 0; i < frames; ++i) {
     cerebra::BrainActivitySample s;
     s.timestamp_ms = static_cast<std::int64_t>(i) * 100;
-    s.intensities["amygdala"] = static_cast<double>(i) / static_cast<double>(frames);
+    s.set("amygdala", static_cast<double>(i) / static_cast<double>(frames));
     samples.push_back(s);
   }
   world.sim = std::make_unique<cerebra::Simulation>(cerebra::ActivityTimeline(std::move(samples)));
@@ -32,11 +32,7 @@ WHEN("a custom atlas adds the {string} region with display name {string}") {
     cerebra::BrainFrame frame = cerebra::template_frame(cerebra::BrainTemplate::Focused, 0);
     // Add the new region to the frame at modest intensity so it surfaces in
     // both the table and the slice legend.
-    cerebra::RegionState rs;
-    rs.region = args[0];
-    rs.intensity = 0.5;
-    rs.flows = cerebra::default_flows_for(rs.region, rs.intensity);
-    frame.regions.push_back(rs);
+    frame.regions.push_back(cerebra::make_region_state(args[0], 0.5));
 
     const auto& theme = cerebra::theme_by_name("mono");
     ctx.set<std::string>("table", cerebra::render_region_table(frame, 100, theme));
@@ -9,17 +9,17 @@ void test_rife_interpolation() {
 void test_ken_burns_panning() {
     cerebra::BrainFrame f;
     f.regions.push_back({"R", 0.5});
-    f.regions[0].x = 10.0;
-    f.regions[0].y = 10.0;
+    f.regions[0].mutable_detail().x = 10.0;
+    f.regions[0].mutable_detail().y = 10.0;
     applyDynamicPanning(f, 5.0, -5.0);
-    ASSERT_EQ(f.regions[0].x, 15.0, "Panning X failed");
-    ASSERT_EQ(f.regions[0].y, 5.0, "Panning Y failed");
+    ASSERT_EQ(f.regions[0].detail().x, 15.0, "Panning X failed");
+    ASSERT_EQ(f.regions[0].detail().y, 5.0, "Panning Y failed");
 }
 void test_procedural_gan_patterns() {
     cerebra::BrainFrame f;
     cerebra::RegionState r{"R",0};
     r.plasticity_factor = 1.0;
-    r.x = 0.5; r.y = 0.5; r.z = 0.5;
+    r.mutable_detail().x = 0.5; r.mutable_detail().y = 0.5; r.mutable_detail().z = 0.5;
     f.regions.push_back(r);
     generateProceduralPattern(f);
     ASSERT_TRUE(f.regions[0].intensity > 0, "Procedural GAN failed");
@@ -34,12 +34,6 @@ void test_diffusion_modeling() {
     cerebra::RegionState r;
     r.region = "R";
     r.intensity = 0.5; // Initial intensity set to 0.5
-    // Explicitly initialize other members to their default state for robustness
-    r.subregions = std::vector<cerebra::RegionState>();
-    r.intensity_history = std::vector<double>();
-    r.synaptic_buffer = std::vector<double>();
-    r.neurotransmitters = std::map<std::string, double>();
-    r.neurotransmitters = std::map<std::string, double>();
     f.regions.push_back(r);
     applyNeuralCA(f); // applyNeuralCA should change intensity from 0.5
     ASSERT_TRUE(f.regions[0].intensity != 0.5, "Diffusion CA failed: Intensity remained 0.5");
@@ -245,9 +245,9 @@ BM_CASE(json_input_parses_metrics_map) {
     }])");
     BM_REQUIRE_EQ(frames.size(), std::size_t(1));
     const auto& rs = frames[0].regions[0];
-    BM_REQUIRE_EQ(rs.metrics.size(), std::size_t(2));
-    BM_REQUIRE_NEAR(rs.metrics.at("bold"), 0.82, 1e-9);
-    BM_REQUIRE_NEAR(rs.metrics.at("alpha_power"), 0.31, 1e-9);
+    BM_REQUIRE_EQ(rs.detail().metrics.size(), std::size_t(2));
+    BM_REQUIRE_NEAR(rs.detail().metrics.at("bold"), 0.82, 1e-9);
+    BM_REQUIRE_NEAR(rs.detail().metrics.at("alpha_power"), 0.31, 1e-9);
 }
 
 BM_CASE(json_input_ignores_non_numeric_metrics) {
@@ -261,13 +261,13 @@ BM_CASE(json_input_ignores_non_numeric_metrics) {
         "timestamp_ms":0
     }])");
     const auto& rs = frames[0].regions[0];
-    BM_REQUIRE_EQ(rs.metrics.size(), std::size_t(1));
-    BM_REQUIRE(rs.metrics.count("bold") == 1);
+    BM_REQUIRE_EQ(rs.detail().metrics.size(), std::size_t(1));
+    BM_REQUIRE(rs.detail().metrics.count("bold") == 1);
 }
 
 BM_CASE(json_input_no_metrics_keeps_map_empty) {
     cerebra::reset_current_atlas_to_builtin();
     auto frames = cerebra::parse_frames(
         R"([{"brain_activity":[{"region":"amygdala","intensity":0.5}],"timestamp_ms":0}])");
-    BM_REQUIRE(frames[0].regions[0].metrics.empty());
+    BM_REQUIRE(frames[0].regions[0].detail().metrics.empty());
 }
@@ -59,7 +59,7 @@ TEST_CASE("brain-state library: built-in by default, replaceable from JSON") {
   auto tl = BrainStateLibrary::synthesize_timeline(*dm, 20, 50);
   CHECK_EQ(tl.size(), static_cast<std::size_t>(20));
   for (const auto& s : tl.samples())
-    for (const auto& kv : s.intensities) { CHECK(kv.second >= 0.0); CHECK(kv.second <= 1.0); }
+    s.for_each([](std::string_view, double v) { CHECK(v >= 0.0); CHECK(v <= 1.0); });
   // Determinism is preserved.
   auto tl2 = BrainStateLibrary::synthesize_timeline(*dm, 20, 50);
   CHECK_NEAR(tl.at(11).intensity_of("amygdala"), tl2.at(11).intensity_of("amygdala"), 1e-12);
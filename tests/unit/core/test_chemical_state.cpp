@@ -0,0 +1,126 @@
+#include "core/neurochemistry.h"
+#include "core/atlas_region.h"
+#include "core/random.h"
+#include "io/json_parser.h"
+#include "../test_harness.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// The built-in atlas leaves primary transmitters unset; give every region one.
+struct ChemistryAtlas {
+    ChemistryAtlas() {
+        static const char* kTransmitters[] = {"dopamine", "serotonin", "norepinephrine", "acetylcholine",
+                                              "glutamate", "gaba", "unmodelled"};
+        cerebra::RegionAtlas atlas = cerebra::RegionAtlas::builtin();
+        std::size_t i = 0;
+        for (auto def : atlas.regions()) {
+            def.key = def.id;
+            def.primary_transmitter = kTransmitters[i++ % 7];
+            atlas.add_or_replace(std::move(def));
+        }
+        cerebra::set_current_atlas(std::move(atlas));
+    }
+    ~ChemistryAtlas() { cerebra::reset_current_atlas_to_builtin(); }
+};
+
+// The keyed definition of one step, written against the catalog directly.
+std::map<std::string, double> reference_step(std::map<std::string, double> levels,
+                                             const std::map<std::string, double>& intensities) {
+    std::map<std::string, double> release;
+    for (const auto& kv : intensities) {
+        const auto* region = cerebra::find_region(kv.first);
+        if (!region || !cerebra::Neurochemistry::find(region->primary_transmitter)) continue;
+        release[region->primary_transmitter] = std::max(release[region->primary_transmitter], kv.second);
+    }
+    for (const auto& nt : cerebra::Neurochemistry::catalog()) {
+        double level = levels.count(nt.key) ? levels[nt.key] : nt.baseline;
+        const double target = nt.baseline + nt.release_gain * release[nt.key] * (1.0 - nt.baseline);
+        if (target > level) level += 0.5 * (target - level);
+        level += nt.reuptake_rate * (nt.baseline - level);
+        levels[nt.key] = std::max(0.0, std::min(1.0, level));
+    }
+    return levels;
+}
+
+}
+
+void test_dense_step_matches_keyed_definition() {
+    ChemistryAtlas guard;
+    const auto& regions = cerebra::known_regions();
+    ASSERT_TRUE(!regions.empty(), "built-in atlas loaded (run from the repository root)");
+    cerebra::CounterRng rng(19, 0);
+    cerebra::ChemicalState keyed = cerebra::Neurochemistry::baseline_state();
+    cerebra::ChemicalState dense = keyed;
+    std::map<std::string, double> expected;
+    std::uint64_t n = 0;
+    double worst = 0.0;
+    bool released = false;
+    for (int frame = 0; frame < 40; ++frame) {
+        std::map<std::string, double> active;
+        std::vector<double> by_id(regions.size(), 0.0);
+        for (std::size_t r = 0; r < regions.size(); ++r) {
+            if (rng.uniform(n++) < 0.7) continue;
+            const double v = rng.uniform(n++);
+            active[regions[r].id] = v;
+            by_id[r] = v;
+        }
+        active["not_a_region"] = 1.0;
+        expected = reference_step(expected, active);
+        keyed = cerebra::Neurochemistry::step(keyed, active);
+        cerebra::Neurochemistry::advance(dense, by_id);
+        for (const auto& kv : expected) {
+            worst = std::max(worst, std::abs(keyed.at(kv.first) - kv.second));
+            worst = std::max(worst, std::abs(dense.at(kv.first) - kv.second));
+            released |= kv.second > cerebra::Neurochemistry::find(kv.first)->baseline + 0.05;
+        }
+    }
+    ASSERT_EQ(keyed.size(), cerebra::Neurochemistry::catalog().size(), "one level per transmitter");
+    ASSERT_TRUE(released, "regions drove release");
+    ASSERT_TRUE(worst == 0.0, "dense and keyed steps reproduce the definition exactly");
+}
+
+void test_flows_name_the_driving_region() {
+    ChemistryAtlas guard;
+    const auto& regions = cerebra::known_regions();
+    ASSERT_TRUE(regions.size() > 7, "built-in atlas loaded (run from the repository root)");
+    const auto prev = cerebra::Neurochemistry::baseline_state();
+    // Regions 0 and 7 share a transmitter; the stronger one is the source.
+    const std::map<std::string, double> active{{regions[0].id, 0.3}, {regions[7].id, 0.9}};
+    const auto cur = cerebra::Neurochemistry::step(prev, active);
+    bool found = false;
+    for (const auto& f : cerebra::Neurochemistry::flows(prev, cur, active)) {
+        if (f.transmitter != regions[7].primary_transmitter) continue;
+        ASSERT_TRUE(f.magnitude > 0, "release is positive");
+        ASSERT_EQ(f.source_region, regions[7].key, "strongest driving region");
+        found = true;
+    }
+    ASSERT_TRUE(found, "a release flow for the driven transmitter");
+}
+
+void test_state_survives_catalog_reload() {
+    auto s = cerebra::Neurochemistry::baseline_state();
+    s["dopamine"] = 0.9;
+    cerebra::Neurochemistry::load_from_json(cerebra::JsonValue::parse(
+        R"([{"key": "octopamine", "baseline": 0.1}, {"key": "dopamine", "baseline": 0.25}])"));
+    ASSERT_EQ(s.at("dopamine"), 0.9, "keyed reads use the state's own catalog");
+    ASSERT_EQ(s.count("octopamine"), 0u, "new transmitters are not in an old state");
+
+    cerebra::Neurochemistry::advance(s, {});
+    ASSERT_EQ(s.size(), 2u, "re-indexed by the active catalog");
+    ASSERT_TRUE(&s.catalog() == &cerebra::Neurochemistry::catalog(), "state follows the reload");
+    ASSERT_TRUE(std::abs(s.at("octopamine") - 0.1) < 1e-12, "new transmitter starts at baseline");
+    ASSERT_TRUE(s.at("dopamine") < 0.9 && s.at("dopamine") > 0.25, "dopamine carried over and relaxing");
+    ASSERT_EQ(s.count("serotonin"), 0u, "dropped transmitters are gone");
+    cerebra::Neurochemistry::reset_to_defaults();
+}
+
+int main() {
+    std::cout << "Tests: Chemical State\n";
+    run_test("DenseStepMatchesKeyed", test_dense_step_matches_keyed_definition);
+    run_test("FlowsNameDrivingRegion", test_flows_name_the_driving_region);
+    run_test("StateSurvivesCatalogReload", test_state_survives_catalog_reload);
+    return 0;
+}
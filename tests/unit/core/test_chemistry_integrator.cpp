@@ -0,0 +1,112 @@
+#include "core/chemistry_integrator.h"
+#include "core/atlas_region.h"
+#include "../test_harness.h"
+
+#include <cmath>
+
+namespace {
+
+// The built-in atlas leaves primary transmitters unset; route region 0 to
+// dopamine.
+struct DopamineAtlas {
+    DopamineAtlas() {
+        cerebra::RegionAtlas atlas = cerebra::RegionAtlas::builtin();
+        ASSERT_TRUE(atlas.size() > 0, "built-in atlas loaded (run from the repository root)");
+        auto def = atlas.regions()[0];
+        def.primary_transmitter = "dopamine";
+        atlas.add_or_replace(std::move(def));
+        cerebra::set_current_atlas(std::move(atlas));
+    }
+    ~DopamineAtlas() { cerebra::reset_current_atlas_to_builtin(); }
+};
+
+// Dopamine under constant pressure `p` from baseline, solved in closed form.
+double dopamine_at(double t_ms, double p, double reference_ms) {
+    const auto* da = cerebra::Neurochemistry::find("dopamine");
+    ASSERT_TRUE(da != nullptr, "dopamine in the catalog");
+    const double k_release = std::log(2.0) / reference_ms;
+    const double k_reuptake = -std::log1p(-da->reuptake_rate) / reference_ms;
+    const double target = da->baseline + da->release_gain * p * (1.0 - da->baseline);
+    const double settled = (k_release * target + k_reuptake * da->baseline) / (k_release + k_reuptake);
+    return settled + (da->baseline - settled) * std::exp(-(k_release + k_reuptake) * t_ms);
+}
+
+double run(cerebra::ChemistryIntegrator integrator, std::int64_t period_ms, std::int64_t until_ms,
+           std::size_t* steps = nullptr) {
+    cerebra::ChemistryTimeline timeline(integrator);
+    std::vector<double> intensity(cerebra::current_atlas().size(), 0.0);
+    intensity[0] = 0.8;
+    std::size_t taken = 0;
+    for (std::int64_t t = 0; t <= until_ms; t += period_ms) taken += timeline.update(t, intensity);
+    if (steps) *steps = taken;
+    return timeline.state().at("dopamine");
+}
+
+}
+
+void test_rate_independent() {
+    DopamineAtlas guard;
+    using Method = cerebra::ChemistryIntegrator::Method;
+    const double exact = dopamine_at(400.0, 0.8, 100.0);
+    for (Method method : {Method::RK4, Method::RK45}) {
+        const double limit = method == Method::RK4 ? 2e-6 : 1e-7;
+        for (std::int64_t period : {1, 10, 100, 400}) {
+            const double got = run(cerebra::ChemistryIntegrator(method), period, 400);
+            ASSERT_TRUE(std::abs(got - exact) < limit, "matches closed form at period " + std::to_string(period));
+        }
+    }
+}
+
+void test_stable_at_large_dt() {
+    DopamineAtlas guard;
+    using Method = cerebra::ChemistryIntegrator::Method;
+    const double settled = dopamine_at(1e12, 0.8, 100.0);
+    for (Method method : {Method::RK4, Method::RK45}) {
+        std::size_t steps = 0;
+        const double got = run(cerebra::ChemistryIntegrator(method), 1000000000, 1000000000, &steps);
+        ASSERT_TRUE(std::abs(got - settled) < 1e-9, "settles to the equilibrium");
+        ASSERT_TRUE(steps > 0 && steps < 2000, "sub-steps stay bounded");
+    }
+}
+
+void test_reuptake_matches_reference_step() {
+    // With no activity, one reference interval closes reuptake_rate of the
+    // gap to baseline, like one discrete step does.
+    const auto* gaba = cerebra::Neurochemistry::find("gaba");
+    ASSERT_TRUE(gaba != nullptr, "gaba in the catalog");
+    auto state = cerebra::Neurochemistry::baseline_state();
+    state.at("gaba") = 1.0;
+    auto discrete = state;
+    cerebra::Neurochemistry::advance(discrete, {});
+    cerebra::Neurochemistry::integrate(state, {}, 250.0,
+                                       cerebra::ChemistryIntegrator(cerebra::ChemistryIntegrator::Method::RK45, 250.0));
+    const double expected = gaba->baseline + (1.0 - gaba->reuptake_rate) * (1.0 - gaba->baseline);
+    ASSERT_TRUE(std::abs(state.at("gaba") - expected) < 1e-7, "one reference interval of reuptake");
+    ASSERT_TRUE(std::abs(discrete.at("gaba") - expected) < 1e-12, "discrete step agrees");
+}
+
+void test_timeline_clock() {
+    DopamineAtlas guard;
+    cerebra::ChemistryTimeline timeline;
+    std::vector<double> intensity(cerebra::current_atlas().size(), 1.0);
+    const double baseline = timeline.state().at("dopamine");
+    ASSERT_EQ(timeline.update(5000, intensity), 0u, "the first frame starts the clock");
+    ASSERT_EQ(timeline.state().at("dopamine"), baseline, "no time has passed");
+    ASSERT_TRUE(timeline.update(5100, intensity) > 0, "a 100 ms gap integrates");
+    const double after = timeline.state().at("dopamine");
+    ASSERT_TRUE(after > baseline, "release under activity");
+    ASSERT_EQ(timeline.update(5100, intensity), 0u, "a repeated timestamp is ignored");
+    ASSERT_EQ(timeline.update(4000, intensity), 0u, "time never runs backwards");
+    ASSERT_EQ(timeline.state().at("dopamine"), after, "state unchanged");
+    timeline.reset();
+    ASSERT_EQ(timeline.state().at("dopamine"), baseline, "reset returns to baseline");
+}
+
+int main() {
+    std::cout << "Tests: Chemistry Integrator\n";
+    run_test("RateIndependent", test_rate_independent);
+    run_test("StableAtLargeDt", test_stable_at_large_dt);
+    run_test("ReuptakeMatchesReferenceStep", test_reuptake_matches_reference_step);
+    run_test("TimelineClock", test_timeline_clock);
+    return 0;
+}
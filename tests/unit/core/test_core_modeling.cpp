@@ -5,8 +5,8 @@
 #include <vector>
 
 void test_hierarchical_regions() {
-    cerebra::RegionState r; r.subregions.push_back({});
-    ASSERT_EQ(r.subregions.size(), 1, "Subregion count mismatch");
+    cerebra::RegionState r; r.mutable_detail().subregions.add(cerebra::RegionTree::npos, "S1", 0.0);
+    ASSERT_EQ(r.detail().subregions.size(), 1, "Subregion count mismatch");
 }
 void test_temporal_smoothing_logic() {
     cerebra::BrainFrame f1; f1.regions={{"R1", 1.0}};
@@ -51,7 +51,7 @@ void test_neurotransmitter_logic() {
     cerebra::BrainFrame f; f.regions={{"R1", 0.9}};
     std::vector<cerebra::BrainFrame> fs={f};
     applyNeurotransmitterSimulation(fs);
-    ASSERT_TRUE(fs[0].regions[0].neurotransmitters.count("Glutamate"), "Neurotransmitter Glutamate missing");
+    ASSERT_TRUE(fs[0].regions[0].detail().neurotransmitters.count("Glutamate"), "Neurotransmitter Glutamate missing");
 }
 void test_ltp_logic_check() {
     cerebra::BrainFrame f; f.regions={{"R1", 1.0}};
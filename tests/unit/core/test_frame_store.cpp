@@ -0,0 +1,210 @@
+#include "core/frame_store.h"
+#include "core/simulation_engine.h"
+#include "../test_harness.h"
+
+#include <cmath>
+#include <string_view>
+#include <type_traits>
+
+namespace {
+
+cerebra::BrainFrame frame_of(std::int64_t ts, std::vector<std::pair<std::string, double>> rs) {
+    cerebra::BrainFrame f;
+    f.timestamp_ms = ts;
+    for (auto& kv : rs) f.regions.push_back(cerebra::make_region_state(kv.first, kv.second));
+    return f;
+}
+
+}
+
+void test_store_columns_and_absent_cells() {
+    std::vector<cerebra::BrainFrame> frames = {
+        frame_of(0, {{"amygdala", 0.2}, {"insula", 0.4}}),
+        frame_of(100, {{"insula", 0.6}, {"custom_probe", 0.9}}),
+    };
+    cerebra::FrameStore store(frames);
+    ASSERT_EQ(store.frame_count(), 2u, "frame count");
+    ASSERT_EQ(store.column_count(), 3u, "column count");
+    ASSERT_EQ(store.timestamp(1), 100, "timestamp column");
+
+    auto v0 = store.view(0);
+    ASSERT_EQ(v0.intensity_of("amygdala"), 0.2, "present cell");
+    ASSERT_EQ(v0.intensity_of("custom_probe"), 0.0, "absent cell reads 0");
+    auto v1 = store.view(1);
+    ASSERT_EQ(v1.intensity_of("custom_probe"), 0.9, "non-atlas column");
+    ASSERT_EQ(v1.intensity_of(cerebra::region_id_for("insula")), 0.6, "lookup by id");
+    ASSERT_EQ(v1.to_frame().regions.size(), 2u, "materialise only present regions");
+}
+
+void test_store_side_tables_round_trip() {
+    cerebra::BrainFrame f = frame_of(0, {{"amygdala", 0.5}});
+    f.regions[0].mutable_detail().metrics["bold"] = 0.82;
+    f.regions[0].flows = {{"dopamine", 0.3}};
+    cerebra::FrameStore store({f});
+    cerebra::BrainFrame back = store.materialize(0);
+    ASSERT_EQ(back.regions.size(), 1u, "region count");
+    ASSERT_EQ(back.regions[0].detail().metrics.at("bold"), 0.82, "metric kept");
+    ASSERT_EQ(back.regions[0].flows.size(), 1u, "custom flows kept");
+    ASSERT_EQ(back.regions[0].flows[0].type, "dopamine", "custom flow type");
+
+    cerebra::FrameStore plain({frame_of(0, {{"amygdala", 0.5}})});
+    auto expected = cerebra::default_flows_for("amygdala", 0.5);
+    ASSERT_EQ(plain.materialize(0).regions[0].effective_flows().size(), expected.size(), "default flows derived");
+
+    ASSERT_TRUE(plain.materialize(0).regions[0].atlas_flows, "atlas flows restored");
+
+    cerebra::BrainFrame modeled = frame_of(0, {{"amygdala", 0.5}});
+    modeled.regions[0].intensity = 0.9;
+    cerebra::FrameStore kept({modeled});
+    ASSERT_EQ(kept.materialize(0).regions[0].effective_flows()[0].rate, expected[0].rate,
+              "flows stay at the reading through the store");
+
+    cerebra::BrainFrame bare;
+    bare.regions.push_back({"amygdala", 0.5});
+    cerebra::FrameStore none({bare});
+    ASSERT_TRUE(none.custom_flows(0, 0) == nullptr, "no side-table entry for no flows");
+    ASSERT_TRUE(!none.materialize(0).regions[0].atlas_flows, "no atlas flows restored");
+    ASSERT_TRUE(none.materialize(0).regions[0].effective_flows().empty(), "no flows stays no flows");
+
+    cerebra::BrainFrame spelled = frame_of(0, {{"amygdala", 0.5}});
+    spelled.regions[0].flows = cerebra::default_flows_for("amygdala", 0.5);
+    spelled.regions[0].atlas_flows = false;
+    cerebra::FrameStore folded({spelled});
+    ASSERT_TRUE(folded.custom_flows(0, 0) == nullptr, "spelled-out defaults folded");
+    ASSERT_EQ(folded.materialize(0).regions[0].effective_flows().size(), expected.size(), "folded defaults derived");
+}
+
+void test_store_copies_and_releases_arena() {
+    cerebra::BrainFrame f = frame_of(0, {{"amygdala", 0.5}, {"custom_probe", 0.2}});
+    f.regions[0].mutable_detail().metrics["bold"] = 0.82;
+    cerebra::FrameStore store({f});
+
+    cerebra::FrameStore copy = store;
+    static_assert(std::is_nothrow_move_constructible_v<cerebra::FrameStore>, "stores move without allocating");
+    cerebra::FrameStore moved = std::move(store);
+    ASSERT_TRUE(store.column_of("amygdala") == cerebra::FrameStore::npos, "moved-from store is empty");
+    store.clear();
+    ASSERT_TRUE(store.empty() && store.column_count() == 0, "cleared store");
+    ASSERT_EQ(copy.metrics(0, copy.column_of("amygdala"))->at("bold"), 0.82, "copy owns its side tables");
+    ASSERT_TRUE(copy.metrics(0, copy.column_of("amygdala"))->count(std::string_view("bold")) == 1, "metric lookup by view");
+    ASSERT_EQ(moved.column_key(moved.column_of("custom_probe")), "custom_probe", "moved keys intact");
+
+    moved.clear();
+    moved.append(frame_of(5, {{"insula", 0.3}}));
+    ASSERT_EQ(moved.column_count(), 1u, "reusable after clear");
+    ASSERT_TRUE(moved.metrics(0, 0) == nullptr, "side tables released");
+}
+
+void test_store_append_grows_columns() {
+    cerebra::FrameStore store;
+    for (int i = 0; i < 20; ++i) {
+        store.append(frame_of(i, {{"region_" + std::to_string(i), i / 20.0}, {"amygdala", 0.1}}));
+    }
+    ASSERT_EQ(store.column_count(), 21u, "columns added on demand");
+    ASSERT_EQ(store.view(0).intensity_of("region_0"), 0.0, "first column kept after growth");
+    ASSERT_EQ(store.view(19).intensity_of("region_19"), 19 / 20.0, "latest cell");
+    ASSERT_EQ(store.view(7).intensity_of("amygdala"), 0.1, "shared column");
+}
+
+void test_store_presence_is_not_a_value() {
+    cerebra::FrameStore store;
+    store.append(frame_of(0, {{"amygdala", std::nan("")}}));
+    for (int i = 0; i < 70; ++i) store.append(frame_of(i + 1, {{"region_" + std::to_string(i), 0.5}}));
+    const std::size_t amygdala = store.column_of("amygdala");
+    ASSERT_TRUE(store.present(0, amygdala), "NaN reading is present");
+    ASSERT_TRUE(std::isnan(store.intensity(0, amygdala)), "NaN reading kept");
+    ASSERT_EQ(store.materialize(0).regions.size(), 1u, "NaN cell materialised");
+    ASSERT_TRUE(!store.present(1, amygdala), "unreported cell absent");
+    ASSERT_TRUE(store.present(70, store.column_of("region_69")), "presence past 64 columns");
+    ASSERT_TRUE(!store.present(70, store.column_of("region_0")), "absent past 64 columns");
+}
+
+void test_simulation_reads_through_views() {
+    cerebra::Simulation sim({frame_of(0, {{"amygdala", 0.1}}), frame_of(50, {{"amygdala", 0.7}})});
+    sim.advance(1);
+    ASSERT_EQ(sim.current().timestamp_ms, 50, "cursor timestamp");
+    ASSERT_EQ(sim.current().intensity_of("amygdala"), 0.7, "cursor intensity");
+    ASSERT_EQ(sim.at(0).intensity_of("amygdala"), 0.1, "random access");
+}
+
+void test_store_survives_atlas_swap() {
+    cerebra::Simulation sim({frame_of(0, {{"prefrontal_cortex", 0.0}, {"occipital_lobe", 0.9}})});
+    cerebra::RegionAtlas reversed;
+    const auto& regions = cerebra::current_atlas().regions();
+    for (auto it = regions.rbegin(); it != regions.rend(); ++it) reversed.add_or_replace(*it);
+    cerebra::set_current_atlas(reversed);
+    ASSERT_EQ(sim.current().intensity_of("prefrontal_cortex"), 0.0, "key after swap");
+    ASSERT_EQ(sim.current().intensity_of("occipital_lobe"), 0.9, "other key after swap");
+    ASSERT_EQ(sim.current().intensity_of(cerebra::region_id_for("occipital_lobe")), 0.9, "id after swap");
+    ASSERT_EQ(sim.current().to_frame().regions[1].region_id, cerebra::region_id_for("occipital_lobe"),
+              "materialised ids follow the current atlas");
+    cerebra::reset_current_atlas_to_builtin();
+}
+
+void test_region_series_and_timeline_handoff() {
+    cerebra::ActivityTimeline tl;
+    for (int i = 0; i < 4; ++i) {
+        cerebra::BrainActivitySample s;
+        s.timestamp_ms = i * 10;
+        if (i != 2) s.set("amygdala", i / 4.0);
+        s.set("custom_probe", 0.5);
+        tl.append(std::move(s));
+    }
+    cerebra::Simulation sim;
+    sim.set_timeline(std::move(tl));
+    ASSERT_EQ(sim.duration_ms(), 30, "duration from timestamps");
+
+    auto series = sim.series("amygdala");
+    ASSERT_EQ(series.size(), 4u, "one value per frame");
+    ASSERT_EQ(series[1], 0.25, "reported cell");
+    ASSERT_EQ(series[2], 0.0, "unreported cell reads 0");
+    double sum = 0.0;
+    for (double v : sim.series("custom_probe")) sum += v;
+    ASSERT_EQ(sum, 2.0, "non-atlas series");
+    ASSERT_EQ(sim.series("insula").size(), 4u, "unknown region still spans the timeline");
+}
+
+void test_dense_samples_and_late_append() {
+    cerebra::BrainActivitySample s;
+    s.set("amygdala", 0.4);
+    s.set("custom_probe", 0.9);
+    s.set("amygdala", 0.6);
+    ASSERT_EQ(s.size(), 2u, "overwrite keeps one entry");
+    ASSERT_EQ(s.intensity_of("amygdala"), 0.6, "atlas region");
+    ASSERT_EQ(s.intensity_of(cerebra::region_id_for("amygdala")), 0.6, "dense lookup by id");
+    ASSERT_EQ(s.intensity_of("custom_probe"), 0.9, "non-atlas region");
+    ASSERT_EQ(s.intensity_of("insula"), 0.0, "unreported region");
+
+    // NaN is an ordinary value, not an "unreported" marker.
+    s.set("insula", std::nan(""));
+    s.set("insula", std::nan(""));
+    ASSERT_EQ(s.size(), 3u, "a NaN reading counts once");
+    ASSERT_TRUE(std::isnan(s.intensity_of("insula")), "NaN reads back");
+    std::size_t visited = 0;
+    s.for_each([&](std::string_view, double) { ++visited; });
+    ASSERT_EQ(visited, s.size(), "every counted region is visited");
+
+    cerebra::ActivityTimeline tl;
+    for (std::int64_t ts : {0, 100, 200, 150, 300, 50}) {
+        cerebra::BrainActivitySample late;
+        late.timestamp_ms = ts;
+        tl.append(std::move(late));
+    }
+    std::vector<std::int64_t> order;
+    for (const auto& x : tl.samples()) order.push_back(x.timestamp_ms);
+    ASSERT_TRUE((order == std::vector<std::int64_t>{0, 50, 100, 150, 200, 300}), "late samples sorted in");
+}
+
+int main() {
+    std::cout << "Tests: Frame Store\n";
+    run_test("ColumnsAndAbsentCells", test_store_columns_and_absent_cells);
+    run_test("SideTables", test_store_side_tables_round_trip);
+    run_test("CopyAndRelease", test_store_copies_and_releases_arena);
+    run_test("AppendGrowsColumns", test_store_append_grows_columns);
+    run_test("PresenceBitmap", test_store_presence_is_not_a_value);
+    run_test("SimulationViews", test_simulation_reads_through_views);
+    run_test("AtlasSwap", test_store_survives_atlas_swap);
+    run_test("RegionSeries", test_region_series_and_timeline_handoff);
+    run_test("DenseSamples", test_dense_samples_and_late_append);
+    return 0;
+}
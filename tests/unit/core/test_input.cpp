@@ -42,7 +42,7 @@ TEST_CASE("timeline: from_json tolerates entries with no usable region") {
       "\"timestamp_ms\":7}]");
   CHECK_EQ(tl.size(), static_cast<std::size_t>(1));
   CHECK_EQ(tl.at(0).timestamp_ms, static_cast<std::int64_t>(7));
-  CHECK(tl.at(0).intensities.empty());
+  CHECK(tl.at(0).empty());
 }
 
 TEST_CASE("timeline: from_json_file reports missing, empty and malformed files") {
@@ -0,0 +1,154 @@
+#include "core/intensity_expression.h"
+#include "core/atlas_region.h"
+#include "core/modeling_pipeline.h"
+#include "../test_harness.h"
+
+#include <cmath>
+#include <stdexcept>
+
+using cerebra::IntensityExpression;
+
+void test_precedence_and_folding() {
+    ASSERT_EQ(IntensityExpression::compile("1 + 2 * 3").evaluate(0.0), 7.0, "* binds tighter than +");
+    ASSERT_EQ(IntensityExpression::compile("-x^2").evaluate(3.0), -9.0, "^ binds tighter than unary -");
+    ASSERT_EQ(IntensityExpression::compile("2^3^2").evaluate(0.0), 512.0, "^ is right-associative");
+    ASSERT_EQ(IntensityExpression::compile("(1 - x) / 4").evaluate(0.2), 0.2, "parentheses");
+    ASSERT_EQ(IntensityExpression::compile("x * (2 * pi / pi)").instruction_count(), 3u,
+              "constant subexpression folded to one instruction");
+    ASSERT_EQ(IntensityExpression::compile("min(x, 0.3) + max(x, 0.3)").evaluate(0.5), 0.8, "two-argument calls");
+}
+
+void test_variables_and_metadata() {
+    auto e = IntensityExpression::compile("clamp(0.5*x^2 + 0.2*sin(t*pi), 0, 1)");
+    ASSERT_TRUE(e.uses_time() && !e.uses_region(), "time used, metadata not");
+    ASSERT_TRUE(std::abs(e.evaluate(0.8, 0.5) - (0.5 * 0.64 + 0.2)) < 1e-15, "formula from the config example");
+    ASSERT_EQ(e.evaluate(2.0, 0.5), 1.0, "clamped");
+
+    const cerebra::RegionId amygdala = cerebra::region_id_for("amygdala");
+    const auto* def = cerebra::current_atlas().at(amygdala);
+    ASSERT_TRUE(def != nullptr, "amygdala in the built-in atlas (run from the repository root)");
+    const double depth = def->depth;
+    const double roi = def->region_of_interest ? 1.0 : 0.0;
+    auto d = IntensityExpression::compile("x * depth + roi");
+    ASSERT_TRUE(d.uses_region(), "metadata used");
+    ASSERT_EQ(d.evaluate(0.5, 0.0, amygdala), 0.5 * depth + roi, "atlas metadata per region");
+}
+
+void test_batches_match_single_values() {
+    auto e = IntensityExpression::compile("sqrt(abs(x)) * cos(time) - log(1 + x*x) / 3");
+    std::vector<double> x(1000), t(1000);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        x[i] = std::sin(i * 0.7);
+        t[i] = i * 0.01;
+    }
+    std::vector<double> batch = x;
+    e.evaluate(batch.data(), t.data(), nullptr, batch.size());
+    bool same = true;
+    for (std::size_t i = 0; i < x.size(); ++i) same = same && batch[i] == e.evaluate(x[i], t[i]);
+    ASSERT_TRUE(same, "column evaluation matches element-wise");
+
+    // Every opcode has its own batch loop; each must agree with the folded form.
+    const char* calls[] = {"pow(abs(x), 1.5)", "sin(x)", "cos(x)", "tan(x)", "exp(x)", "log(abs(x))",
+                           "sqrt(abs(x))", "abs(x)", "floor(x * 4)", "min(x, t)", "max(x, t)",
+                           "clamp(x, -t, t)", "-x / (1 + x) - x * t"};
+    for (const char* call : calls) {
+        auto f = IntensityExpression::compile(call);
+        batch = x;
+        f.evaluate(batch.data(), t.data(), nullptr, batch.size());
+        bool match = true;
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            const double v = f.evaluate(x[i], t[i]);
+            match = match && (batch[i] == v || (std::isnan(batch[i]) && std::isnan(v)));
+        }
+        ASSERT_TRUE(match, call);
+    }
+}
+
+void test_errors_name_the_column() {
+    auto message = [](const char* src) {
+        try {
+            IntensityExpression::compile(src);
+        } catch (const std::runtime_error& e) {
+            return std::string(e.what());
+        }
+        return std::string();
+    };
+    ASSERT_TRUE(message("x + cube(x)").find("unknown function 'cube' at column 5") != std::string::npos,
+                "unknown function");
+    ASSERT_TRUE(message("x * y").find("unknown name 'y' at column 5") != std::string::npos, "unknown variable");
+    ASSERT_TRUE(message("clamp(x, 0)").find("takes 3 argument(s)") != std::string::npos, "arity");
+    ASSERT_TRUE(message("(x + 1").find("expected ')'") != std::string::npos, "unbalanced");
+    ASSERT_TRUE(message("x 2").find("unexpected '2'") != std::string::npos, "trailing input");
+}
+
+void test_oversized_expressions_are_rejected() {
+    auto message = [](const std::string& src) {
+        try {
+            IntensityExpression::compile(src);
+        } catch (const std::runtime_error& e) {
+            return std::string(e.what());
+        }
+        return std::string();
+    };
+    const std::string nested = std::string(5000, '(') + "x" + std::string(5000, ')');
+    ASSERT_TRUE(message(nested).find("nested too deeply") != std::string::npos, "parenthesis depth");
+    ASSERT_TRUE(message(std::string(5000, '-') + "x").find("nested too deeply") != std::string::npos,
+                "unary depth");
+    std::string chain = "x";
+    for (int i = 0; i < 5000; ++i) chain += "+x";
+    ASSERT_TRUE(message(chain).find("nested too deeply") != std::string::npos, "operator chain depth");
+
+    // 140 sums of 500 terms stay shallow but need ~70000 registers.
+    std::string group = "(x";
+    for (int i = 1; i < 500; ++i) group += "*x";
+    group += ")";
+    std::string wide = group;
+    for (int i = 1; i < 140; ++i) wide += "+" + group;
+    ASSERT_TRUE(message(wide).find("more than 65535 registers") != std::string::npos, "register count");
+    ASSERT_TRUE(message(group).empty(), "a large but valid expression still compiles");
+}
+
+void test_transform_stage_accepts_formulas() {
+    std::vector<cerebra::BrainFrame> frames(2);
+    frames[0].regions.push_back(cerebra::make_region_state("amygdala", 0.5));
+    frames[1].timestamp_ms = 1500;
+    frames[1].regions.push_back(cerebra::make_region_state("amygdala", 0.5));
+    cerebra::ModelingPipeline().add(cerebra::make_transform_stage("x + t / 10")).run(frames);
+    ASSERT_EQ(frames[0].regions[0].intensity, 0.5, "t = 0 s");
+    ASSERT_EQ(frames[1].regions[0].intensity, 0.65, "t = 1.5 s");
+
+    // Enough regions to split across tasks, each evaluating in its own registers.
+    const char* names[] = {"amygdala", "hippocampus", "thalamus", "insula"};
+    std::vector<cerebra::BrainFrame> wide(8), serial;
+    for (std::size_t i = 0; i < wide.size(); ++i) {
+        wide[i].timestamp_ms = static_cast<std::int64_t>(i) * 250;
+        for (int r = 0; r < 400; ++r) {
+            wide[i].regions.push_back(cerebra::make_region_state(names[r % 4], (r % 97) / 97.0));
+        }
+    }
+    serial = wide;
+    cerebra::ModelingPipeline one;
+    one.add(cerebra::make_transform_stage("clamp(x^2 + sin(t * pi) * depth, 0, 1)")).set_threads(1);
+    one.run(serial);
+    cerebra::ModelingPipeline many;
+    many.add(cerebra::make_transform_stage("clamp(x^2 + sin(t * pi) * depth, 0, 1)")).set_threads(8);
+    many.run(wide);
+    bool same = true;
+    for (std::size_t i = 0; i < wide.size(); ++i) {
+        for (std::size_t r = 0; r < wide[i].regions.size(); ++r) {
+            same = same && wide[i].regions[r].intensity == serial[i].regions[r].intensity;
+        }
+    }
+    ASSERT_TRUE(same, "threaded transform matches serial");
+}
+
+int main() {
+    std::cout << "Tests: Intensity Expressions\n";
+    run_test("PrecedenceAndFolding", test_precedence_and_folding);
+    run_test("VariablesAndMetadata", test_variables_and_metadata);
+    run_test("BatchesMatchSingle", test_batches_match_single_values);
+    run_test("ErrorsNameColumn", test_errors_name_the_column);
+    run_test("OversizedExpressions", test_oversized_expressions_are_rejected);
+    run_test("TransformStageFormulas", test_transform_stage_accepts_formulas);
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include "core/intensity_kernels.h"
+#include "../test_harness.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+void test_parse_transform_names() {
+    ASSERT_TRUE(cerebra::parse_intensity_transform("sqrt") == cerebra::IntensityTransform::Sqrt, "sqrt");
+    ASSERT_TRUE(cerebra::parse_intensity_transform("exp") == cerebra::IntensityTransform::Exp, "exp");
+    ASSERT_TRUE(cerebra::parse_intensity_transform("linear") == cerebra::IntensityTransform::Identity, "linear");
+    ASSERT_TRUE(cerebra::parse_intensity_transform("cube") == cerebra::IntensityTransform::Identity, "unknown");
+}
+
+void test_polynomials_within_bounds() {
+    const double pi = 3.14159265358979323846;
+    double sin_err = 0.0, exp_err = 0.0;
+    for (int i = -4000; i <= 4000; ++i) {
+        double x = i * 0.00137;
+        sin_err = std::max(sin_err, std::abs(cerebra::fast_sin_pi(x) - std::sin(pi * x)));
+        exp_err = std::max(exp_err, std::abs(cerebra::fast_exp(x) / std::exp(x) - 1.0));
+    }
+    // Loose against libm, whose sin(pi * x) itself carries the rounding of pi * x.
+    ASSERT_TRUE(sin_err < 1e-14, "fast_sin_pi close to sin(pi x)");
+    ASSERT_TRUE(exp_err < 1e-15, "fast_exp close to exp");
+    ASSERT_EQ(cerebra::fast_sin_pi(3.0), 0.0, "integers are exact zeros");
+    ASSERT_TRUE(std::abs(cerebra::fast_sin_pi(2.5) - 1.0) < 1e-15, "peak at half-integers");
+    ASSERT_EQ(cerebra::fast_exp(0.0), 1.0, "e^0");
+    ASSERT_TRUE(std::isfinite(cerebra::fast_exp(1e6)), "large arguments clamped");
+}
+
+void test_simd_matches_scalar() {
+    std::vector<double> in(1003);
+    for (std::size_t i = 0; i < in.size(); ++i) in[i] = std::sin(i * 0.37) * 3.0;
+    for (auto t : {cerebra::IntensityTransform::Square, cerebra::IntensityTransform::Sqrt,
+                   cerebra::IntensityTransform::Sin, cerebra::IntensityTransform::Exp}) {
+        auto simd = in, scalar = in;
+        cerebra::apply_intensity_transform(t, simd.data(), simd.size());
+        cerebra::apply_intensity_transform_scalar(t, scalar.data(), scalar.size());
+        ASSERT_TRUE(std::memcmp(simd.data(), scalar.data(), in.size() * sizeof(double)) == 0,
+                    "dispatched kernel bit-identical to scalar");
+    }
+    ASSERT_TRUE(std::strlen(cerebra::intensity_kernel_isa()) > 0, "kernel reported");
+}
+
+void test_nan_propagates() {
+    ASSERT_TRUE(std::isnan(cerebra::fast_exp(std::nan(""))), "fast_exp(NaN)");
+    // NaNs in SIMD lanes and in the scalar tail.
+    std::vector<double> in(11, 0.5);
+    for (std::size_t i : {1u, 4u, 6u, 10u}) in[i] = std::nan("");
+    for (auto t : {cerebra::IntensityTransform::Square, cerebra::IntensityTransform::Sqrt,
+                   cerebra::IntensityTransform::Sin, cerebra::IntensityTransform::Exp}) {
+        auto simd = in, scalar = in;
+        cerebra::apply_intensity_transform(t, simd.data(), simd.size());
+        cerebra::apply_intensity_transform_scalar(t, scalar.data(), scalar.size());
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            ASSERT_TRUE(std::isnan(simd[i]) == std::isnan(in[i]), "dispatched kernel keeps NaN as NaN");
+            ASSERT_TRUE(std::isnan(scalar[i]) == std::isnan(in[i]), "scalar kernel keeps NaN as NaN");
+        }
+    }
+}
+
+int main() {
+    std::cout << "Tests: Intensity Kernels\n";
+    run_test("ParseNames", test_parse_transform_names);
+    run_test("PolynomialBounds", test_polynomials_within_bounds);
+    run_test("SimdMatchesScalar", test_simd_matches_scalar);
+    run_test("NanPropagates", test_nan_propagates);
+    return 0;
+}
@@ -0,0 +1,281 @@
+#include "core/modeling_pipeline.h"
+#include "core/pathway_logic.h"
+#include "io/json_parser.h"
+#include "../test_harness.h"
+
+#include <cmath>
+
+// The stage-at-a-time entry points (defined in core/modeling_engine.cpp).
+void applyTemporalSmoothing(std::vector<cerebra::BrainFrame>& frames, int window_size);
+void applyActivityDecayModel(std::vector<cerebra::BrainFrame>& frames, double decay_rate);
+void applySynapticDelaySimulation(std::vector<cerebra::BrainFrame>& frames, int delay_frames);
+void applyCustomMathematicalFunctions(std::vector<cerebra::BrainFrame>& frames, const std::string& transform);
+void applyLongTermPotentiation(std::vector<cerebra::BrainFrame>& frames, double threshold, double increment);
+
+namespace {
+
+std::vector<cerebra::BrainFrame> ramp(int frames, int regions) {
+    std::vector<cerebra::BrainFrame> out(frames);
+    for (int i = 0; i < frames; ++i) {
+        out[i].timestamp_ms = i * 40;
+        for (int r = 0; r < regions; ++r) {
+            out[i].regions.push_back({"r" + std::to_string(r), std::fmod(0.13 * i + 0.29 * r, 1.0)});
+        }
+    }
+    return out;
+}
+
+// Frame 0 bound against {amygdala, insula}, frame 1 against the same
+// regions in the opposite order; the second atlas is left current. Depths are
+// 0.1 for the amygdala and 0.3 for the insula.
+std::vector<cerebra::BrainFrame> frames_across_a_swap() {
+    std::vector<cerebra::BrainFrame> frames(2);
+    frames[1].timestamp_ms = 40;
+    cerebra::RegionDefinition amygdala{"amygdala"}, insula{"insula"};
+    amygdala.depth = 0.1;
+    insula.depth = 0.3;
+    cerebra::RegionAtlas atlas;
+    atlas.add_or_replace(amygdala);
+    atlas.add_or_replace(insula);
+    cerebra::set_current_atlas(atlas);
+    frames[0].regions = {cerebra::make_region_state("amygdala", 0.2), cerebra::make_region_state("insula", 0.8)};
+    cerebra::RegionAtlas swapped;
+    swapped.add_or_replace(insula);
+    swapped.add_or_replace(amygdala);
+    cerebra::set_current_atlas(swapped);
+    frames[1].regions = {cerebra::make_region_state("amygdala", 0.4), cerebra::make_region_state("insula", 1.0)};
+    return frames;
+}
+
+double max_diff(const std::vector<cerebra::BrainFrame>& a, const std::vector<cerebra::BrainFrame>& b) {
+    double d = 0.0;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        for (std::size_t r = 0; r < a[i].regions.size(); ++r) {
+            d = std::max(d, std::abs(a[i].regions[r].intensity - b[i].regions[r].intensity));
+        }
+    }
+    return d;
+}
+
+}
+
+void test_from_config_selects_enabled_stages() {
+    AppConfig c;
+    c.activity_decay_rate = 0.0;
+    c.ltp_increment = 0.0;
+    ASSERT_TRUE(cerebra::ModelingPipeline::from_config(c).empty(), "defaults minus decay/LTP are a no-op");
+
+    c.smoothing_window_size = 3;
+    c.intensity_transform = "sqrt";
+    c.ltp_increment = 0.05;
+    auto names = cerebra::ModelingPipeline::from_config(c).stage_names();
+    ASSERT_EQ(names.size(), 3u, "three stages enabled");
+    ASSERT_EQ(names.front(), "temporal_smoothing", "smoothing runs first");
+    ASSERT_EQ(names.back(), "ltp", "LTP runs last");
+}
+
+void test_fused_pass_matches_stage_by_stage() {
+    AppConfig c;
+    c.smoothing_window_size = 5;
+    c.activity_decay_rate = 0.2;
+    c.synaptic_delay_frames = 3;
+    c.intensity_transform = "sin";
+    c.ltp_threshold = 0.5;
+    c.ltp_increment = 0.02;
+
+    auto expected = ramp(150, 6);
+    ::applyTemporalSmoothing(expected, c.smoothing_window_size);
+    ::applyActivityDecayModel(expected, c.activity_decay_rate);
+    ::applySynapticDelaySimulation(expected, c.synaptic_delay_frames);
+    ::applyCustomMathematicalFunctions(expected, c.intensity_transform);
+    ::applyLongTermPotentiation(expected, c.ltp_threshold, c.ltp_increment);
+
+    for (std::size_t block : {1u, 4u, 64u, 1000u}) {
+        auto fused = ramp(150, 6);
+        auto pipeline = cerebra::ModelingPipeline::from_config(c);
+        pipeline.set_block_frames(block);
+        pipeline.run(fused);
+        ASSERT_TRUE(max_diff(expected, fused) < 1e-12, "fused result independent of block size");
+    }
+}
+
+void test_smoothing_is_centered_mean_by_region() {
+    // Regions arrive in a different order each frame and "r2" drops out now
+    // and then; every output is the mean of that region's incoming values
+    // over the frames within `half` of it that report it.
+    std::vector<cerebra::BrainFrame> input(40);
+    for (int i = 0; i < 40; ++i) {
+        for (int k = 0; k < 4; ++k) {
+            int r = (k + i) % 4;
+            if (r == 2 && i % 3 == 0) continue;
+            input[i].regions.push_back({"r" + std::to_string(r), std::fmod(0.37 * i + 0.11 * r, 1.0)});
+        }
+    }
+    for (int window : {3, 4, 9, 101}) {
+        const int half = window / 2;
+        auto smoothed = input;
+        auto pipeline = cerebra::ModelingPipeline();
+        pipeline.add(cerebra::make_temporal_smoothing_stage(window)).set_block_frames(7);
+        pipeline.run(smoothed);
+
+        double worst = 0.0;
+        for (int i = 0; i < 40; ++i) {
+            for (const auto& out : smoothed[i].regions) {
+                double sum = 0.0;
+                int count = 0;
+                for (int j = std::max(0, i - half); j <= std::min(39, i + half); ++j) {
+                    for (const auto& in : input[j].regions) {
+                        if (in.region == out.region) {
+                            sum += in.intensity;
+                            ++count;
+                        }
+                    }
+                }
+                worst = std::max(worst, std::abs(out.intensity - sum / count));
+            }
+        }
+        ASSERT_TRUE(worst < 1e-12, "smoothing matches brute-force centered mean");
+    }
+}
+
+void test_smoothing_matches_regions_across_an_atlas_swap() {
+    auto frames = frames_across_a_swap();
+    cerebra::ModelingPipeline().add(cerebra::make_temporal_smoothing_stage(3)).run(frames);
+    ASSERT_TRUE(std::abs(frames[0].regions[0].intensity - 0.3) < 1e-12, "amygdala averaged with amygdala");
+    ASSERT_TRUE(std::abs(frames[0].regions[1].intensity - 0.9) < 1e-12, "insula averaged with insula");
+    cerebra::reset_current_atlas_to_builtin();
+}
+
+void test_pathways_match_regions_across_an_atlas_swap() {
+    cerebra::PathwayCatalog::load_from_json(cerebra::JsonValue::parse(
+        R"([{"from": "insula", "to": "amygdala", "weight": 0.5, "delay_ms": 40}])"));
+    auto frames = frames_across_a_swap();
+    cerebra::ModelingPipeline().add(cerebra::make_pathway_stage(1.0, 40)).run(frames);
+    // Frame 1's amygdala gets half of frame 0's insula (0.8), not of its amygdala.
+    ASSERT_TRUE(std::abs(frames[1].regions[0].intensity - 0.8) < 1e-12, "insula drives amygdala");
+    cerebra::PathwayCatalog::reset_to_defaults();
+    cerebra::reset_current_atlas_to_builtin();
+}
+
+void test_expression_metadata_across_an_atlas_swap() {
+    auto frames = frames_across_a_swap();
+    cerebra::ModelingPipeline().add(cerebra::make_transform_stage("depth")).run(frames);
+    ASSERT_EQ(frames[0].regions[0].intensity, 0.1, "amygdala depth for a state bound before the swap");
+    ASSERT_EQ(frames[0].regions[1].intensity, 0.3, "insula depth for a state bound before the swap");
+    ASSERT_EQ(frames[1].regions[0].intensity, 0.1, "amygdala depth for a state bound after the swap");
+    cerebra::reset_current_atlas_to_builtin();
+}
+
+void test_threaded_stages_match_serial() {
+    AppConfig c;
+    c.activity_decay_rate = 0.3;
+    c.refractory_period_ms = 120;
+    c.intensity_transform = "exp";
+    c.enable_neurotransmitter_simulation = true;
+    c.ltp_threshold = 0.4;
+    c.ltp_increment = 0.03;
+
+    // Wide enough to split, with a ragged region count from frame to frame.
+    auto input = ramp(90, 150);
+    for (std::size_t i = 0; i < input.size(); i += 7) input[i].regions.resize(100 + i);
+
+    c.modeling_threads = 1;
+    auto serial = input;
+    cerebra::ModelingPipeline::from_config(c).run(serial);
+    for (int threads : {0, 3}) {
+        c.modeling_threads = threads;
+        auto threaded = input;
+        auto pipeline = cerebra::ModelingPipeline::from_config(c);
+        pipeline.set_block_frames(16);
+        pipeline.run(threaded);
+        ASSERT_TRUE(max_diff(serial, threaded) == 0.0, "threaded stages bit-identical to serial");
+    }
+}
+
+void test_stream_matches_batch() {
+    AppConfig c;
+    c.smoothing_window_size = 5;
+    c.activity_decay_rate = 0.2;
+    c.synaptic_delay_frames = 3;
+    c.refractory_period_ms = 100;
+    c.intensity_transform = "square";
+    c.enable_neurotransmitter_simulation = true;
+    c.ltp_threshold = 0.3;
+    c.ltp_increment = 0.02;
+
+    auto expected = ramp(60, 5);
+    cerebra::ModelingPipeline::from_config(c).run(expected);
+
+    cerebra::ModelingStream stream(cerebra::ModelingPipeline::from_config(c));
+    ASSERT_EQ(stream.latency_frames(), 2u, "smoothing window 5 looks two frames ahead");
+    std::vector<cerebra::BrainFrame> streamed;
+    bool bounded = true;
+    for (auto& f : ramp(60, 5)) {
+        for (auto& out : stream.push(std::move(f))) streamed.push_back(std::move(out));
+        bounded = bounded && stream.pending() <= stream.latency_frames();
+    }
+    ASSERT_TRUE(bounded, "no more than the lookahead is held back");
+    for (auto& out : stream.finish()) streamed.push_back(std::move(out));
+    ASSERT_EQ(streamed.size(), expected.size(), "every frame comes back");
+    ASSERT_TRUE(max_diff(expected, streamed) == 0.0, "stream matches batch");
+
+    stream.reset();
+    ASSERT_EQ(stream.push(ramp(1, 5)[0]).size(), 0u, "reset starts a new timeline");
+}
+
+void test_neurotransmitter_flows_use_source_intensity() {
+    cerebra::RegionAtlas atlas;
+    cerebra::RegionDefinition amygdala{"amygdala"};
+    amygdala.flows = {{"glutamate", 0.8}, {"gaba", 0.2}};
+    atlas.add_or_replace(amygdala);
+    cerebra::set_current_atlas(atlas);
+
+    std::vector<cerebra::BrainFrame> frames(1);
+    frames[0].regions.push_back(cerebra::make_region_state("amygdala", 0.25));
+    cerebra::ModelingPipeline()
+        .add(cerebra::make_transform_stage("sqrt"))
+        .add(cerebra::make_neurotransmitter_stage())
+        .run(frames);
+    // Flows were fixed at the reading (0.25), not at the transformed 0.5.
+    const double expected = 0.5 * (1.0 + 0.8 * 0.25 - 0.2 * 0.25);
+    ASSERT_TRUE(std::abs(frames[0].regions[0].intensity - expected) < 1e-12, "flows scaled by the reading");
+    cerebra::reset_current_atlas_to_builtin();
+}
+
+void test_noise_reproducible_from_seed() {
+    AppConfig c;
+    c.noise_amplitude = 0.2;
+    c.random_seed = 1234;
+    c.modeling_threads = 1;
+
+    auto reference = ramp(40, 30);
+    cerebra::ModelingPipeline::from_config(c).run(reference);
+    ASSERT_TRUE(max_diff(reference, ramp(40, 30)) > 0.0, "noise applied");
+
+    c.modeling_threads = 0;
+    auto blocked = ramp(40, 30);
+    auto pipeline = cerebra::ModelingPipeline::from_config(c);
+    pipeline.set_block_frames(3);
+    pipeline.run(blocked);
+    ASSERT_TRUE(max_diff(reference, blocked) == 0.0, "same seed, same noise across blocks and threads");
+
+    c.random_seed = 1235;
+    auto reseeded = ramp(40, 30);
+    cerebra::ModelingPipeline::from_config(c).run(reseeded);
+    ASSERT_TRUE(max_diff(reference, reseeded) > 0.0, "another seed, other noise");
+}
+
+int main() {
+    std::cout << "Tests: Modeling Pipeline\n";
+    run_test("FromConfig", test_from_config_selects_enabled_stages);
+    run_test("FusedMatchesSequential", test_fused_pass_matches_stage_by_stage);
+    run_test("SmoothingCenteredMean", test_smoothing_is_centered_mean_by_region);
+    run_test("SmoothingAcrossAtlasSwap", test_smoothing_matches_regions_across_an_atlas_swap);
+    run_test("PathwaysAcrossAtlasSwap", test_pathways_match_regions_across_an_atlas_swap);
+    run_test("ExpressionAcrossAtlasSwap", test_expression_metadata_across_an_atlas_swap);
+    run_test("ThreadedMatchesSerial", test_threaded_stages_match_serial);
+    run_test("StreamMatchesBatch", test_stream_matches_batch);
+    run_test("SeededNoise", test_noise_reproducible_from_seed);
+    run_test("FlowsAtSourceIntensity", test_neurotransmitter_flows_use_source_intensity);
+    return 0;
+}
@@ -54,7 +54,7 @@ TEST_CASE("neurotransmitter catalog: built-in by default, replaceable from JSON"
   auto base = Neurochemistry::baseline_state();
   CHECK_EQ(base.size(), static_cast<std::size_t>(3));
   CHECK_NEAR(base.at("dopamine"), 0.3, 1e-9);
-  CHECK(base.find("serotonin") == base.end());  // not in this catalog
+  CHECK_EQ(base.count("serotonin"), static_cast<std::size_t>(0));  // not in this catalog
 
   // step() still works against the custom catalog.
   std::map<std::string, double> active{{"prefrontal_cortex", 1.0}};  // built-in region -> dopamine
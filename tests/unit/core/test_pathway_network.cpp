@@ -0,0 +1,126 @@
+#include "core/pathway_network.h"
+#include "core/atlas_region.h"
+#include "core/random.h"
+#include "../test_harness.h"
+
+#include <cmath>
+
+namespace {
+
+cerebra::Pathway edge(const std::string& from, const std::string& to, double weight, std::int64_t delay_ms,
+                      cerebra::PathwayKind kind = cerebra::PathwayKind::Excitatory, bool directed = true) {
+    cerebra::Pathway p;
+    p.from = from;
+    p.to = to;
+    p.weight = weight;
+    p.delay_ms = delay_ms;
+    p.kind = kind;
+    p.directed = directed;
+    return p;
+}
+
+double& at(std::vector<double>& activity, const char* region) {
+    const cerebra::RegionId id = cerebra::region_id_for(region);
+    ASSERT_TRUE(id < activity.size(), std::string("atlas region ") + region + " (run from the repository root)");
+    return activity[id];
+}
+
+}
+
+void test_delayed_excitation_and_inhibition() {
+    cerebra::PathwayNetwork net({edge("thalamus", "occipital_lobe", 0.5, 200),
+                                 edge("amygdala", "occipital_lobe", 0.25, 90, cerebra::PathwayKind::Inhibitory)},
+                                100, 1.0);
+    ASSERT_EQ(net.edge_count(), 2u, "two edges");
+    ASSERT_EQ(net.max_delay_steps(), 2u, "200 ms at 100 ms per step");
+
+    std::vector<double> a(net.node_count(), 0.0);
+    at(a, "thalamus") = 1.0;
+    at(a, "amygdala") = 1.0;
+    at(a, "occipital_lobe") = 0.6;
+    net.step(a);
+    ASSERT_EQ(at(a, "occipital_lobe"), 0.6, "nothing has arrived yet");
+
+    std::vector<double> b(net.node_count(), 0.0);
+    at(b, "occipital_lobe") = 0.6;
+    net.step(b);
+    ASSERT_TRUE(std::abs(at(b, "occipital_lobe") - 0.35) < 1e-12, "inhibition arrives after one step");
+
+    std::vector<double> c(net.node_count(), 0.0);
+    net.step(c);
+    ASSERT_TRUE(std::abs(at(c, "occipital_lobe") - 0.5) < 1e-12, "excitation arrives after two");
+}
+
+void test_modulation_and_undirected_edges() {
+    cerebra::PathwayNetwork net({edge("hippocampus", "insula", 0.4, 0, cerebra::PathwayKind::Excitatory, false),
+                                 edge("thalamus", "insula", 0.5, 0, cerebra::PathwayKind::Modulatory)},
+                                100, 1.0);
+    ASSERT_EQ(net.edge_count(), 3u, "undirected pathway is two edges");
+    std::vector<double> a(net.node_count(), 0.0);
+    at(a, "insula") = 0.5;
+    at(a, "thalamus") = 0.8;
+    net.step(a);
+    std::vector<double> b(net.node_count(), 0.0);
+    at(b, "insula") = 0.2;
+    net.step(b);
+    ASSERT_TRUE(std::abs(at(b, "hippocampus") - 0.2) < 1e-12, "insula drives hippocampus back");
+    ASSERT_TRUE(std::abs(at(b, "insula") - 0.28) < 1e-12, "thalamus scales the insula's gain");
+}
+
+void test_matches_dense_reference() {
+    const auto& regions = cerebra::current_atlas().regions();
+    const std::size_t n = regions.size();
+    ASSERT_TRUE(n > 0, "built-in atlas loaded (run from the repository root)");
+    cerebra::CounterRng rng(7, 0);
+    std::vector<cerebra::Pathway> pathways;
+    std::uint64_t draw = 0;
+    for (int e = 0; e < 3000; ++e) {
+        auto pick = [&] { return regions[static_cast<std::size_t>(rng.uniform(draw++) * n)].id; };
+        auto kind = static_cast<cerebra::PathwayKind>(static_cast<int>(rng.uniform(draw++) * 3));
+        // Draw in a fixed order; argument evaluation order is unspecified.
+        const std::string from = pick();
+        const std::string to = pick();
+        const double weight = rng.uniform(draw++);
+        const auto delay = static_cast<std::int64_t>(rng.uniform(draw++) * 500);
+        const bool directed = rng.uniform(draw++) < 0.8;
+        pathways.push_back(edge(from, to, weight, delay, kind, directed));
+    }
+    const double coupling = 0.05;
+    cerebra::PathwayNetwork net(pathways, 50, coupling);
+
+    std::vector<std::vector<double>> history;  // x[t] for every step so far
+    double worst = 0.0;
+    for (int t = 0; t < 40; ++t) {
+        std::vector<double> input(n);
+        for (auto& v : input) v = rng.uniform(draw++);
+        std::vector<double> expected(n);
+        for (std::size_t r = 0; r < n; ++r) {
+            double drive = 0.0, gain = 0.0;
+            for (const auto& p : pathways) {
+                for (int dir = 0; dir < (p.directed || p.from == p.to ? 1 : 2); ++dir) {
+                    const auto& to = dir ? p.from : p.to;
+                    const auto& from = dir ? p.to : p.from;
+                    if (cerebra::region_id_for(to) != r) continue;
+                    int delay = std::max(1, static_cast<int>(std::llround(p.delay_ms / 50.0)));
+                    if (t - delay < 0) continue;
+                    double x = history[t - delay][cerebra::region_id_for(from)] * p.weight;
+                    if (p.kind == cerebra::PathwayKind::Modulatory) gain += x;
+                    else drive += p.kind == cerebra::PathwayKind::Inhibitory ? -x : x;
+                }
+            }
+            expected[r] = std::max(0.0, std::min(1.0, (input[r] + coupling * drive) * (1.0 + coupling * gain)));
+        }
+        net.step(input);
+        for (std::size_t r = 0; r < n; ++r) worst = std::max(worst, std::abs(input[r] - expected[r]));
+        history.push_back(expected);
+    }
+    ASSERT_TRUE(worst < 1e-12, "CSR propagation matches the dense definition");
+}
+
+int main() {
+    std::cout << "Tests: Pathway Network\n";
+    run_test("DelayedExcitationInhibition", test_delayed_excitation_and_inhibition);
+    run_test("ModulationUndirected", test_modulation_and_undirected_edges);
+    run_test("DenseReference", test_matches_dense_reference);
+    return 0;
+}
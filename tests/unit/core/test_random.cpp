@@ -0,0 +1,42 @@
+#include "core/random.h"
+#include "../test_harness.h"
+
+#include <cstring>
+#include <vector>
+
+void test_philox_known_answers() {
+    // Known-answer vectors from the Random123 distribution.
+    auto zero = cerebra::philox4x32({0, 0, 0, 0}, 0);
+    ASSERT_TRUE((zero == std::array<std::uint32_t, 4>{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}),
+                "zero counter and key");
+    auto pi = cerebra::philox4x32({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+                                  std::uint64_t{0x299f31d0} << 32 | 0xa4093822);
+    ASSERT_TRUE((pi == std::array<std::uint32_t, 4>{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}),
+                "digits of pi");
+}
+
+void test_fill_matches_single_draws() {
+    cerebra::CounterRng rng(42, 7);
+    bool same = true, in_range = true;
+    for (std::uint64_t first : {0u, 1u, 6u, 13u}) {
+        for (std::size_t n : {1u, 3u, 8u, 9u, 17u, 250u}) {
+            std::vector<double> block(n);
+            rng.fill_uniform(first, block.data(), n);
+            for (std::size_t j = 0; j < n; ++j) {
+                double one = rng.uniform(first + j);
+                same = same && std::memcmp(&one, &block[j], sizeof one) == 0;
+                in_range = in_range && block[j] >= 0.0 && block[j] < 1.0;
+            }
+        }
+    }
+    ASSERT_TRUE(same, "SIMD fill bit-identical to single draws at any offset");
+    ASSERT_TRUE(in_range, "uniform in [0, 1)");
+    ASSERT_TRUE(rng.uniform(0) != cerebra::CounterRng(42, 8).uniform(0), "streams differ");
+}
+
+int main() {
+    std::cout << "Tests: Random\n";
+    run_test("PhiloxKnownAnswers", test_philox_known_answers);
+    run_test("FillMatchesDraws", test_fill_matches_single_draws);
+    return 0;
+}
@@ -0,0 +1,216 @@
+#include "core/atlas_core.h"
+#include "core/atlas_region.h"
+#include "core/state_manager.h"
+#include "../test_harness.h"
+
+void test_atlas_assigns_dense_ids() {
+    cerebra::RegionAtlas atlas;
+    atlas.add_or_replace({"amygdala"});
+    atlas.add_or_replace({"insula"});
+    ASSERT_EQ(atlas.id_of("amygdala"), 0u, "first region id");
+    ASSERT_EQ(atlas.id_of("insula"), 1u, "second region id");
+    ASSERT_TRUE(atlas.id_of("cerebellum") == cerebra::kNoRegion, "unknown region id");
+    ASSERT_TRUE(atlas.at(1) && atlas.at(1)->id == "insula", "at() resolves id");
+    ASSERT_TRUE(atlas.at(cerebra::kNoRegion) == nullptr, "at() rejects kNoRegion");
+}
+
+void test_atlas_index_tracks_edits() {
+    cerebra::RegionAtlas atlas;
+    for (int i = 0; i < 40; ++i) atlas.add_or_replace({"r" + std::to_string(i)});
+    ASSERT_EQ(atlas.id_of("r39"), 39u, "lookup after index growth");
+    ASSERT_TRUE(atlas.remove("r3"), "remove existing");
+    ASSERT_TRUE(!atlas.remove("r3"), "remove twice");
+    ASSERT_TRUE(atlas.find("r3") == nullptr, "removed region gone");
+    ASSERT_EQ(atlas.id_of("r4"), 3u, "later ids shift down");
+
+    cerebra::RegionDefinition replaced{"r4"};
+    replaced.display_name = "Four";
+    atlas.add_or_replace(replaced);
+    ASSERT_EQ(atlas.size(), 39u, "replace keeps size");
+    ASSERT_EQ(atlas.find("r4")->display_name, "Four", "replace in place");
+
+    atlas.add_or_replace_pathway({"p1", "Path"});
+    atlas.add_or_replace_template({"calm", "Calm"});
+    cerebra::RegionAtlas copy = atlas;
+    ASSERT_TRUE(copy.find_pathway("p1") != nullptr, "pathway lookup on copy");
+    ASSERT_TRUE(copy.find_template("calm") != nullptr, "template lookup on copy");
+    ASSERT_TRUE(copy.remove_template("calm") && !copy.find_template("calm"), "template removed");
+}
+
+void test_atlas_snapshots_are_versioned() {
+    std::shared_ptr<const cerebra::AtlasSnapshot> before = cerebra::acquire_atlas_snapshot();
+    std::size_t before_size = before->atlas.size();
+    std::uint64_t before_version = cerebra::current_atlas_version();
+
+    cerebra::RegionAtlas atlas;
+    atlas.add_or_replace({"amygdala"});
+    cerebra::set_current_atlas(atlas);
+    ASSERT_TRUE(cerebra::current_atlas_version() > before_version, "publish bumps version");
+    ASSERT_EQ(cerebra::current_atlas().size(), 1u, "new snapshot visible");
+    ASSERT_EQ(before->atlas.size(), before_size, "held snapshot left intact");
+    cerebra::reset_current_atlas_to_builtin();
+    ASSERT_EQ(cerebra::current_atlas().size(), before_size, "builtin restored");
+}
+
+void test_replaced_snapshots_are_reclaimed() {
+    cerebra::RegionDefinition def;
+    def.id = "amygdala";
+    def.flows = {{"dopamine", 0.5}};
+    cerebra::RegionAtlas atlas;
+    atlas.add_or_replace(def);
+    cerebra::set_current_atlas(atlas);
+    std::weak_ptr<const cerebra::AtlasSnapshot> replaced = cerebra::acquire_atlas_snapshot();
+    cerebra::FlowView flows = cerebra::make_region_state("amygdala", 1.0).effective_flows();
+
+    cerebra::reset_current_atlas_to_builtin();
+    cerebra::current_atlas();
+    ASSERT_TRUE(!replaced.expired(), "a flow view keeps its snapshot");
+    ASSERT_EQ(flows[0].rate, 0.5, "view still reads the replaced atlas");
+    flows = cerebra::FlowView();
+    ASSERT_TRUE(replaced.expired(), "snapshot freed once unused");
+}
+
+void test_frame_index_outlives_a_publish() {
+    cerebra::RegionAtlas atlas;
+    atlas.add_or_replace({"amygdala"});
+    atlas.add_or_replace({"insula"});
+    cerebra::set_current_atlas(atlas);
+    cerebra::BrainFrame f;
+    f.regions.push_back(cerebra::make_region_state("insula", 0.6));
+    cerebra::FrameIndex index(f);
+    std::weak_ptr<const cerebra::AtlasSnapshot> indexed = cerebra::acquire_atlas_snapshot();
+
+    cerebra::reset_current_atlas_to_builtin();
+    cerebra::current_atlas();  // refreshes this thread's cached snapshot
+    ASSERT_TRUE(!indexed.expired(), "index keeps the atlas it resolved against");
+    ASSERT_EQ(index.atlas().size(), 2u, "index still walks its own atlas");
+    ASSERT_EQ(index.intensity_of(index.atlas().id_of("insula")), 0.6, "ids agree with atlas()");
+    ASSERT_EQ(index.intensity_of("insula"), 0.6, "key lookups use the same atlas");
+
+    // A frame resolved against a held snapshot ignores the newer atlas.
+    std::shared_ptr<const cerebra::AtlasSnapshot> held = indexed.lock();
+    ASSERT_TRUE(f.find(held->atlas.id_of("insula"), *held) == &f.regions[0], "frame lookup in a held atlas");
+}
+
+void test_make_region_state_binds_id() {
+    cerebra::RegionAtlas atlas;
+    atlas.add_or_replace({"amygdala"});
+    cerebra::set_current_atlas(atlas);
+    auto rs = cerebra::make_region_state("amygdala", 0.4);
+    ASSERT_EQ(rs.region_id, 0u, "bound id");
+    auto unknown = cerebra::make_region_state("custom_probe", 0.4);
+    ASSERT_TRUE(unknown.region_id == cerebra::kNoRegion, "unknown stays unbound");
+    cerebra::reset_current_atlas_to_builtin();
+}
+
+void test_flows_are_derived_lazily() {
+    cerebra::RegionAtlas atlas;
+    cerebra::RegionDefinition amygdala{"amygdala"};
+    amygdala.flows = {{"glutamate", 0.8}, {"gaba", 0.2}};
+    atlas.add_or_replace(amygdala);
+    cerebra::set_current_atlas(atlas);
+
+    auto rs = cerebra::make_region_state("amygdala", 0.5);
+    ASSERT_TRUE(rs.flows.empty(), "no flows stored at ingest");
+    auto flows = rs.effective_flows();
+    ASSERT_EQ(flows.size(), 2u, "atlas flows");
+    ASSERT_TRUE(flows[1].type == "gaba", "flow type from atlas");
+    ASSERT_EQ(flows[0].rate, 0.4, "rate scaled by intensity");
+    rs.intensity = 0.9;  // as a modeling stage would
+    ASSERT_EQ(rs.effective_flows()[0].rate, 0.4, "rate stays at the reading");
+    const auto held = cerebra::acquire_atlas_snapshot();
+    ASSERT_EQ(rs.effective_flows(*held)[1].rate, flows[1].rate, "same flows against a held snapshot");
+
+    auto probe = cerebra::make_region_state("custom_probe", 0.5);
+    ASSERT_EQ(probe.effective_flows().size(), 1u, "fallback flow");
+    probe.flows = {{"dopamine", 0.3}};
+    ASSERT_TRUE(probe.effective_flows()[0].type == "dopamine", "stored flows win");
+
+    cerebra::RegionState bare{"amygdala", 0.5};
+    ASSERT_TRUE(bare.effective_flows().empty(), "no defaults unless the source asks");
+    cerebra::reset_current_atlas_to_builtin();
+}
+
+void test_frame_index_lookups() {
+    cerebra::RegionAtlas atlas;
+    atlas.add_or_replace({"amygdala"});
+    atlas.add_or_replace({"insula"});
+    atlas.add_or_replace({"thalamus"});
+    cerebra::set_current_atlas(atlas);
+
+    cerebra::BrainFrame f;
+    f.regions.push_back(cerebra::make_region_state("thalamus", 0.3));
+    f.regions.push_back(cerebra::make_region_state("custom_probe", 0.9));
+    cerebra::RegionState loose;  // never bound to the atlas
+    loose.region = "amygdala";
+    loose.intensity = 0.7;
+    f.regions.push_back(loose);
+
+    cerebra::FrameIndex index(f);
+    ASSERT_EQ(index.intensity_of(2u), 0.3, "bound region by id");
+    ASSERT_EQ(index.intensity_of(0u), 0.7, "unbound atlas region by id");
+    ASSERT_EQ(index.intensity_of(1u), 0.0, "absent region");
+    ASSERT_EQ(index.intensity_of("custom_probe"), 0.9, "non-atlas region by key");
+    ASSERT_EQ(index.intensity_of("insula"), 0.0, "absent region by key");
+
+    ASSERT_EQ(f.intensity_of(cerebra::RegionId(2)), 0.3, "frame lookup by id");
+    ASSERT_EQ(f.intensity_of(cerebra::RegionId(0)), 0.7, "frame lookup falls back to key");
+    ASSERT_EQ(f.intensity_of(std::string("thalamus")), 0.3, "frame lookup by atlas key");
+    ASSERT_EQ(f.intensity_of(std::string("custom_probe")), 0.9, "frame lookup by non-atlas key");
+
+    cerebra::BrainFrame g;
+    g.regions.push_back(cerebra::make_region_state("amygdala", 0.2));
+    { cerebra::FrameIndex scratch(f); }  // hands its slot table back
+    cerebra::FrameIndex reused(g);        // and this one picks it up
+    ASSERT_EQ(reused.intensity_of(0u), 0.2, "second index on the thread");
+    ASSERT_EQ(reused.intensity_of(2u), 0.0, "recycled slots start empty");
+    cerebra::reset_current_atlas_to_builtin();
+}
+
+void test_stale_ids_do_not_alias() {
+    cerebra::RegionAtlas first;
+    first.add_or_replace({"amygdala"});
+    first.add_or_replace({"insula"});
+    cerebra::set_current_atlas(first);
+    cerebra::BrainFrame f;
+    f.regions.push_back(cerebra::make_region_state("amygdala", 0.2));  // id 0
+    f.regions.push_back(cerebra::make_region_state("insula", 0.8));    // id 1
+
+    cerebra::RegionAtlas swapped;
+    swapped.add_or_replace({"insula"});
+    swapped.add_or_replace({"amygdala"});
+    cerebra::set_current_atlas(swapped);
+    ASSERT_EQ(f.intensity_of(cerebra::RegionId(0)), 0.8, "id 0 is insula now");
+    ASSERT_EQ(f.intensity_of(cerebra::RegionId(1)), 0.2, "id 1 is amygdala now");
+    cerebra::FrameIndex index(f);
+    ASSERT_EQ(index.intensity_of(0u), 0.8, "index agrees after the swap");
+    cerebra::reset_current_atlas_to_builtin();
+}
+
+void test_region_detail_is_out_of_line() {
+    cerebra::RegionState rs{"amygdala", 0.5};
+    ASSERT_TRUE(!rs.has_detail(), "no detail by default");
+    ASSERT_TRUE(rs.detail().metrics.empty(), "reading detail does not allocate");
+    ASSERT_TRUE(!rs.has_detail(), "still no detail after a read");
+
+    rs.mutable_detail().metrics["bold"] = 0.8;
+    cerebra::RegionState copy = rs;
+    copy.mutable_detail().metrics["bold"] = 0.1;
+    ASSERT_EQ(rs.detail().metrics.at("bold"), 0.8, "copies own their detail");
+    ASSERT_EQ(copy.detail().metrics.at("bold"), 0.1, "copy keeps its own write");
+}
+
+int main() {
+    std::cout << "Tests: Region IDs\n";
+    run_test("AtlasIds", test_atlas_assigns_dense_ids);
+    run_test("AtlasIndex", test_atlas_index_tracks_edits);
+    run_test("AtlasSnapshots", test_atlas_snapshots_are_versioned);
+    run_test("SnapshotReclaim", test_replaced_snapshots_are_reclaimed);
+    run_test("IndexOutlivesPublish", test_frame_index_outlives_a_publish);
+    run_test("MakeRegionState", test_make_region_state_binds_id);
+    run_test("LazyFlows", test_flows_are_derived_lazily);
+    run_test("FrameIndex", test_frame_index_lookups);
+    run_test("StaleIds", test_stale_ids_do_not_alias);
+    run_test("RegionDetail", test_region_detail_is_out_of_line);
+    return 0;
+}
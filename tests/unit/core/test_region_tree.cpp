@@ -0,0 +1,56 @@
+#include "core/region_tree.h"
+#include "../test_harness.h"
+
+#include <cmath>
+
+namespace {
+
+// cortex
+//   frontal
+//     pfc
+//     motor
+//   parietal
+// thalamus
+cerebra::RegionTree sample_tree() {
+    cerebra::RegionTree t;
+    std::size_t cortex = t.add(cerebra::RegionTree::npos, "cortex", 0.0);
+    std::size_t frontal = t.add(cortex, "frontal", 0.0);
+    t.add(frontal, "pfc", 0.8);
+    t.add(cortex, "parietal", 0.2);
+    t.add(cerebra::RegionTree::npos, "thalamus", 0.5);
+    t.add(frontal, "motor", 0.4);  // lands before "parietal"
+    return t;
+}
+
+}
+
+void test_tree_is_preorder() {
+    auto t = sample_tree();
+    ASSERT_EQ(t.size(), 6u, "node count");
+    ASSERT_EQ(t.region(3), "motor", "late child inserted inside its parent's subtree");
+    ASSERT_EQ(t.region(4), "parietal", "sibling shifted");
+    ASSERT_EQ(t.parent(4), 0u, "shifted node keeps its parent");
+    ASSERT_EQ(t.parent(5), cerebra::RegionTree::npos, "root has no parent");
+    ASSERT_EQ(t.subtree_size(0), 5u, "cortex subtree");
+    ASSERT_EQ(t.depth(3), 2u, "grandchild depth");
+}
+
+void test_tree_roll_ups() {
+    auto t = sample_tree();
+    auto sums = t.subtree_sums();
+    ASSERT_TRUE(std::abs(sums[0] - 1.4) < 1e-9, "cortex subtree sum");
+    ASSERT_EQ(t.subtree_max()[1], 0.8, "frontal subtree max");
+
+    t.roll_up_child_means();
+    ASSERT_TRUE(std::abs(t.intensity(1) - 0.6) < 1e-9, "frontal = mean(pfc, motor)");
+    ASSERT_TRUE(std::abs(t.intensity(0) - 0.4) < 1e-9, "cortex = mean(frontal, parietal)");
+    ASSERT_TRUE(std::abs(t.root_mean(0.0) - 0.45) < 1e-9, "mean of roots");
+    ASSERT_EQ(cerebra::RegionTree().root_mean(0.3), 0.3, "empty tree fallback");
+}
+
+int main() {
+    std::cout << "Tests: Region Tree\n";
+    run_test("PreOrder", test_tree_is_preorder);
+    run_test("RollUps", test_tree_roll_ups);
+    return 0;
+}
@@ -39,9 +39,9 @@ std::string line_starting_with(const std::string& report, const std::string& pre
 //   thalamus : 0.4, 0.4, 0.4   -> peak 0.40, mean 0.40, last 0.40
 Simulation hand_timeline() {
   std::vector<BrainActivitySample> s(3);
-  s[0].timestamp_ms = 0;   s[0].intensities = {{"amygdala", 0.2}, {"thalamus", 0.4}};
-  s[1].timestamp_ms = 100; s[1].intensities = {{"amygdala", 0.8}, {"thalamus", 0.4}};
-  s[2].timestamp_ms = 200; s[2].intensities = {{"amygdala", 0.5}, {"thalamus", 0.4}};
+  s[0].timestamp_ms = 0;   s[0].assign({{"amygdala", 0.2}, {"thalamus", 0.4}});
+  s[1].timestamp_ms = 100; s[1].assign({{"amygdala", 0.8}, {"thalamus", 0.4}});
+  s[2].timestamp_ms = 200; s[2].assign({{"amygdala", 0.5}, {"thalamus", 0.4}});
   Simulation sim(ActivityTimeline(std::move(s)));
   sim.jump_to_end();
   return sim;
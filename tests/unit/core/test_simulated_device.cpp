@@ -45,7 +45,7 @@ TEST_CASE("simulated device transmits decodable JSON activity frames") {
   CHECK_EQ(link.stream->frames_decoded(), static_cast<std::size_t>(5));
   CHECK_EQ(link.stream->parse_errors(), static_cast<std::size_t>(0));
   // Frames carry region intensities and monotonically increasing timestamps.
-  for (const auto& f : frames) CHECK(!f.intensities.empty());
+  for (const auto& f : frames) CHECK(!f.empty());
   CHECK_EQ(frames.front().timestamp_ms, static_cast<std::int64_t>(0));
   CHECK_EQ(frames.back().timestamp_ms, static_cast<std::int64_t>(400));  // 4 * 100ms
   // "focused" should keep the amygdala fairly quiet.
@@ -11,7 +11,7 @@ ActivityTimeline make_ramp(int n) {
   for (int i = 0; i < n; ++i) {
     BrainActivitySample b;
     b.timestamp_ms = i * 100;
-    b.intensities["amygdala"] = static_cast<double>(i) / std::max(1, n - 1);
+    b.set("amygdala", static_cast<double>(i) / std::max(1, n - 1));
     s.push_back(b);
   }
   return ActivityTimeline(std::move(s));
@@ -195,7 +195,7 @@ TEST_CASE("an empty simulation has a zeroed current sample and baseline chemistr
   CHECK(sim.empty());
   CHECK_EQ(sim.frame_count(), static_cast<std::size_t>(0));
   CHECK_EQ(sim.current_sample().timestamp_ms, static_cast<std::int64_t>(0));
-  CHECK(sim.current_sample().intensities.empty());
+  CHECK(sim.current_sample().to_frame().regions.empty());
   // Baseline chemistry: norepinephrine sits at its resting level.
   CHECK_NEAR(sim.chemical_state().at("norepinephrine"), 0.20, 1e-9);
   // Navigation on an empty timeline is harmless.
@@ -220,10 +220,10 @@ TEST_CASE("brain-state lookup resolves aliases and casing") {
   CHECK_EQ(tl.size(), static_cast<std::size_t>(1));
   auto rem = BrainStateLibrary::synthesize_timeline(*BrainStateLibrary::find("rem_sleep"), 30, 10);
   for (const auto& s : rem.samples()) {
-    for (const auto& kv : s.intensities) {
-      CHECK(kv.second >= 0.0);
-      CHECK(kv.second <= 1.0);
-    }
+    s.for_each([](std::string_view, double v) {
+      CHECK(v >= 0.0);
+      CHECK(v <= 1.0);
+    });
   }
 }
 
@@ -171,7 +171,7 @@ BM_CASE(template_frame_uses_custom_atlas_template) {
     bool found_dopamine = false;
     for (const auto& r : f.regions) {
         if (r.region == "prefrontal_cortex") {
-            for (const auto& nf : r.flows) if (nf.type == "dopamine") found_dopamine = true;
+            for (const auto nf : r.effective_flows()) if (nf.type == "dopamine") found_dopamine = true;
         }
     }
     BM_REQUIRE(found_dopamine);
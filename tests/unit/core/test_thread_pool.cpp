@@ -0,0 +1,52 @@
+#include "core/thread_pool.h"
+#include "../test_harness.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+void test_parallel_for_covers_range_once() {
+    cerebra::ThreadPool pool(3);
+    std::vector<int> hits(1000, 0);
+    pool.parallel_for(hits.size(), 10, 8, [&](std::size_t b, std::size_t e) {
+        for (std::size_t i = b; i < e; ++i) ++hits[i];
+    });
+    bool once = true;
+    for (int h : hits) once = once && h == 1;
+    ASSERT_TRUE(once, "every index visited exactly once");
+
+    std::atomic<int> calls{0};
+    pool.parallel_for(5, 10, 8, [&](std::size_t b, std::size_t e) {
+        ASSERT_TRUE(b == 0 && e == 5, "below one grain runs as a single call");
+        ++calls;
+    });
+    ASSERT_EQ(calls.load(), 1, "single call");
+}
+
+void test_nested_batches_and_errors() {
+    cerebra::ThreadPool pool(2);
+    std::atomic<int> total{0};
+    pool.parallel_for(4, 1, 4, [&](std::size_t b, std::size_t e) {
+        for (std::size_t i = b; i < e; ++i) {
+            pool.parallel_for(100, 1, 4, [&](std::size_t ib, std::size_t ie) { total += static_cast<int>(ie - ib); });
+        }
+    });
+    ASSERT_EQ(total.load(), 400, "nested batches complete");
+
+    bool threw = false;
+    try {
+        pool.parallel_for(64, 1, 4, [](std::size_t b, std::size_t) {
+            if (b > 0) throw std::runtime_error("boom");
+        });
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    ASSERT_TRUE(threw, "task exception reaches the caller");
+}
+
+int main() {
+    std::cout << "Tests: Thread Pool\n";
+    run_test("CoversRangeOnce", test_parallel_for_covers_range_once);
+    run_test("NestedAndErrors", test_nested_batches_and_errors);
+    return 0;
+}
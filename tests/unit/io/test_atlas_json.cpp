@@ -22,7 +22,7 @@ BM_CASE(parses_example_array) {
     BM_REQUIRE_EQ(frames[0].regions.size(), std::size_t(3));
     BM_REQUIRE_EQ(frames[0].regions[0].region, std::string("prefrontal_cortex"));
     BM_REQUIRE_NEAR(frames[0].regions[0].intensity, 0.8, 1e-9);
-    BM_REQUIRE(!frames[0].regions[0].flows.empty());
+    BM_REQUIRE(!frames[0].regions[0].effective_flows().empty());
 }
 
 BM_CASE(parses_single_frame_object) {
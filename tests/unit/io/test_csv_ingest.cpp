@@ -0,0 +1,90 @@
+#include "io/csv_parser.h"
+#include "core/thread_pool.h"
+#include "../test_harness.h"
+
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+void test_header_mapping() {
+    auto frames = cerebra::parse_csv_frames(
+        "Region, SNR, Timestamp_ms, latency, Intensity\n"
+        "amygdala, 3.5, 100, , 0.25\n"
+        "\n"
+        "thalamus, x, 100, 12, 0.5\r\n"
+        "short, row\n"
+        "amygdala, 1, 0, 4, 0.75\n");
+    ASSERT_EQ(frames.size(), 2u, "two timestamps");
+    ASSERT_EQ(frames[0].timestamp_ms, 100, "first seen first");
+    ASSERT_EQ(frames[0].regions.size(), 2u, "two rows at 100");
+    const auto& a = frames[0].regions[0];
+    ASSERT_TRUE(a.region == "amygdala" && a.intensity == 0.25, "mapped columns");
+    ASSERT_EQ(a.detail().metrics.at("SNR"), 3.5, "metric column");
+    ASSERT_EQ(a.detail().metrics.count("latency"), 0u, "blank metric skipped");
+    ASSERT_EQ(frames[0].regions[1].detail().metrics.count("SNR"), 0u, "non-numeric metric skipped");
+    ASSERT_EQ(frames[0].regions[1].detail().metrics.at("latency"), 12.0, "second metric");
+    ASSERT_EQ(frames[1].regions[0].intensity, 0.75, "later frame");
+}
+
+void test_headerless_and_errors() {
+    auto frames = cerebra::parse_csv_frames("0,amygdala,0.1,ignored\n0,thalamus,0.2\n50,amygdala,0.3");
+    ASSERT_EQ(frames.size(), 2u, "frames");
+    ASSERT_TRUE(frames[0].regions[0].detail().metrics.empty(), "extra column ignored without a header");
+    ASSERT_EQ(frames[1].regions[0].intensity, 0.3, "last line without newline");
+
+    std::string error;
+    try {
+        cerebra::parse_csv_frames("region,intensity\namygdala,0.1\n");
+    } catch (const std::invalid_argument& e) {
+        error = e.what();
+    }
+    ASSERT_EQ(error, std::string("CSV header needs timestamp, region and intensity columns"),
+              "header without a timestamp column");
+    ASSERT_TRUE(cerebra::parse_csv_frames("").empty(), "empty input");
+}
+
+void test_chunks_match_sequential_read() {
+    // Timestamps revisit earlier frames so that merging has to join them.
+    std::ostringstream os;
+    os << "timestamp_ms,region,intensity,snr\n";
+    std::vector<std::pair<std::int64_t, std::string>> rows;
+    for (int i = 0; i < 250000; ++i) {
+        const std::int64_t ts = (i / 40) * 10 + (i % 13 == 0 ? -((i * 7919) % 997) * 10 : 0);
+        const std::string region = "region_" + std::to_string(i % 40);
+        os << ts << "," << region << "," << 0.001 * (i % 1000) << "," << i << "\n";
+        rows.emplace_back(ts, region);
+    }
+    const std::string csv = os.str();
+    ASSERT_TRUE(csv.size() > 4 * (1u << 20), "several chunks");
+
+    std::vector<std::int64_t> order;
+    std::map<std::int64_t, std::vector<std::string>> expected;
+    for (const auto& [ts, region] : rows) {
+        if (!expected.count(ts)) order.push_back(ts);
+        expected[ts].push_back(region);
+    }
+
+    cerebra::ThreadPool pool(3);
+    const auto frames = cerebra::parse_csv_frames(csv, pool);
+    ASSERT_EQ(frames.size(), order.size(), "frame count");
+    bool same = true;
+    std::size_t total = 0;
+    for (std::size_t k = 0; k < frames.size() && same; ++k) {
+        same = frames[k].timestamp_ms == order[k] && frames[k].regions.size() == expected[order[k]].size();
+        for (std::size_t r = 0; same && r < frames[k].regions.size(); ++r) {
+            same = frames[k].regions[r].region == expected[order[k]][r];
+        }
+        total += frames[k].regions.size();
+    }
+    ASSERT_TRUE(same, "frames and rows in sequential order");
+    ASSERT_EQ(total, rows.size(), "every row");
+    ASSERT_EQ(frames[0].regions[1].detail().metrics.at("snr"), 1.0, "metric carried");
+}
+
+int main() {
+    std::cout << "Tests: CSV Ingest\n";
+    run_test("HeaderMapping", test_header_mapping);
+    run_test("HeaderlessAndErrors", test_headerless_and_errors);
+    run_test("ChunksMatchSequentialRead", test_chunks_match_sequential_read);
+    return 0;
+}
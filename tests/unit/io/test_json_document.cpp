@@ -0,0 +1,83 @@
+#include "io/json_document.h"
+#include "core/neurochemistry.h"
+#include "../test_harness.h"
+
+#include <sstream>
+
+namespace {
+
+std::size_t error_offset(std::string_view json) {
+    try {
+        cerebra::JsonDocument::parse(json);
+    } catch (const cerebra::JsonParseError& e) {
+        return e.position();
+    }
+    return std::string::npos;
+}
+
+}
+
+void test_accessors() {
+    auto doc = cerebra::JsonDocument::parse(R"({"n": -2.5, "t": true, "s": "a\tbé", "a": [1, "x", null], "o": {}})");
+    const auto& root = doc.root();
+    ASSERT_TRUE(root.is_object() && root.as_object().size() == 5, "root object");
+    ASSERT_EQ(root["n"].as_number(), -2.5, "number");
+    ASSERT_EQ(root["n"].as_int(), -2, "int");
+    ASSERT_TRUE(root["t"].as_bool() && !root["s"].as_bool(), "bool and fallback");
+    ASSERT_TRUE(root["s"].as_string() == "a\tb\xC3\xA9", "unescaped string");
+    ASSERT_EQ(root["a"].as_array().size(), 3u, "array");
+    ASSERT_TRUE(root["a"][1].as_string() == "x" && root["a"][2].is_null() && root["a"][9].is_null(), "indexing");
+    ASSERT_TRUE(root["o"].is_object() && root["o"].as_object().empty(), "empty object");
+    ASSERT_TRUE(root["missing"]["deeper"].is_null() && !root.contains("missing"), "absent keys");
+}
+
+void test_objects_match_json_value() {
+    // Sorted like std::map, and the first of a repeated key wins.
+    const char* text = R"({"b": 1, "a": {"z": [true, "q"], "y": null}, "b": 2, "c": "s"})";
+    auto doc = cerebra::JsonDocument::parse(text);
+    ASSERT_EQ(doc.root()["b"].as_number(), 1.0, "first key wins");
+    ASSERT_EQ(doc.root().dump(), cerebra::JsonValue::parse(text).dump(), "same dump as JsonValue");
+
+    std::ostringstream os;
+    os << "{";
+    for (int k = 99; k >= 0; --k) os << (k == 99 ? "" : ",") << "\"key" << k << "\": " << k;
+    os << "}";
+    auto big = cerebra::JsonDocument::parse(os.str());
+    ASSERT_EQ(big.root().as_object().size(), 100u, "members");
+    bool found = true;
+    for (int k = 0; k < 100; ++k) found = found && big.root()["key" + std::to_string(k)].as_int(-1) == k;
+    ASSERT_TRUE(found && !big.root().contains("key100"), "bisected lookup");
+}
+
+void test_document_owns_its_text() {
+    std::string text = R"({"plain": "view", "escaped": "a\"b"})";
+    auto doc = cerebra::JsonDocument::parse(text);
+    text.assign(text.size(), '#');
+    ASSERT_TRUE(doc.root()["plain"].as_string() == "view", "plain string survives the source");
+    ASSERT_TRUE(doc.root()["escaped"].as_string() == "a\"b", "escaped string survives the source");
+    auto moved = std::move(doc);
+    ASSERT_TRUE(moved.root()["plain"].as_string() == "view", "views survive a move");
+    ASSERT_TRUE(moved.arena_bytes() > 0 && cerebra::JsonDocument().root().is_null(), "arena");
+}
+
+void test_errors_and_loaders() {
+    ASSERT_EQ(error_offset("{\"a\" 1}"), 5u, "missing colon");
+    ASSERT_EQ(error_offset("[1,]"), 3u, "trailing comma");
+
+    auto doc = cerebra::JsonDocument::parse(R"([{"key": "Serotonin 5HT", "baseline": 0.4, "metadata": {"class": "monoamine", "rank": 2}}])");
+    cerebra::Neurochemistry::load_from_json(doc.root());
+    const auto* info = cerebra::Neurochemistry::find("serotonin_5ht");
+    ASSERT_TRUE(info != nullptr, "slugified key");
+    ASSERT_EQ(info->baseline, 0.4, "baseline");
+    ASSERT_TRUE(info->extra.at("class") == "monoamine" && info->extra.at("rank") == "2", "metadata");
+    cerebra::Neurochemistry::reset_to_defaults();
+}
+
+int main() {
+    std::cout << "Tests: JSON Document\n";
+    run_test("Accessors", test_accessors);
+    run_test("ObjectsMatchJsonValue", test_objects_match_json_value);
+    run_test("DocumentOwnsItsText", test_document_owns_its_text);
+    run_test("ErrorsAndLoaders", test_errors_and_loaders);
+    return 0;
+}
@@ -0,0 +1,131 @@
+#include "io/json_events.h"
+#include "core/state_manager.h"
+#include "../test_harness.h"
+
+#include <sstream>
+
+namespace {
+
+// Records events as a compact trace.
+struct Trace : cerebra::JsonEventHandler {
+    std::string out;
+    void on_null() override { out += "n "; }
+    void on_bool(bool b) override { out += b ? "T " : "F "; }
+    void on_number(double v) override {
+        std::ostringstream os;
+        os << v;
+        out += os.str() + " ";
+    }
+    void on_string(std::string_view s) override { out += "'" + std::string(s) + "' "; }
+    void on_key(std::string_view s) override { out += std::string(s) + ": "; }
+    void on_start_object() override { out += "{ "; }
+    void on_end_object() override { out += "} "; }
+    void on_start_array() override { out += "[ "; }
+    void on_end_array() override { out += "] "; }
+};
+
+std::size_t error_offset(std::string_view json) {
+    Trace t;
+    try {
+        cerebra::parse_json_events(json, t);
+    } catch (const cerebra::JsonParseError& e) {
+        return e.position();
+    }
+    return std::string::npos;
+}
+
+// A document large enough that tokens straddle the stream reader's chunks.
+std::string big_document(int frames) {
+    std::ostringstream os;
+    os << "[";
+    for (int i = 0; i < frames; ++i) {
+        os << (i ? ",\n" : "") << "{\"timestamp_ms\": " << i * 100 << ", \"brain_activity\": [";
+        for (int r = 0; r < 12; ++r) {
+            os << (r ? ", " : "") << "{\"region\": \"region_\\u00e9_" << r << "\", \"intensity\": "
+               << 0.001 * ((i * 37 + r * 11) % 1000) << ", \"metrics\": {\"snr\": " << 1.5e-3 * r << "}}";
+        }
+        os << "]}";
+    }
+    os << "]";
+    return os.str();
+}
+
+}
+
+void test_event_sequence() {
+    Trace t;
+    cerebra::parse_json_events(R"( {"a": [1, -2.5e1, true, false, null], "b\"\u00e9\ud83d\ude00": {}, "c": []} )", t);
+    ASSERT_EQ(t.out, std::string("{ a: [ 1 -25 T F n ] b\"\xC3\xA9\xF0\x9F\x98\x80: { } c: [ ] } "), "event order");
+}
+
+void test_error_offsets() {
+    ASSERT_EQ(error_offset("[1, 2"), 5u, "unterminated array");
+    ASSERT_EQ(error_offset("{\"a\" 1}"), 5u, "missing colon");
+    ASSERT_EQ(error_offset("[1,]"), 3u, "trailing comma");
+    ASSERT_EQ(error_offset("[tru]"), 1u, "bad literal");
+    ASSERT_EQ(error_offset("{\"a\": 1} x"), 9u, "extra data");
+    ASSERT_EQ(error_offset("[1.2.3]"), 1u, "malformed number");
+    ASSERT_EQ(error_offset("\"abc"), 4u, "unterminated string");
+    ASSERT_EQ(error_offset("[\"\\u12G4\"]"), 6u, "bad unicode escape");
+    ASSERT_EQ(error_offset("[1, 2]"), std::string::npos, "valid document");
+}
+
+void test_frames_follow_dom_rules() {
+    const char* doc = R"([
+      {"timestamp_ms": 250, "timestamp_ms": 999, "extra": {"brain_activity": []},
+       "brain_activity": [
+         {"region": "amygdala", "intensity": 0.5, "metrics": {"snr": 2, "snr": 3, "label": "x"}},
+         {"intensity": 0.9},
+         {"region": 7, "intensity": "high"}
+       ]},
+      3
+    ])";
+    std::vector<cerebra::JsonFrameRecord> frames;
+    auto layout = cerebra::read_json_frames(doc, [&](const cerebra::JsonFrameRecord& f) { frames.push_back(f); });
+    ASSERT_TRUE(layout == cerebra::JsonFrameLayout::Array, "array layout");
+    ASSERT_EQ(frames.size(), 2u, "two frames");
+    ASSERT_EQ(frames[0].timestamp_ms, 250.0, "first timestamp wins");
+    ASSERT_TRUE(frames[0].has_activity && frames[0].entries_are_objects, "activity array");
+    ASSERT_EQ(frames[0].entries.size(), 3u, "three entries");
+    ASSERT_EQ(frames[0].entries[0].metrics.size(), 1u, "one numeric metric");
+    ASSERT_EQ(frames[0].entries[0].metrics[0].second, 2.0, "first metric wins");
+    ASSERT_TRUE(frames[0].entries[1].region.empty(), "missing region");
+    ASSERT_TRUE(frames[0].entries[2].region.empty() && frames[0].entries[2].intensity == 0.0, "wrong types");
+    ASSERT_TRUE(!frames[1].is_object, "scalar frame");
+
+    auto parsed = cerebra::parse_json_frames(doc);
+    ASSERT_EQ(parsed.size(), 2u, "frames");
+    ASSERT_EQ(parsed[0].regions.size(), 1u, "only named regions");
+    ASSERT_EQ(parsed[0].timestamp_ms, 250, "timestamp");
+    ASSERT_EQ(parsed[0].regions[0].detail().metrics.at("snr"), 2.0, "metric");
+}
+
+void test_stream_matches_buffer() {
+    const std::string doc = big_document(600);
+    ASSERT_TRUE(doc.size() > 4 * 65536, "spans several chunks");
+    Trace from_buffer, from_stream;
+    cerebra::parse_json_events(doc, from_buffer);
+    std::istringstream in(doc);
+    cerebra::parse_json_events(in, from_stream);
+    ASSERT_TRUE(from_buffer.out == from_stream.out, "same events from a stream");
+
+    std::string broken = doc;
+    broken[200000] = '#';
+    std::istringstream bad(broken);
+    std::size_t pos = 0;
+    try {
+        cerebra::parse_json_events(bad, from_stream);
+    } catch (const cerebra::JsonParseError& e) {
+        pos = e.position();
+    }
+    ASSERT_EQ(pos, error_offset(broken), "same error offset from a stream");
+}
+
+int main() {
+    std::cout << "Tests: JSON Events\n";
+    run_test("EventSequence", test_event_sequence);
+    run_test("ErrorOffsets", test_error_offsets);
+    run_test("FramesFollowDomRules", test_frames_follow_dom_rules);
+    run_test("StreamMatchesBuffer", test_stream_matches_buffer);
+    return 0;
+}
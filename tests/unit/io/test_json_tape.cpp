@@ -0,0 +1,118 @@
+#include "io/json_tape.h"
+#include "../test_harness.h"
+
+#include <sstream>
+
+namespace {
+
+std::size_t error_offset(std::string_view json) {
+    try {
+        cerebra::JsonValue::parse(json);
+    } catch (const cerebra::JsonParseError& e) {
+        return e.position();
+    }
+    return std::string::npos;
+}
+
+// Escapes, runs of backslashes and \u sequences at every alignment, so some
+// of them straddle the 64-byte blocks of the structural scan.
+std::string tricky_document(int items) {
+    std::ostringstream os;
+    os << "{\"items\": [";
+    for (int i = 0; i < items; ++i) {
+        os << (i ? "," : "") << std::string(i % 7, ' ')
+           << "{\"k" << i << "\": \"" << std::string(i % 64, 'x') << std::string(i % 5, '\\')
+           << (i % 5 % 2 ? "\\" : "") << "\\\"q\\u00e9{[,:]}\", \"n\":" << -0.25 * i << ", \"t\": true, \"z\": null}";
+    }
+    os << "], \"end\": false}";
+    return os.str();
+}
+
+}
+
+void test_simd_index_matches_scalar() {
+    const std::string doc = tricky_document(400);
+    ASSERT_TRUE(cerebra::json_structural_index(doc) == cerebra::json_structural_index_scalar(doc),
+                std::string("same index with ") + cerebra::json_scan_isa());
+    for (std::size_t cut = 60; cut < 200; ++cut) {
+        const std::string part = "[\"" + std::string(cut, 'a') + "\\\\\", \"\\\"\", 1]";
+        ASSERT_TRUE(cerebra::json_structural_index(part) == cerebra::json_structural_index_scalar(part),
+                    "backslash at a block boundary");
+    }
+}
+
+void test_index_spans_runs() {
+    ASSERT_TRUE(cerebra::json_structural_index(R"([true, -12, "a:b"])") ==
+                    std::vector<std::uint32_t>({0, 5, 10, 12, 16, 17}),
+                "structurals and quotes only, not scalars or string contents");
+
+    // Enough commas to cross many of stage 1's runs.
+    std::string doc = "[";
+    for (int i = 0; i < 600000; ++i) doc += "1,";
+    doc += "1]";
+    const auto index = cerebra::json_structural_index(doc);
+    ASSERT_EQ(index.size(), 600002u, "brackets and commas");
+    bool in_order = index.back() == doc.size() - 1;
+    for (std::size_t k = 0; k + 1 < index.size(); ++k) in_order = in_order && index[k] == 2 * k;
+    ASSERT_TRUE(in_order, "offsets survive the run boundaries");
+    const auto tape = cerebra::JsonTape::parse(doc);
+    ASSERT_EQ(tape.entries().size(), 600003u, "tape walks every run");
+    ASSERT_EQ(tape.numbers().size(), 600001u, "one number each");
+}
+
+void test_tape_structure() {
+    auto tape = cerebra::JsonTape::parse(R"({"a": [1, "x\ny", true], "b": {}})");
+    using T = cerebra::JsonTape::Type;
+    const auto& e = tape.entries();
+    ASSERT_EQ(e.size(), 11u, "one entry per value, key and end");
+    ASSERT_EQ(sizeof(e[0]), 8u, "compact entries");
+    ASSERT_TRUE(e[0].type() == T::StartObject && e[0].count() == 2 && e[0].offset() == 11, "root object");
+    ASSERT_TRUE(e[2].type() == T::StartArray && e[2].count() == 3 && e[2].offset() == 7, "array skips to its end");
+    ASSERT_TRUE(e[3].type() == T::Number && tape.number(e[3]) == 1.0, "number");
+    ASSERT_TRUE(e[4].unescaped() && tape.string(e[4]) == "x\ny", "escaped string is decoded");
+    ASSERT_TRUE(!e[1].unescaped() && tape.string(e[1]) == "a", "plain string refers to the source");
+    ASSERT_TRUE(e[5].type() == T::True && e[6].type() == T::EndArray, "literal and end");
+    ASSERT_TRUE(e[9].type() == T::EndObject && e[10].type() == T::EndObject, "ends");
+
+    auto spaced = cerebra::JsonTape::parse(" {\n  \"k\" :\t[ null ,\r\n -2.5e1 ] }\n");
+    ASSERT_EQ(spaced.entries().size(), 7u, "whitespace around every token");
+    ASSERT_TRUE(spaced.entries()[3].type() == T::Null && spaced.number(spaced.entries()[4]) == -25.0,
+                "scalars read in place");
+}
+
+void test_dom_from_tape() {
+    const std::string doc = tricky_document(50);
+    auto v = cerebra::JsonValue::parse(doc);
+    ASSERT_EQ(v["items"].as_array().size(), 50u, "items");
+    ASSERT_EQ(v["items"][4]["n"].as_number(), -1.0, "number");
+    ASSERT_TRUE(v["items"][0]["k0"].as_string() == "\"q\xC3\xA9{[,:]}", "decoded string");
+    ASSERT_TRUE(v["items"][0]["t"].as_bool() && v["items"][0]["z"].is_null(), "literals");
+    ASSERT_TRUE(!v["end"].as_bool(true), "last member");
+}
+
+void test_error_offsets() {
+    ASSERT_EQ(error_offset("[1, 2"), 5u, "unterminated array");
+    ASSERT_EQ(error_offset("{\"a\" 1}"), 5u, "missing colon");
+    ASSERT_EQ(error_offset("[1,]"), 3u, "trailing comma");
+    ASSERT_EQ(error_offset("[tru]"), 1u, "bad literal");
+    ASSERT_EQ(error_offset("{\"a\": 1} x"), 9u, "extra data");
+    ASSERT_EQ(error_offset("[1.2.3]"), 1u, "malformed number");
+    ASSERT_EQ(error_offset("[truex]"), 1u, "literal runs on");
+    ASSERT_EQ(error_offset("[1 2]"), 3u, "scalars without a comma");
+    ASSERT_EQ(error_offset("[\"a\" 1]"), 5u, "string then scalar");
+    ASSERT_EQ(error_offset("{\"a\": 1 \"b\": 2}"), 8u, "members without a comma");
+    ASSERT_EQ(error_offset("{x\"a\": 1}"), 1u, "stray byte before a key");
+    ASSERT_EQ(error_offset("\"abc"), 4u, "unterminated string");
+    ASSERT_EQ(error_offset("[\"\\u12G4\"]"), 6u, "bad unicode escape");
+    ASSERT_EQ(error_offset("[1, 2]"), std::string::npos, "valid document");
+}
+
+int main() {
+    std::cout << "Tests: JSON Tape\n";
+    run_test("SimdIndexMatchesScalar", test_simd_index_matches_scalar);
+    run_test("IndexSpansRuns", test_index_spans_runs);
+    run_test("TapeStructure", test_tape_structure);
+    run_test("DomFromTape", test_dom_from_tape);
+    run_test("ErrorOffsets", test_error_offsets);
+    return 0;
+}
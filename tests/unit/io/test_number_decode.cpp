@@ -0,0 +1,120 @@
+#include "io/number_decode.h"
+#include "io/csv_parser.h"
+#include "io/xml_parser.h"
+#include "io/yaml_parser.h"
+#include "core/state_manager.h"
+#include "../test_harness.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+bool throws_invalid(void (*fn)()) {
+    try {
+        fn();
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+std::string invalid_message(void (*fn)()) {
+    try {
+        fn();
+    } catch (const std::invalid_argument& e) {
+        return e.what();
+    }
+    return {};
+}
+
+}
+
+void test_whole_text() {
+    double d = 0.0;
+    ASSERT_TRUE(cerebra::decode_number(" \t-2.5e-1\r\n", d) == std::errc() && d == -0.25, "surrounding whitespace");
+    ASSERT_TRUE(cerebra::decode_number("+3", d) == std::errc() && d == 3.0, "leading plus");
+    ASSERT_TRUE(cerebra::decode_number("+-3", d) == std::errc::invalid_argument, "plus then minus");
+    ASSERT_TRUE(cerebra::decode_number("0.5x", d) == std::errc::invalid_argument, "trailing garbage");
+    ASSERT_TRUE(cerebra::decode_number("", d) == std::errc::invalid_argument, "empty");
+    ASSERT_TRUE(cerebra::decode_number("1e999", d) == std::errc::result_out_of_range, "double overflow");
+    ASSERT_EQ(d, 3.0, "failures leave the output alone");
+
+    std::int64_t ts = 0;
+    ASSERT_TRUE(cerebra::decode_number("9007199254740993", ts) == std::errc() && ts == 9007199254740993LL, "int64 exact");
+    ASSERT_TRUE(cerebra::decode_number("12.5", ts) == std::errc::invalid_argument, "fraction is not an integer");
+    int i = 7;
+    ASSERT_TRUE(cerebra::decode_number("3000000000", i) == std::errc::result_out_of_range && i == 7, "int overflow");
+}
+
+void test_prefix() {
+    double d = 0.0;
+    std::size_t used = 0;
+    ASSERT_TRUE(cerebra::decode_number_prefix("1.5e3*x", d, used) == std::errc() && d == 1500.0 && used == 5, "prefix");
+    ASSERT_TRUE(cerebra::decode_number_prefix(".25)", d, used) == std::errc() && d == 0.25 && used == 3, "leading dot");
+    ASSERT_TRUE(cerebra::decode_number_prefix(" 1", d, used) == std::errc::invalid_argument, "no whitespace skipped");
+    ASSERT_TRUE(cerebra::decode_number_prefix("-0.0,", d, used) == std::errc() && d == 0.0 && std::signbit(d) && used == 4,
+                "negative zero");
+    ASSERT_TRUE(cerebra::decode_number_prefix("7.]", d, used) == std::errc() && d == 7.0 && used == 2, "trailing point, as from_chars");
+}
+
+// Short decimals take a fast path; it must round exactly as from_chars does.
+void test_prefix_matches_from_chars() {
+    std::uint64_t state = 12345;
+    int mismatches = 0;
+    for (int k = 0; k < 20000; ++k) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        const std::uint64_t digits = (state >> 11) % 1000000000000000ULL;
+        const int point = static_cast<int>((state >> 3) % 16);
+        std::string text = std::to_string(digits);
+        if (point > 0) {
+            if (text.size() <= static_cast<std::size_t>(point)) text.insert(0, point + 1 - text.size(), '0');
+            text.insert(text.size() - point, ".");
+        }
+        if (state & 1) text.insert(0, "-");
+        double fast = 0.0;
+        double exact = 0.0;
+        std::size_t used = 0;
+        std::from_chars(text.data(), text.data() + text.size(), exact);
+        if (cerebra::decode_number_prefix(text, fast, used) != std::errc() || fast != exact || used != text.size()) {
+            ++mismatches;
+        }
+    }
+    ASSERT_EQ(mismatches, 0, "fast decimals match from_chars");
+}
+
+void test_text_formats() {
+    auto yaml = cerebra::parse_yaml_frames("- timestamp_ms: 100\n  brain_activity:\n    - region: amygdala\n      intensity: 0.75\n");
+    ASSERT_EQ(yaml.size(), 1u, "yaml frame");
+    ASSERT_EQ(yaml[0].timestamp_ms, 100, "yaml timestamp");
+    ASSERT_EQ(yaml[0].regions[0].intensity, 0.75, "yaml intensity");
+
+    auto xml = cerebra::parse_xml_frames(
+        "<frame><timestamp> 200 </timestamp><region><name>thalamus</name><intensity>0.5</intensity></region></frame>");
+    ASSERT_EQ(xml.size(), 1u, "xml frame");
+    ASSERT_EQ(xml[0].timestamp_ms, 200, "xml timestamp");
+    ASSERT_EQ(xml[0].regions[0].intensity, 0.5, "xml intensity");
+
+    auto csv = cerebra::parse_csv_frames("0, amygdala, 0.25\n0,thalamus,+0.5\r\n");
+    ASSERT_EQ(csv.size(), 1u, "csv frame");
+    ASSERT_EQ(csv[0].regions[1].intensity, 0.5, "csv intensity");
+
+    ASSERT_EQ(invalid_message([] { cerebra::parse_csv_frames("zero,amygdala,0.1\n"); }),
+              std::string("CSV: bad timestamp 'zero'"), "csv bad timestamp");
+    ASSERT_TRUE(throws_invalid([] { cerebra::parse_yaml_frames("timestamp_ms: soon\n"); }), "yaml bad timestamp");
+    ASSERT_TRUE(throws_invalid([] {
+        cerebra::parse_xml_frames("<frame><region><name>a</name><intensity>hot</intensity></region></frame>");
+    }), "xml bad intensity");
+}
+
+int main() {
+    std::cout << "Tests: Number Decode\n";
+    run_test("WholeText", test_whole_text);
+    run_test("Prefix", test_prefix);
+    run_test("PrefixMatchesFromChars", test_prefix_matches_from_chars);
+    run_test("TextFormats", test_text_formats);
+    return 0;
+}
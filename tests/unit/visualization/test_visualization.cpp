@@ -29,11 +29,7 @@ void test_sparkline_generation() {
     cerebra::RegionState r;
     r.region = "SparkRegion";
     r.intensity = 0.5; // Default intensity
-    r.intensity_history={0.1, 0.9};
-    r.subregions = std::vector<cerebra::RegionState>();
-    r.synaptic_buffer = std::vector<double>();
-    r.neurotransmitters = std::map<std::string, double>();
-    r.neurotransmitters = std::map<std::string, double>();
+    r.mutable_detail().intensity_history = {0.1, 0.9};
     std::ostringstream oss; AppConfig c;
     renderRegion(oss, r, 0, c);
     ASSERT_TRUE(oss.str().find("█") != std::string::npos, "Sparkline missing peak");